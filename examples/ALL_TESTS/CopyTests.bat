@@ -19,6 +19,8 @@ copy Test07A_Semaphores.cpp ..\Test07A_Semaphores
 
 copy Test07B_SemaphoresTimers.cpp ..\Test07B_SemaphoresTimers
 
+copy Test07C_Mutex.cpp ..\Test07C_Mutex
+
 copy Test08A_Events.cpp ..\Test08A_Events
 
 copy Test08B_EventsTimeout.cpp ..\Test08B_EventsTimeout
@@ -31,6 +33,26 @@ copy Test10_Timers2.cpp ..\Test10_Timers2
 
 copy Test11_StackUtilization.cpp ..\Test11_StackUtilization
 
+copy Test12_TicklessIdle.cpp ..\Test12_TicklessIdle
+
+copy Test13_MemoryPools.cpp ..\Test13_MemoryPools
+
+copy Test14_MessageQueues.cpp ..\Test14_MessageQueues
+
+copy Test15_RingBuffer.cpp ..\Test15_RingBuffer
+
+copy Test16_KernelTrace.cpp ..\Test16_KernelTrace
+
+copy Test17_EventGroups.cpp ..\Test17_EventGroups
+
+copy Test18_SemaphoreHandoff.cpp ..\Test18_SemaphoreHandoff
+
+copy Test19_RwLocks.cpp ..\Test19_RwLocks
+
+copy Test21_Profiler.cpp ..\Test21_Profiler
+copy Test22_IntOffProfiler.cpp ..\Test22_IntOffProfiler
+copy Test23_DeferredCalls.cpp ..\Test23_DeferredCalls
+
 copy Test20_Complex1.cpp ..\Test20_Complex1
 
 copy Test20_Complex1.cpp ..\Test20_Complex1huge\Test20_Complex1huge.cpp
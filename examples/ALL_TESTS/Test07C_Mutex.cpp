@@ -0,0 +1,214 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: Test07C_Mutex.cpp
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "Test_Config.h"
+
+
+#if TEST_MUTEX==1
+#define SETUP()	setup()
+#define LOOP()	loop()
+#else
+#define SETUP()	MUTEX_setup()
+#define LOOP()	MUTEX_loop()
+#endif
+
+#include <Arduino.h>
+
+#include <uMT.h>
+
+
+#if uMT_USE_MUTEX==1 && uMT_USE_EVENTS==1 && uMT_USE_TIMERS==1
+
+///////////////////////////////////////////////////////////////////////////////////
+//
+// Classic priority inversion:
+//	LOW locks the Mutex, HIGH waits for it while MEDIUM is hogging the CPU.
+//	With priority inheritance LOW runs at HIGH priority until Mx_Unlock(),
+//	so HIGH waits about LOW_HOLD_TIME and not MEDIUM_BUSY_TIME.
+//
+///////////////////////////////////////////////////////////////////////////////////
+
+#define MUTEX_ID			0
+
+#define LOW_HOLD_TIME		50			// ms
+#define MEDIUM_BUSY_TIME	500			// ms
+
+#define EV_LOCKED			0x0001
+#define EV_DONE				0x0002
+
+static TaskId_t	MainTid;
+static Timer_t	HighWait;
+
+
+static void CheckError(const __FlashStringHelper *Msg, Errno_t error, Errno_t expected = E_SUCCESS)
+{
+	if (error != expected)
+	{
+		Serial.print(F("FATAL ERROR: "));
+		Serial.print(Msg);
+		Serial.print(F(" - ERRNO = "));
+		Serial.println((unsigned)error);
+		Serial.flush();
+
+		Kernel.isr_Kn_FatalError();
+	}
+}
+
+
+static TaskId_t	StartTask(FuncAddress_t Task, TaskPrio_t Priority)
+{
+	TaskId_t	Tid;
+	TaskPrio_t	OldPrio;
+
+	CheckError(F("Tk_CreateTask"), Kernel.Tk_CreateTask(Task, Tid));
+	CheckError(F("Tk_SetPriority"), Kernel.Tk_SetPriority(Tid, Priority, OldPrio));
+	CheckError(F("Tk_StartTask"), Kernel.Tk_StartTask(Tid));
+
+	return(Tid);
+}
+
+
+static void LowTask()
+{
+	CheckError(F("Low: Mx_Lock"), Kernel.Mx_Lock(MUTEX_ID, uMT_WAIT));
+
+	Kernel.Ev_Send(MainTid, EV_LOCKED);
+
+	delay(LOW_HOLD_TIME);		// Busy, holding the Mutex
+
+	TaskPrio_t Prio;
+
+	Kernel.Tk_GetPriority(Prio);
+
+	Serial.print(F(" LowTask(): running at priority "));
+	Serial.println(Prio);
+	Serial.flush();
+
+	CheckError(F("Low: Mx_Unlock"), Kernel.Mx_Unlock(MUTEX_ID));
+
+	Kernel.Tk_GetPriority(Prio);
+
+	CheckError(F("Low: priority not restored"), (Prio == PRIO_LOW ? E_SUCCESS : E_INVALID_PRIORITY));
+
+	Kernel.Tk_DeleteTask();
+}
+
+
+static void MediumTask()
+{
+	Serial.println(F(" MediumTask(): hogging the CPU..."));
+	Serial.flush();
+
+	delay(MEDIUM_BUSY_TIME);
+
+	Kernel.Tk_DeleteTask();
+}
+
+
+static void HighTask()
+{
+	Timer_t Start = millis();
+
+	CheckError(F("High: Mx_Lock"), Kernel.Mx_Lock(MUTEX_ID, uMT_WAIT));
+
+	HighWait = millis() - Start;
+
+	// Recursion
+	CheckError(F("High: Mx_Lock(again)"), Kernel.Mx_Lock(MUTEX_ID, uMT_NOWAIT));
+	CheckError(F("High: Mx_Unlock"), Kernel.Mx_Unlock(MUTEX_ID));
+	CheckError(F("High: Mx_Unlock"), Kernel.Mx_Unlock(MUTEX_ID));
+	CheckError(F("High: Mx_Unlock(not owned)"), Kernel.Mx_Unlock(MUTEX_ID), E_NOT_OWNED_MUTEX);
+
+	Kernel.Ev_Send(MainTid, EV_DONE);
+
+	Kernel.Tk_DeleteTask();
+}
+
+
+void SETUP()
+{
+	// put your setup code here, to run once:
+
+	Serial.begin(57600);
+
+	Serial.println(F("MySetup(): Initialising..."));
+	delay(100); //Allow for serial print to complete.
+
+	Serial.println(F("================= MUTEX test ================="));
+	Serial.flush();
+
+	Serial.println(F("MySetup(): => Kernel.Kn_Start()"));
+	Serial.flush();
+
+	Kernel.Kn_Start(FALSE);		// NO timesharing
+}
+
+
+void LOOP()		// TASK TID=1
+{
+	Event_t		eventout;
+	TaskPrio_t	OldPrio;
+
+	Kernel.Tk_GetMyTid(MainTid);
+
+	// Orchestrate from the highest priority
+	Kernel.Tk_SetPriority(MainTid, PRIO_HIGHEST, OldPrio);
+
+	StartTask(LowTask, PRIO_LOW);
+
+	CheckError(F("Ev_Receive(EV_LOCKED)"), Kernel.Ev_Receive(EV_LOCKED, uMT_ANY, &eventout));
+
+	// Mutex busy: timeout and E_WOULD_BLOCK
+	CheckError(F("Mx_Lock(NOWAIT)"), Kernel.Mx_Lock(MUTEX_ID, uMT_NOWAIT), E_WOULD_BLOCK);
+	CheckError(F("Mx_Lock(timeout)"), Kernel.Mx_Lock(MUTEX_ID, uMT_WAIT, 5), E_TIMEOUT);
+
+	StartTask(MediumTask, PRIO_NORMAL);
+	StartTask(HighTask, PRIO_HIGH);
+
+	CheckError(F("Ev_Receive(EV_DONE)"), Kernel.Ev_Receive(EV_DONE, uMT_ANY, &eventout));
+
+	Serial.print(F(" Task1(): HighTask() waited for the Mutex (ms) => "));
+	Serial.println(HighWait);
+	Serial.flush();
+
+	if (HighWait >= MEDIUM_BUSY_TIME)
+	{
+		Serial.println(F(" Task1(): priority inheritance not working!"));
+		Serial.flush();
+
+		Kernel.isr_Kn_FatalError();
+	}
+
+	Serial.println(F("================= END ================="));
+	Serial.flush();
+
+	Kernel.isr_Kn_Reboot();
+}
+
+
+#endif
+
+
+////////////////////// EOF
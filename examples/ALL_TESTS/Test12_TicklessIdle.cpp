@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: Test12_TicklessIdle.cpp
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "Test_Config.h"
+
+
+#if TEST_TICKLESS_IDLE==1
+#define SETUP()	setup()
+#define LOOP()	loop()
+#else
+#define SETUP()	TICKLESS_IDLE_setup()
+#define LOOP()	TICKLESS_IDLE_loop()
+#endif
+
+#include <Arduino.h>
+
+#include <uMT.h>
+
+
+#if uMT_USE_TIMERS==1
+
+void SETUP() 
+{
+	// put your setup code here, to run once:
+
+	Serial.begin(57600);
+
+	Serial.println(F("MySetup(): Initialising..."));
+	delay(100); //Allow for serial print to complete.
+
+	Serial.println(F("================= TICKLESS IDLE test ================="));
+	Serial.flush();
+
+	Serial.println(F("MySetup(): => Kernel.Kn_Start()"));
+	Serial.flush();
+
+
+	Kernel.Kn_Start(FALSE);		// NO timesharing
+
+}
+
+#define TEST_TIMEOUT	5000		// 5 seconds
+#define LOOP_COUNT		3
+
+
+
+void LOOP()		// TASK TID=1
+{	
+	Errno_t error;
+
+	for (int counter = 0; counter < LOOP_COUNT; counter++)
+	{
+		Timer_t StartTick = Kernel.isr_Kn_GetKernelTick();
+		uint32_t StartInterrupts = Kernel.isr_Kn_GetTickInterrupts();
+
+		error = Kernel.Tm_WakeupAfter(TEST_TIMEOUT); 	// Only the IDLE task is ready
+
+		Timer_t Ticks = Kernel.isr_Kn_GetKernelTick() - StartTick;
+		uint32_t Interrupts = Kernel.isr_Kn_GetTickInterrupts() - StartInterrupts;
+
+		if (error != E_SUCCESS)
+		{
+			Serial.print(F(" Task1(): Tm_WakeupAfter() Failure! - returned "));
+			Serial.println((unsigned)error);
+			Serial.flush();
+		}
+
+		Serial.print(F(" Task1(): => "));
+		Serial.print(counter);
+		Serial.print(F("  Elapsed ticks => "));
+		Serial.print(Ticks);
+		Serial.print(F("  Tick interrupts => "));
+		Serial.println(Interrupts);
+		Serial.flush();
+
+#if uMT_USE_TICKLESS==1
+		if (Ticks < TEST_TIMEOUT || Interrupts * 10 > Ticks)
+		{
+			Serial.println(F(" Task1(): tickless IDLE not working!"));
+			Serial.flush();
+
+			Kernel.isr_Kn_FatalError();
+		}
+#endif
+	}
+
+	Serial.println(F("================= END ================="));
+	Serial.flush();
+
+	Kernel.isr_Kn_Reboot();
+}
+
+
+#endif
+
+
+////////////////////// EOF
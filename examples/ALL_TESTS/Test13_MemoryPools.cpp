@@ -0,0 +1,245 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: Test13_MemoryPools.cpp
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "Test_Config.h"
+
+
+#if TEST_POOLS==1
+#define SETUP()	setup()
+#define LOOP()	loop()
+#else
+#define SETUP()	POOLS_setup()
+#define LOOP()	POOLS_loop()
+#endif
+
+#include <Arduino.h>
+
+#include <uMT.h>
+
+
+#if uMT_USE_POOLS==1 && uMT_USE_EVENTS==1
+
+///////////////////////////////////////////////////////////////////////////////////
+//
+// A producer task sends messages to a consumer task: message buffers are taken
+// from a memory Pool and given back by the consumer (no malloc()).
+//
+///////////////////////////////////////////////////////////////////////////////////
+
+#define BLOCK_NUM			4
+#define MSG_NUM				1000
+
+#define EV_MSG				0x0001
+#define EV_DONE				0x0002
+
+struct Msg_t
+{
+	uint16_t	SeqNo;
+	uint8_t		Data[6];
+};
+
+static PoolId_t	MsgPool;
+static TaskId_t	MainTid;
+static TaskId_t	ConsumerTid;
+
+// Single producer / single consumer mailbox of message pointers
+static Msg_t * volatile	Mailbox[BLOCK_NUM];
+static volatile uint8_t	MbIn;
+static volatile uint8_t	MbOut;
+
+
+static void CheckError(const __FlashStringHelper *Msg, Errno_t error, Errno_t expected = E_SUCCESS)
+{
+	if (error != expected)
+	{
+		Serial.print(F("FATAL ERROR: "));
+		Serial.print(Msg);
+		Serial.print(F(" - ERRNO = "));
+		Serial.println((unsigned)error);
+		Serial.flush();
+
+		Kernel.isr_Kn_FatalError();
+	}
+}
+
+
+static TaskId_t	StartTask(FuncAddress_t Task)
+{
+	TaskId_t	Tid;
+
+	CheckError(F("Tk_CreateTask"), Kernel.Tk_CreateTask(Task, Tid));
+	CheckError(F("Tk_StartTask"), Kernel.Tk_StartTask(Tid));
+
+	return(Tid);
+}
+
+
+static void PrintPoolInfo()
+{
+	uMTpoolInfo Info;
+
+	CheckError(F("Pl_GetInfo"), Kernel.Pl_GetInfo(MsgPool, Info));
+
+	Serial.print(F(" Pool: BlockSize="));
+	Serial.print(Info.BlockSize);
+	Serial.print(F(" BlockNum="));
+	Serial.print(Info.BlockNum);
+	Serial.print(F(" FreeBlocks="));
+	Serial.print(Info.FreeBlocks);
+	Serial.print(F(" MaxUsedBlocks="));
+	Serial.println(Info.MaxUsedBlocks);
+	Serial.flush();
+}
+
+
+static void ConsumerTask()
+{
+	Event_t		eventout;
+	uint16_t	Expected = 0;
+
+	while (Expected < MSG_NUM)
+	{
+		CheckError(F("Consumer: Ev_Receive"), Kernel.Ev_Receive(EV_MSG, uMT_ANY, &eventout));
+
+		while (MbOut != MbIn)
+		{
+			Msg_t *pMsg = Mailbox[MbOut % BLOCK_NUM];
+
+			CheckError(F("Consumer: wrong sequence"), (pMsg->SeqNo == Expected ? E_SUCCESS : E_INVALID_OPTION));
+			Expected++;
+
+			CheckError(F("Consumer: Pl_Free"), Kernel.Pl_Free(MsgPool, pMsg));
+
+			MbOut++;
+		}
+	}
+
+	Kernel.Ev_Send(MainTid, EV_DONE);
+
+	Kernel.Tk_DeleteTask();
+}
+
+
+static void ProducerTask()
+{
+	for (uint16_t SeqNo = 0; SeqNo < MSG_NUM; )
+	{
+		void *pBlock;
+
+		if (Kernel.Pl_Alloc(MsgPool, pBlock) != E_SUCCESS)
+		{
+			// Pool empty: let the consumer run
+			Kernel.Tk_Yield();
+			continue;
+		}
+
+		Msg_t *pMsg = (Msg_t *)pBlock;
+
+		pMsg->SeqNo = SeqNo++;
+
+		Mailbox[MbIn % BLOCK_NUM] = pMsg;
+		MbIn++;
+
+		Kernel.Ev_Send(ConsumerTid, EV_MSG);
+	}
+
+	Kernel.Tk_DeleteTask();
+}
+
+
+void SETUP()
+{
+	// put your setup code here, to run once:
+
+	Serial.begin(57600);
+
+	Serial.println(F("MySetup(): Initialising..."));
+	delay(100); //Allow for serial print to complete.
+
+	Serial.println(F("================= POOLS test ================="));
+	Serial.flush();
+
+	Serial.println(F("MySetup(): => Kernel.Kn_Start()"));
+	Serial.flush();
+
+	Kernel.Kn_Start(FALSE);		// NO timesharing
+}
+
+
+void LOOP()		// TASK TID=1
+{
+	Event_t		eventout;
+	void		*Blocks[BLOCK_NUM];
+	void		*pBlock;
+	PoolId_t	Plid;
+
+	Kernel.Tk_GetMyTid(MainTid);
+
+	CheckError(F("Pl_Create(0 blocks)"), Kernel.Pl_Create(sizeof(Msg_t), 0, Plid), E_INVALID_POOL_SIZE);
+	CheckError(F("Pl_Create"), Kernel.Pl_Create(sizeof(Msg_t), BLOCK_NUM, MsgPool));
+	CheckError(F("Pl_Alloc(not created)"), Kernel.Pl_Alloc(MsgPool + 1, pBlock), E_INVALID_POOLID);
+
+	// Empty the Pool...
+	for (int idx = 0; idx < BLOCK_NUM; idx++)
+		CheckError(F("Pl_Alloc"), Kernel.Pl_Alloc(MsgPool, Blocks[idx]));
+
+	CheckError(F("Pl_Alloc(empty)"), Kernel.isr_Pl_Alloc(MsgPool, pBlock), E_POOL_EMPTY);
+	CheckError(F("Pl_Free(bad block)"), Kernel.Pl_Free(MsgPool, (uint8_t *)Blocks[0] + 1), E_INVALID_POOL_BLOCK);
+
+#if uMT_SAFERUN==1
+	CheckError(F("Pl_Free"), Kernel.Pl_Free(MsgPool, Blocks[1]));
+	CheckError(F("Pl_Free(twice, blocks in use)"), Kernel.Pl_Free(MsgPool, Blocks[1]), E_INVALID_POOL_BLOCK);
+	CheckError(F("Pl_Alloc"), Kernel.Pl_Alloc(MsgPool, Blocks[1]));
+#endif
+
+	// ... and fill it again
+	for (int idx = 0; idx < BLOCK_NUM; idx++)
+		CheckError(F("Pl_Free"), Kernel.isr_Pl_Free(MsgPool, Blocks[idx]));
+
+	CheckError(F("Pl_Free(twice)"), Kernel.Pl_Free(MsgPool, Blocks[0]), E_INVALID_POOL_BLOCK);
+
+	PrintPoolInfo();
+
+	ConsumerTid = StartTask(ConsumerTask);
+	StartTask(ProducerTask);
+
+	CheckError(F("Ev_Receive(EV_DONE)"), Kernel.Ev_Receive(EV_DONE, uMT_ANY, &eventout));
+
+	Serial.print(F(" Task1(): messages exchanged => "));
+	Serial.println(MSG_NUM);
+
+	PrintPoolInfo();
+
+	Serial.println(F("================= END ================="));
+	Serial.flush();
+
+	Kernel.isr_Kn_Reboot();
+}
+
+
+#endif
+
+
+////////////////////// EOF
@@ -0,0 +1,245 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: Test14_MessageQueues.cpp
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "Test_Config.h"
+
+
+#if TEST_MSGQUEUES==1
+#define SETUP()	setup()
+#define LOOP()	loop()
+#else
+#define SETUP()	MSGQUEUES_setup()
+#define LOOP()	MSGQUEUES_loop()
+#endif
+
+#include <Arduino.h>
+
+#include <uMT.h>
+
+
+#if uMT_USE_MSGQUEUES==1 && uMT_USE_POOLS==1 && uMT_USE_EVENTS==1 && uMT_USE_TIMERS==1
+
+///////////////////////////////////////////////////////////////////////////////////
+//
+// 1) Copy mode: the consumer has a higher priority, messages are handed off
+//    directly to the waiting consumer.
+// 2) Zero copy mode: buffers come from a memory Pool and only their pointers
+//    are queued. The consumer has a lower priority, so the queue gets FULL and
+//    the producer waits for a free slot.
+//
+///////////////////////////////////////////////////////////////////////////////////
+
+#define MSG_SLOTS			4
+#define BLOCK_NUM			(MSG_SLOTS + 4)
+#define MSG_NUM				1000
+
+#define EV_DONE				0x0001
+
+struct Msg_t
+{
+	uint16_t	SeqNo;
+	uint8_t		Data[10];
+};
+
+static MsgQueueId_t	CopyQueue;
+static MsgQueueId_t	PtrQueue;
+static PoolId_t		MsgPool;
+static TaskId_t		MainTid;
+
+
+static void CheckError(const __FlashStringHelper *Msg, Errno_t error, Errno_t expected = E_SUCCESS)
+{
+	if (error != expected)
+	{
+		Serial.print(F("FATAL ERROR: "));
+		Serial.print(Msg);
+		Serial.print(F(" - ERRNO = "));
+		Serial.println((unsigned)error);
+		Serial.flush();
+
+		Kernel.isr_Kn_FatalError();
+	}
+}
+
+
+static TaskId_t	StartTask(FuncAddress_t Task, TaskPrio_t Priority)
+{
+	TaskId_t	Tid;
+	TaskPrio_t	OldPrio;
+
+	CheckError(F("Tk_CreateTask"), Kernel.Tk_CreateTask(Task, Tid));
+	CheckError(F("Tk_SetPriority"), Kernel.Tk_SetPriority(Tid, Priority, OldPrio));
+	CheckError(F("Tk_StartTask"), Kernel.Tk_StartTask(Tid));
+
+	return(Tid);
+}
+
+
+static void CopyConsumerTask()
+{
+	Msg_t	Msg;
+
+	for (uint16_t Expected = 0; Expected < MSG_NUM; Expected++)
+	{
+		CheckError(F("Consumer: Mq_Receive"), Kernel.Mq_Receive(CopyQueue, &Msg, uMT_WAIT));
+		CheckError(F("Consumer: wrong sequence"), (Msg.SeqNo == Expected ? E_SUCCESS : E_INVALID_OPTION));
+	}
+
+	Kernel.Ev_Send(MainTid, EV_DONE);
+
+	Kernel.Tk_DeleteTask();
+}
+
+
+static void CopyProducerTask()
+{
+	Msg_t	Msg;
+
+	for (uint16_t SeqNo = 0; SeqNo < MSG_NUM; SeqNo++)
+	{
+		Msg.SeqNo = SeqNo;
+
+		CheckError(F("Producer: Mq_Send"), Kernel.Mq_Send(CopyQueue, &Msg, uMT_WAIT));
+	}
+
+	Kernel.Tk_DeleteTask();
+}
+
+
+static void PtrConsumerTask()
+{
+	void	*Ptr;
+
+	for (uint16_t Expected = 0; Expected < MSG_NUM; Expected++)
+	{
+		CheckError(F("Consumer: Mq_ReceivePtr"), Kernel.Mq_ReceivePtr(PtrQueue, Ptr, uMT_WAIT));
+		CheckError(F("Consumer: wrong sequence"), (((Msg_t *)Ptr)->SeqNo == Expected ? E_SUCCESS : E_INVALID_OPTION));
+		CheckError(F("Consumer: Pl_Free"), Kernel.Pl_Free(MsgPool, Ptr));
+	}
+
+	Kernel.Ev_Send(MainTid, EV_DONE);
+
+	Kernel.Tk_DeleteTask();
+}
+
+
+static void PtrProducerTask()
+{
+	void	*Ptr;
+
+	for (uint16_t SeqNo = 0; SeqNo < MSG_NUM; SeqNo++)
+	{
+		CheckError(F("Producer: Pl_Alloc"), Kernel.Pl_Alloc(MsgPool, Ptr));
+
+		((Msg_t *)Ptr)->SeqNo = SeqNo;
+
+		CheckError(F("Producer: Mq_SendPtr"), Kernel.Mq_SendPtr(PtrQueue, Ptr, uMT_WAIT));
+	}
+
+	Kernel.Tk_DeleteTask();
+}
+
+
+void SETUP()
+{
+	// put your setup code here, to run once:
+
+	Serial.begin(57600);
+
+	Serial.println(F("MySetup(): Initialising..."));
+	delay(100); //Allow for serial print to complete.
+
+	Serial.println(F("================= MESSAGE QUEUES test ================="));
+	Serial.flush();
+
+	Serial.println(F("MySetup(): => Kernel.Kn_Start()"));
+	Serial.flush();
+
+	Kernel.Kn_Start(FALSE);		// NO timesharing
+}
+
+
+void LOOP()		// TASK TID=1
+{
+	Event_t		eventout;
+	Msg_t		Msg;
+
+	Kernel.Tk_GetMyTid(MainTid);
+
+	CheckError(F("Mq_Create"), Kernel.Mq_Create(sizeof(Msg_t), MSG_SLOTS, CopyQueue));
+	CheckError(F("Mq_Create(ptr)"), Kernel.Mq_Create(sizeof(void *), MSG_SLOTS, PtrQueue));
+	CheckError(F("Pl_Create"), Kernel.Pl_Create(sizeof(Msg_t), BLOCK_NUM, MsgPool));
+
+	// Error cases
+	CheckError(F("Mq_Receive(NOWAIT)"), Kernel.Mq_Receive(CopyQueue, &Msg, uMT_NOWAIT), E_WOULD_BLOCK);
+	CheckError(F("Mq_Receive(timeout)"), Kernel.Mq_Receive(CopyQueue, &Msg, uMT_WAIT, 5), E_TIMEOUT);
+	CheckError(F("Mq_SendPtr(size)"), Kernel.Mq_SendPtr(CopyQueue, &Msg, uMT_NOWAIT), E_INVALID_MSG_SIZE);
+
+	for (int idx = 0; idx < MSG_SLOTS; idx++)
+		CheckError(F("Mq_Send"), Kernel.Mq_Send(CopyQueue, &Msg, uMT_NOWAIT));
+
+	CheckError(F("isr_Mq_Send(FULL)"), Kernel.isr_Mq_Send(CopyQueue, &Msg), E_WOULD_BLOCK);
+	CheckError(F("Mq_Send(timeout)"), Kernel.Mq_Send(CopyQueue, &Msg, uMT_WAIT, 5), E_TIMEOUT);
+
+	for (int idx = 0; idx < MSG_SLOTS; idx++)
+		CheckError(F("isr_Mq_Receive"), Kernel.isr_Mq_Receive(CopyQueue, &Msg));
+
+	// 1) Copy mode
+	StartTask(CopyConsumerTask, PRIO_HIGH);
+	StartTask(CopyProducerTask, PRIO_NORMAL);
+
+	CheckError(F("Ev_Receive(EV_DONE)"), Kernel.Ev_Receive(EV_DONE, uMT_ANY, &eventout));
+
+	Serial.print(F(" Task1(): messages copied => "));
+	Serial.println(MSG_NUM);
+	Serial.flush();
+
+	// 2) Zero copy mode
+	StartTask(PtrConsumerTask, PRIO_LOW);
+	StartTask(PtrProducerTask, PRIO_NORMAL);
+
+	CheckError(F("Ev_Receive(EV_DONE)"), Kernel.Ev_Receive(EV_DONE, uMT_ANY, &eventout));
+
+	uMTpoolInfo Info;
+
+	Kernel.Pl_GetInfo(MsgPool, Info);
+
+	Serial.print(F(" Task1(): pointers passed => "));
+	Serial.print(MSG_NUM);
+	Serial.print(F(" (max buffers in use = "));
+	Serial.print(Info.MaxUsedBlocks);
+	Serial.println(F(")"));
+
+	Serial.println(F("================= END ================="));
+	Serial.flush();
+
+	Kernel.isr_Kn_Reboot();
+}
+
+
+#endif
+
+
+////////////////////// EOF
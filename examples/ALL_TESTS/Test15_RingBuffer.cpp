@@ -0,0 +1,175 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: Test15_RingBuffer.cpp
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include "Test_Config.h"
+
+
+#if TEST_RINGS==1
+#define SETUP()	setup()
+#define LOOP()	loop()
+#else
+#define SETUP()	RINGS_setup()
+#define LOOP()	RINGS_loop()
+#endif
+
+#include <Arduino.h>
+
+#include <uMT.h>
+
+
+#if uMT_USE_RINGS==1 && uMT_USE_EVENTS==1 && uMT_USE_TIMERS==1
+
+///////////////////////////////////////////////////////////////////////////////////
+//
+// A higher priority producer writes bursts of items with isr_Put(), as an ISR
+// would, and then sleeps for one tick. The reader (Task1) sleeps in Read() and
+// checks that nothing is lost or reordered. At the end the ring is filled up
+// to check the overrun counter.
+//
+///////////////////////////////////////////////////////////////////////////////////
+
+#define RING_SIZE			16
+#define BURST				10
+#define ITEM_NUM			1000
+
+#define EV_RING				0x0001
+
+static uint16_t		RingBuffer[RING_SIZE];
+static uMTring		Ring;
+
+
+static void CheckError(const __FlashStringHelper *Msg, Errno_t error, Errno_t expected = E_SUCCESS)
+{
+	if (error != expected)
+	{
+		Serial.print(F("FATAL ERROR: "));
+		Serial.print(Msg);
+		Serial.print(F(" - ERRNO = "));
+		Serial.println((unsigned)error);
+		Serial.flush();
+
+		Kernel.isr_Kn_FatalError();
+	}
+}
+
+
+static void ProducerTask()
+{
+	uint16_t	SeqNo = 0;
+
+	while (SeqNo < ITEM_NUM)
+	{
+		for (int idx = 0; idx < BURST && SeqNo < ITEM_NUM; idx++, SeqNo++)
+		{
+			if (Ring.isr_Put(&SeqNo) == FALSE)
+				CheckError(F("Producer: isr_Put(FULL)"), E_INVALID_OPTION);
+		}
+
+		Kernel.Tm_WakeupAfter(1);
+	}
+
+	Kernel.Tk_DeleteTask();
+}
+
+
+void SETUP()
+{
+	// put your setup code here, to run once:
+
+	Serial.begin(57600);
+
+	Serial.println(F("MySetup(): Initialising..."));
+	delay(100); //Allow for serial print to complete.
+
+	Serial.println(F("================= RING BUFFER test ================="));
+	Serial.flush();
+
+	Serial.println(F("MySetup(): => Kernel.Kn_Start()"));
+	Serial.flush();
+
+	Kernel.Kn_Start(FALSE);		// NO timesharing
+}
+
+
+void LOOP()		// TASK TID=1
+{
+	TaskId_t	MainTid;
+	TaskId_t	Tid;
+	TaskPrio_t	OldPrio;
+	uint16_t	Item;
+
+	Kernel.Tk_GetMyTid(MainTid);
+
+	// Error cases
+	CheckError(F("Init(size)"), Ring.Init(RingBuffer, 1, sizeof(uint16_t), MainTid, EV_RING), E_INVALID_RING_SIZE);
+	CheckError(F("Init"), Ring.Init(RingBuffer, RING_SIZE, sizeof(uint16_t), MainTid, EV_RING));
+	CheckError(F("Read(timeout)"), Ring.Read(&Item, 5), E_TIMEOUT);
+
+	CheckError(F("Tk_CreateTask"), Kernel.Tk_CreateTask(ProducerTask, Tid));
+	CheckError(F("Tk_SetPriority"), Kernel.Tk_SetPriority(Tid, PRIO_HIGH, OldPrio));
+	CheckError(F("Tk_StartTask"), Kernel.Tk_StartTask(Tid));
+
+	for (uint16_t Expected = 0; Expected < ITEM_NUM; Expected++)
+	{
+		CheckError(F("Read"), Ring.Read(&Item, 100));
+		CheckError(F("Read: wrong sequence"), (Item == Expected ? E_SUCCESS : E_INVALID_OPTION));
+	}
+
+	CheckError(F("GetOverruns"), (Ring.GetOverruns() == 0 ? E_SUCCESS : E_INVALID_OPTION));
+
+	Serial.print(F(" Task1(): items streamed => "));
+	Serial.println(ITEM_NUM);
+
+	// Fill up the ring: one slot is always left free
+	for (Item = 0; Item < RING_SIZE - 1; Item++)
+	{
+		if (Ring.Put(&Item) == FALSE)
+			CheckError(F("Put"), E_INVALID_OPTION);
+	}
+
+	CheckError(F("Put(FULL)"), (Ring.Put(&Item) == FALSE ? E_SUCCESS : E_INVALID_OPTION));
+	CheckError(F("Count"), (Ring.Count() == RING_SIZE - 1 ? E_SUCCESS : E_INVALID_OPTION));
+	CheckError(F("GetOverruns"), (Ring.GetOverruns() == 1 ? E_SUCCESS : E_INVALID_OPTION));
+
+	while (Ring.Get(&Item))
+		;
+
+	CheckError(F("Count(EMPTY)"), (Ring.Count() == 0 ? E_SUCCESS : E_INVALID_OPTION));
+
+	Serial.print(F(" Task1(): overruns => "));
+	Serial.println((unsigned)Ring.GetOverruns());
+
+	Serial.println(F("================= END ================="));
+	Serial.flush();
+
+	Kernel.isr_Kn_Reboot();
+}
+
+
+#endif
+
+
+////////////////////// EOF
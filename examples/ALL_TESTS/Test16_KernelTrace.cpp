@@ -0,0 +1,166 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: Test16_KernelTrace.cpp
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include "Test_Config.h"
+
+
+#if TEST_TRACE==1
+#define SETUP()	setup()
+#define LOOP()	loop()
+#else
+#define SETUP()	TRACE_setup()
+#define LOOP()	TRACE_loop()
+#endif
+
+#include <Arduino.h>
+
+#include <uMT.h>
+
+
+#if uMT_USE_TRACE==1 && uMT_USE_SEMAPHORES==1 && uMT_USE_EVENTS==1 && uMT_USE_TIMERS==1
+
+///////////////////////////////////////////////////////////////////////////////////
+//
+// Two tasks ping-pong through a semaphore and an event while the kernel trace is
+// recording, then the trace is dumped to Serial. Save the output and convert it:
+//
+//	extras/trace/uMTtrace2json.py serial.log trace.json
+//
+///////////////////////////////////////////////////////////////////////////////////
+
+#define LOOPS				5
+
+#define EV_PONG				0x0001
+#define PING_SEM			1		// Semaphores are created LOCKED
+
+static TaskId_t		MainTid;
+
+
+static void CheckError(const __FlashStringHelper *Msg, Errno_t error, Errno_t expected = E_SUCCESS)
+{
+	if (error != expected)
+	{
+		Serial.print(F("FATAL ERROR: "));
+		Serial.print(Msg);
+		Serial.print(F(" - ERRNO = "));
+		Serial.println((unsigned)error);
+		Serial.flush();
+
+		Kernel.isr_Kn_FatalError();
+	}
+}
+
+
+static void PongTask()
+{
+	for (int idx = 0; idx < LOOPS; idx++)
+	{
+		CheckError(F("Pong: Sm_Claim"), Kernel.Sm_Claim(PING_SEM, uMT_WAIT));
+
+		Kernel.isr_Kn_TraceUser(1, idx);	// Mark the work done
+
+		CheckError(F("Pong: Ev_Send"), Kernel.Ev_Send(MainTid, EV_PONG));
+	}
+
+	Kernel.Tk_DeleteTask();
+}
+
+
+void SETUP()
+{
+	// put your setup code here, to run once:
+
+	Serial.begin(57600);
+
+	Serial.println(F("MySetup(): Initialising..."));
+	delay(100); //Allow for serial print to complete.
+
+	Serial.println(F("================= KERNEL TRACE test ================="));
+	Serial.flush();
+
+	Serial.println(F("MySetup(): => Kernel.Kn_Start()"));
+	Serial.flush();
+
+	Kernel.Kn_Start(FALSE);		// NO timesharing
+}
+
+
+void LOOP()		// TASK TID=1
+{
+	TaskId_t	Tid;
+	TaskPrio_t	OldPrio;
+	Event_t		eventout;
+
+	Kernel.Tk_GetMyTid(MainTid);
+
+	CheckError(F("Tk_CreateTask"), Kernel.Tk_CreateTask(PongTask, Tid));
+	CheckError(F("Tk_SetPriority"), Kernel.Tk_SetPriority(Tid, PRIO_HIGH, OldPrio));
+
+	CheckError(F("Kn_TraceStart"), Kernel.Kn_TraceStart());
+
+	CheckError(F("Tk_StartTask"), Kernel.Tk_StartTask(Tid));
+
+	for (int idx = 0; idx < LOOPS; idx++)
+	{
+		CheckError(F("Sm_Release"), Kernel.Sm_Release(PING_SEM));
+		CheckError(F("Ev_Receive"), Kernel.Ev_Receive(EV_PONG, uMT_ANY, &eventout));
+
+		CheckError(F("Tm_WakeupAfter"), Kernel.Tm_WakeupAfter(2));
+	}
+
+	// What an ISR handler would do
+	Kernel.isr_Kn_TraceIsrEnter(3);
+	Kernel.isr_Kn_TraceIsrExit(3);
+
+	CheckError(F("Kn_TraceDump"), Kernel.Kn_TraceDump());
+
+	Serial.println(F("================= END ================="));
+	Serial.flush();
+
+	Kernel.isr_Kn_Reboot();
+}
+
+
+#else
+
+void SETUP()
+{
+	Serial.begin(57600);
+
+	Serial.println(F("Test16_KernelTrace: set uMT_USE_TRACE to 1 in uMTconfiguration.h"));
+	Serial.flush();
+
+	Kernel.isr_Kn_Reboot();
+}
+
+void LOOP()
+{
+}
+
+#endif
+
+
+////////////////////// EOF
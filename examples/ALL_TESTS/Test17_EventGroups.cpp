@@ -0,0 +1,201 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: Test17_EventGroups.cpp
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "Test_Config.h"
+
+
+#if TEST_EVENTGROUPS==1
+#define SETUP()	setup()
+#define LOOP()	loop()
+#else
+#define SETUP()	EVENTGROUPS_setup()
+#define LOOP()	EVENTGROUPS_loop()
+#endif
+
+#include <Arduino.h>
+
+#include <uMT.h>
+
+
+#if uMT_USE_EVENTGROUPS==1 && uMT_USE_TIMERS==1
+
+///////////////////////////////////////////////////////////////////////////////////
+//
+// 1) Broadcast: WAITERS higher priority tasks wait for EG_GO with uMT_CLEAR.
+//    Every Eg_Set() makes all of them READY at once, then the flag is cleared.
+// 2) ALL logic: a task waits for EG_A and EG_B, only the second Eg_Set() wakes it.
+//
+///////////////////////////////////////////////////////////////////////////////////
+
+#define WAITERS				4
+#define ROUNDS				1000
+
+#define EG_GO				0x0001
+#define EG_A				0x0002
+#define EG_B				0x0004
+
+static EventGroupId_t	Group;
+static volatile uint32_t	Wakeups;
+static volatile Bool_t	AllDone;
+
+
+static void CheckError(const __FlashStringHelper *Msg, Errno_t error, Errno_t expected = E_SUCCESS)
+{
+	if (error != expected)
+	{
+		Serial.print(F("FATAL ERROR: "));
+		Serial.print(Msg);
+		Serial.print(F(" - ERRNO = "));
+		Serial.println((unsigned)error);
+		Serial.flush();
+
+		Kernel.isr_Kn_FatalError();
+	}
+}
+
+
+static void StartTask(FuncAddress_t Task, TaskPrio_t Priority)
+{
+	TaskId_t	Tid;
+	TaskPrio_t	OldPrio;
+
+	CheckError(F("Tk_CreateTask"), Kernel.Tk_CreateTask(Task, Tid));
+	CheckError(F("Tk_SetPriority"), Kernel.Tk_SetPriority(Tid, Priority, OldPrio));
+	CheckError(F("Tk_StartTask"), Kernel.Tk_StartTask(Tid));
+}
+
+
+static void WaiterTask()
+{
+	Event_t	Flags;
+
+	for (uint16_t Round = 0; Round < ROUNDS; Round++)
+	{
+		CheckError(F("Waiter: Eg_Wait"), Kernel.Eg_Wait(Group, EG_GO, uMT_ANY | uMT_CLEAR, &Flags));
+		CheckError(F("Waiter: wrong flags"), ((Flags & EG_GO) ? E_SUCCESS : E_INVALID_OPTION));
+
+		Wakeups++;
+	}
+
+	Kernel.Tk_DeleteTask();
+}
+
+
+static void AllTask()
+{
+	Event_t	Flags;
+
+	CheckError(F("AllTask: Eg_Wait"), Kernel.Eg_Wait(Group, EG_A | EG_B, uMT_ALL | uMT_CLEAR, &Flags));
+	CheckError(F("AllTask: wrong flags"), ((Flags & (EG_A | EG_B)) == (EG_A | EG_B) ? E_SUCCESS : E_INVALID_OPTION));
+
+	AllDone = TRUE;
+
+	Kernel.Tk_DeleteTask();
+}
+
+
+void SETUP()
+{
+	// put your setup code here, to run once:
+
+	Serial.begin(57600);
+
+	Serial.println(F("MySetup(): Initialising..."));
+	delay(100); //Allow for serial print to complete.
+
+	Serial.println(F("================= EVENT GROUPS test ================="));
+	Serial.flush();
+
+	Serial.println(F("MySetup(): => Kernel.Kn_Start()"));
+	Serial.flush();
+
+	Kernel.Kn_Start(FALSE);		// NO timesharing
+}
+
+
+void LOOP()		// TASK TID=1
+{
+	Event_t		Flags;
+
+	CheckError(F("Eg_Create"), Kernel.Eg_Create(Group));
+
+	// Error cases
+	CheckError(F("Eg_Wait(NOWAIT)"), Kernel.Eg_Wait(Group, EG_GO, uMT_ANY | uMT_NOWAIT, &Flags), E_WOULD_BLOCK);
+	CheckError(F("Eg_Wait(timeout)"), Kernel.Eg_Wait(Group, EG_GO, uMT_ANY, &Flags, 5), E_TIMEOUT);
+	CheckError(F("Eg_Set(invalid)"), Kernel.Eg_Set((EventGroupId_t)(Group + 1), EG_GO), E_INVALID_EVGRPID);
+
+	// 1) Broadcast
+	for (int idx = 0; idx < WAITERS; idx++)
+		StartTask(WaiterTask, PRIO_HIGH);
+
+	Kernel.Tk_Yield();		// Let them wait
+
+	Timer_t Elapsed = millis();
+
+	for (uint16_t Round = 0; Round < ROUNDS; Round++)
+	{
+		// All the waiters run (higher priority) before Eg_Set() returns
+		CheckError(F("Eg_Set(EG_GO)"), Kernel.Eg_Set(Group, EG_GO));
+		CheckError(F("Wakeups"), (Wakeups == (uint32_t)(Round + 1) * WAITERS ? E_SUCCESS : E_INVALID_OPTION));
+	}
+
+	Elapsed = millis() - Elapsed;
+
+	CheckError(F("Eg_Wait(0)"), Kernel.Eg_Wait(Group, 0, uMT_ANY, &Flags));
+	CheckError(F("EG_GO not cleared"), ((Flags & EG_GO) == 0 ? E_SUCCESS : E_INVALID_OPTION));
+
+	Serial.print(F(" Task1(): broadcasts => "));
+	Serial.print(ROUNDS);
+	Serial.print(F(" wakeups => "));
+	Serial.print(Wakeups);
+	Serial.print(F(" Elapsed = "));
+	Serial.println(Elapsed);
+	Serial.flush();
+
+	// 2) ALL logic
+	StartTask(AllTask, PRIO_HIGH);
+
+	CheckError(F("Eg_Set(EG_A)"), Kernel.Eg_Set(Group, EG_A));
+	CheckError(F("AllTask woken by EG_A"), (AllDone == FALSE ? E_SUCCESS : E_INVALID_OPTION));
+
+	CheckError(F("Eg_Set(EG_B)"), Kernel.Eg_Set(Group, EG_B));
+	CheckError(F("AllTask not woken"), (AllDone == TRUE ? E_SUCCESS : E_INVALID_OPTION));
+
+	CheckError(F("Eg_Wait(0)"), Kernel.Eg_Wait(Group, 0, uMT_ANY, &Flags));
+	CheckError(F("EG_A|EG_B not cleared"), ((Flags & (EG_A | EG_B)) == 0 ? E_SUCCESS : E_INVALID_OPTION));
+
+	Serial.println(F(" Task1(): ALL + CLEAR => OK"));
+
+	Serial.println(F("================= END ================="));
+	Serial.flush();
+
+	Kernel.isr_Kn_Reboot();
+}
+
+
+#endif
+
+
+////////////////////// EOF
@@ -0,0 +1,189 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: Test18_SemaphoreHandoff.cpp
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "Test_Config.h"
+
+
+#if TEST_SEM_HANDOFF==1
+#define SETUP()	setup()
+#define LOOP()	loop()
+#else
+#define SETUP()	SEM_HANDOFF_setup()
+#define LOOP()	SEM_HANDOFF_loop()
+#endif
+
+#include <Arduino.h>
+
+#include <uMT.h>
+
+
+#if uMT_USE_SEMAPHORES==1 && uMT_USE_SEM_STATISTICS==1 && uMT_USE_EVENTS==1
+
+///////////////////////////////////////////////////////////////////////////////////
+//
+// Two tasks of the same priority share a lock and yield while holding it.
+//
+// 1) Handoff (default): every Sm_Release() gives the lock to the other task, so
+//    each claim has to wait: a lock convoy, one task switch per claim.
+// 2) No handoff: the releasing task takes the lock again at once, the other one
+//    only gets it when the first task has done.
+//
+// Sm_GetInfo() statistics show the difference.
+//
+///////////////////////////////////////////////////////////////////////////////////
+
+#define	LOCK_SEM			1		// Semaphore id
+#define ROUNDS				1000
+
+#define EV_WORKER1			0x0001
+#define EV_WORKER2			0x0002
+
+static TaskId_t			MainTid;
+static volatile uint32_t	Counter;
+
+
+static void CheckError(const __FlashStringHelper *Msg, Errno_t error, Errno_t expected = E_SUCCESS)
+{
+	if (error != expected)
+	{
+		Serial.print(F("FATAL ERROR: "));
+		Serial.print(Msg);
+		Serial.print(F(" - ERRNO = "));
+		Serial.println((unsigned)error);
+		Serial.flush();
+
+		Kernel.isr_Kn_FatalError();
+	}
+}
+
+
+static void Worker(Event_t Done)
+{
+	for (uint16_t Round = 0; Round < ROUNDS; Round++)
+	{
+		CheckError(F("Worker: Sm_Claim"), Kernel.Sm_Claim(LOCK_SEM, uMT_WAIT));
+
+		Counter++;
+
+		Kernel.Tk_Yield();		// Still holding the lock
+
+		CheckError(F("Worker: Sm_Release"), Kernel.Sm_Release(LOCK_SEM));
+	}
+
+	Kernel.Ev_Send(MainTid, Done);
+
+	Kernel.Tk_DeleteTask();
+}
+
+static void Worker1() { Worker(EV_WORKER1); }
+static void Worker2() { Worker(EV_WORKER2); }
+
+
+static uMTsemInfo RunTest(Bool_t Handoff)
+{
+	TaskId_t	Tid;
+	Event_t		eventout;
+	uMTsemInfo	Info;
+
+	CheckError(F("Sm_SetHandoff"), Kernel.Sm_SetHandoff(LOCK_SEM, Handoff));
+	CheckError(F("Sm_GetInfo(Reset)"), Kernel.Sm_GetInfo(LOCK_SEM, Info, TRUE));
+
+	Counter = 0;
+
+	Timer_t Elapsed = millis();
+
+	CheckError(F("Tk_CreateTask"), Kernel.Tk_CreateTask(Worker1, Tid));
+	CheckError(F("Tk_StartTask"), Kernel.Tk_StartTask(Tid));
+	CheckError(F("Tk_CreateTask"), Kernel.Tk_CreateTask(Worker2, Tid));
+	CheckError(F("Tk_StartTask"), Kernel.Tk_StartTask(Tid));
+
+	CheckError(F("Ev_Receive"), Kernel.Ev_Receive(EV_WORKER1 | EV_WORKER2, uMT_ALL, &eventout));
+
+	Elapsed = millis() - Elapsed;
+
+	CheckError(F("Sm_GetInfo"), Kernel.Sm_GetInfo(LOCK_SEM, Info));
+	CheckError(F("Counter"), (Counter == 2 * ROUNDS ? E_SUCCESS : E_INVALID_OPTION));
+	CheckError(F("Claims"), (Info.Stats.Claims == 2 * ROUNDS ? E_SUCCESS : E_INVALID_OPTION));
+	CheckError(F("Lock not free"), (Info.Value == 1 && Info.Waiting == 0 ? E_SUCCESS : E_INVALID_OPTION));
+
+	Serial.print((Handoff ? F(" Handoff:    ") : F(" No handoff: ")));
+	Serial.print(F("Claims="));
+	Serial.print(Info.Stats.Claims);
+	Serial.print(F(" Contentions="));
+	Serial.print(Info.Stats.Contentions);
+	Serial.print(F(" WaitMax="));
+	Serial.print(Info.Stats.usWaitMax);
+	Serial.print(F("us WaitAvg="));
+	Serial.print(Info.Stats.Contentions ? Info.Stats.usWaitTotal / Info.Stats.Contentions : 0);
+	Serial.print(F("us Elapsed="));
+	Serial.print(Elapsed);
+	Serial.println(F("ms"));
+	Serial.flush();
+
+	return(Info);
+}
+
+
+void SETUP()
+{
+	// put your setup code here, to run once:
+
+	Serial.begin(57600);
+
+	Serial.println(F("MySetup(): Initialising..."));
+	delay(100); //Allow for serial print to complete.
+
+	Serial.println(F("================= SEMAPHORE HANDOFF test ================="));
+	Serial.flush();
+
+	Serial.println(F("MySetup(): => Kernel.Kn_Start()"));
+	Serial.flush();
+
+	Kernel.Kn_Start(FALSE);		// NO timesharing
+}
+
+
+void LOOP()		// TASK TID=1
+{
+	Kernel.Tk_GetMyTid(MainTid);
+
+	CheckError(F("Sm_Release"), Kernel.Sm_Release(LOCK_SEM));		// Initially FREE
+
+	uMTsemInfo Handoff = RunTest(TRUE);
+	uMTsemInfo NoHandoff = RunTest(FALSE);
+
+	CheckError(F("No convoy"), (NoHandoff.Stats.Contentions < Handoff.Stats.Contentions ? E_SUCCESS : E_INVALID_OPTION));
+
+	Serial.println(F("================= END ================="));
+	Serial.flush();
+
+	Kernel.isr_Kn_Reboot();
+}
+
+
+#endif
+
+
+////////////////////// EOF
@@ -0,0 +1,208 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: Test22_IntOffProfiler.cpp
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "Test_Config.h"
+
+
+#if TEST_INTOFF==1
+#define SETUP()	setup()
+#define LOOP()	loop()
+#else
+#define SETUP()	INTOFF_setup()
+#define LOOP()	INTOFF_loop()
+#endif
+
+#include <Arduino.h>
+
+#include <uMT.h>
+
+
+#if uMT_USE_INTOFF_PROFILER==1 && uMT_USE_EVENTS==1 && uMT_USE_TIMERS==1
+
+///////////////////////////////////////////////////////////////////////////////////
+//
+// Set uMT_USE_INTOFF_PROFILER to 1 in uMTconfiguration.h.
+//
+// Two time sharing tasks run for RUN_MS: one keeps INTS disabled for a long
+// time in LongRegion(), the other only for a short time in ShortRegion(). The
+// longest windows are then dumped to Serial. Save the output and map the call
+// sites to functions:
+//
+//	extras/profile/uMTintoff.py firmware.elf serial.log
+//
+///////////////////////////////////////////////////////////////////////////////////
+
+#define RUN_MS				2000
+
+#define EV_DONE				0x0001
+
+static TaskId_t		MainTid;
+static uint8_t		RunningTasks;
+static volatile uint32_t	Counter;
+
+
+static void CheckError(const __FlashStringHelper *Msg, Errno_t error, Errno_t expected = E_SUCCESS)
+{
+	if (error != expected)
+	{
+		Serial.print(F("FATAL ERROR: "));
+		Serial.print(Msg);
+		Serial.print(F(" - ERRNO = "));
+		Serial.println((unsigned)error);
+		Serial.flush();
+
+		Kernel.isr_Kn_FatalError();
+	}
+}
+
+
+static void __attribute__((noinline)) LongRegion()
+{
+	CpuStatusReg_t	CpuFlags = Kernel.isr_Kn_IntLock();
+
+	for (int idx = 0; idx < 2000; idx++)
+		Counter++;
+
+	Kernel.isr_Kn_IntUnlock(CpuFlags);
+}
+
+
+static void __attribute__((noinline)) ShortRegion()
+{
+	CpuStatusReg_t	CpuFlags = Kernel.isr_Kn_IntLock();
+
+	Counter++;
+
+	Kernel.isr_Kn_IntUnlock(CpuFlags);
+}
+
+
+static void Done()
+{
+	CpuStatusReg_t	CpuFlags = Kernel.isr_Kn_IntLock();
+
+	Bool_t Last = (--RunningTasks == 0);
+
+	Kernel.isr_Kn_IntUnlock(CpuFlags);
+
+	if (Last)
+		Kernel.Ev_Send(MainTid, EV_DONE);
+
+	Kernel.Tk_DeleteTask();
+}
+
+
+static void LongTask()
+{
+	uint32_t Start = millis();
+
+	while (millis() - Start < RUN_MS)
+	{
+		LongRegion();
+		Kernel.Tm_WakeupAfter(1);
+	}
+
+	Done();
+}
+
+
+static void ShortTask()
+{
+	uint32_t Start = millis();
+
+	while (millis() - Start < RUN_MS)
+		ShortRegion();
+
+	Done();
+}
+
+
+void SETUP()
+{
+	// put your setup code here, to run once:
+
+	Serial.begin(57600);
+
+	Serial.println(F("MySetup(): Initialising..."));
+	delay(100); //Allow for serial print to complete.
+
+	Serial.println(F("================= INTS OFF PROFILER test ================="));
+	Serial.flush();
+
+	Serial.println(F("MySetup(): => Kernel.Kn_Start()"));
+	Serial.flush();
+
+	Kernel.Kn_Start(TRUE);		// Timesharing
+}
+
+
+void LOOP()		// TASK TID=1
+{
+	TaskId_t	Tid;
+	Event_t		eventout;
+
+	Kernel.Tk_GetMyTid(MainTid);
+
+	RunningTasks = 2;
+
+	CheckError(F("Kn_IntOffStart"), Kernel.Kn_IntOffStart());
+
+	CheckError(F("Tk_CreateTask"), Kernel.Tk_CreateTask(LongTask, Tid));
+	CheckError(F("Tk_StartTask"), Kernel.Tk_StartTask(Tid));
+
+	CheckError(F("Tk_CreateTask"), Kernel.Tk_CreateTask(ShortTask, Tid));
+	CheckError(F("Tk_StartTask"), Kernel.Tk_StartTask(Tid));
+
+	CheckError(F("Ev_Receive"), Kernel.Ev_Receive(EV_DONE, uMT_ANY, &eventout));
+
+	CheckError(F("Kn_IntOffDump"), Kernel.Kn_IntOffDump());
+
+	Serial.println(F("================= END ================="));
+	Serial.flush();
+
+	Kernel.isr_Kn_Reboot();
+}
+
+
+#else
+
+void SETUP()
+{
+	Serial.begin(57600);
+
+	Serial.println(F("Test22_IntOffProfiler: set uMT_USE_INTOFF_PROFILER to 1 in uMTconfiguration.h"));
+	Serial.flush();
+
+	Kernel.isr_Kn_Reboot();
+}
+
+void LOOP()
+{
+}
+
+#endif
+
+
+////////////////////// EOF
@@ -13,12 +13,24 @@
 #define	TEST_YIELD_SPEED			0
 #define TEST_SEMAPHORES				0
 #define TEST_SEMAPHORES_TIMERS		0
+#define TEST_MUTEX					0
 #define TEST_EVENTS					0
 #define TEST_EVENTS_TIMEOUT			0
 #define TEST_EVENTS_TIMERS			0
 #define TEST_TIMERS1				0
 #define TEST_TIMERS2				0
 #define TEST_STACK_UTILIZATION		0
+#define TEST_TICKLESS_IDLE			0
+#define TEST_POOLS					0
+#define TEST_MSGQUEUES				0
+#define TEST_RINGS					0
+#define TEST_TRACE					0
+#define TEST_EVENTGROUPS			0
+#define TEST_SEM_HANDOFF			0
+#define TEST_RWLOCKS				0
+#define TEST_PROFILER				0
+#define TEST_INTOFF					0
+#define TEST_DPC					0
 
 #define TEST_COMPLEX_1				1
 #define TEST_COMPLEX_1HUGE			0
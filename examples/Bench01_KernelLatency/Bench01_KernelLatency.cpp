@@ -0,0 +1,461 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: Bench01_KernelLatency.cpp
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////
+//
+// Kernel latency benchmarks. One CSV line per benchmark (see BenchTime.h):
+//
+//	yield			Tk_Yield() to the first instruction of the other task
+//	sem_handoff		Sm_Release() to the higher priority task blocked in Sm_Claim()
+//	sem_uncontended	Sm_Claim() + Sm_Release(), semaphore free
+//	ev_wakeup		Ev_Send() to the higher priority task blocked in Ev_Receive()
+//	tm_insert		Tm_EvAfter() with other timers queued
+//	tm_cancel		Tm_Cancel() with other timers queued
+//	tm_wakeup		Tm_WakeupAfter(1), elapsed micros
+//	isr_entry		software triggered interrupt to its handler
+//	isr_to_task		isr_p_Ev_Send() in the handler to the woken up task
+//	isr_defer_to_task	isr_Ev_Send() in the handler to the woken up task (uMT_USE_ISR_PREEMPTION)
+//
+// The interrupt is triggered by the benchmark itself, no external hardware:
+//	AVR:	pin 2 (INT0) as OUTPUT, toggled by the task
+//	SAM:	TC8 interrupt (unused by uMT) pended in the NVIC
+//	LINUX:	SIGUSR1 raised by the task (uMT_POSIX_TICK_SIGNAL blocked in the handler)
+//
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+
+#include <uMT.h>
+
+#include "BenchTime.h"
+
+
+#if uMT_USE_SEMAPHORES==1 && uMT_USE_EVENTS==1 && uMT_USE_TIMERS==1
+
+#define BENCH_SEM_HANDOFF	1
+#define BENCH_SEM_FREE		2
+
+#define BENCH_EVENT			0x0001
+
+#define BENCH_BG_TIMERS		3			// Timers queued while measuring Tm_EvAfter()/Tm_Cancel()
+
+static const Timer_t BgTimeout[BENCH_BG_TIMERS] = {100, 5000, 100000};
+
+
+static BenchSet				SetA;
+static BenchSet				SetB;
+
+static volatile BenchTime_t	Stamp;
+static volatile BenchTime_t	IsrStamp;
+static TaskId_t				PeerTid;
+static volatile Bool_t		IsrPreempt;
+
+
+static void CheckError(const __FlashStringHelper *Msg, Errno_t error)
+{
+	if (error != E_SUCCESS)
+	{
+		Serial.print(F("FATAL ERROR: "));
+		Serial.print(Msg);
+		Serial.print(F(" - ERRNO = "));
+		Serial.println((unsigned)error);
+		Serial.flush();
+
+		Kernel.isr_Kn_FatalError();
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	Software triggered interrupt
+//
+////////////////////////////////////////////////////////////////////////////////////
+static void BenchIsr()
+{
+	IsrStamp = BENCH_NOW();
+
+	SetA.Add((BenchTime_t)(IsrStamp - Stamp));
+
+	if (IsrPreempt)
+		Kernel.isr_p_Ev_Send(PeerTid, BENCH_EVENT);	// Switch inside the handler
+	else
+		Kernel.isr_Ev_Send(PeerTid, BENCH_EVENT);	// Switch on return from interrupt
+}
+
+#if defined(ARDUINO_ARCH_AVR)
+
+#define BENCH_IRQ_PIN	2
+
+static void IsrSetup()
+{
+	pinMode(BENCH_IRQ_PIN, OUTPUT);
+	digitalWrite(BENCH_IRQ_PIN, LOW);
+
+	attachInterrupt(digitalPinToInterrupt(BENCH_IRQ_PIN), BenchIsr, CHANGE);
+}
+
+static void IsrTrigger()
+{
+	static uint8_t	Level = LOW;
+
+	Level = (Level == LOW ? HIGH : LOW);
+
+	Stamp = BENCH_NOW();
+
+	digitalWrite(BENCH_IRQ_PIN, Level);
+}
+
+#elif defined(ARDUINO_ARCH_SAM)
+
+void TC8_Handler()
+{
+	BenchIsr();
+}
+
+static void IsrSetup()
+{
+	NVIC_ClearPendingIRQ(TC8_IRQn);
+	NVIC_EnableIRQ(TC8_IRQn);
+}
+
+static void IsrTrigger()
+{
+	Stamp = BENCH_NOW();
+
+	NVIC_SetPendingIRQ(TC8_IRQn);
+}
+
+#elif defined(uMT_POSIX)
+
+#include <signal.h>
+
+static void SwiHandler(int)
+{
+	BenchIsr();
+}
+
+static void IsrSetup()
+{
+	struct sigaction Action;
+
+	memset(&Action, 0, sizeof(Action));
+	Action.sa_handler = SwiHandler;
+	sigemptyset(&Action.sa_mask);
+	sigaddset(&Action.sa_mask, uMT_POSIX_TICK_SIGNAL);	// INTs disabled in the handler
+#if uMT_USE_ISR_PREEMPTION==1
+	sigaddset(&Action.sa_mask, uMT_POSIX_SWITCH_SIGNAL);
+#endif
+
+	sigaction(SIGUSR1, &Action, NULL);
+}
+
+static void IsrTrigger()
+{
+	Stamp = BENCH_NOW();
+
+	raise(SIGUSR1);
+}
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	Peer tasks
+//
+////////////////////////////////////////////////////////////////////////////////////
+static void YieldPeer()
+{
+	Kernel.Tk_Yield();
+
+	for (unsigned idx = 0; idx < BENCH_SAMPLES; idx++)
+	{
+		SetA.Add((BenchTime_t)(BENCH_NOW() - Stamp));
+
+		Kernel.Tk_Yield();
+	}
+
+	Kernel.Tk_DeleteTask();
+}
+
+static void SemPeer()
+{
+	for (unsigned idx = 0; idx < BENCH_SAMPLES; idx++)
+	{
+		Kernel.Sm_Claim(BENCH_SEM_HANDOFF, uMT_WAIT);
+
+		SetA.Add((BenchTime_t)(BENCH_NOW() - Stamp));
+	}
+
+	Kernel.Tk_DeleteTask();
+}
+
+static void EventPeer()
+{
+	Event_t	eventout;
+
+	for (unsigned idx = 0; idx < BENCH_SAMPLES; idx++)
+	{
+		Kernel.Ev_Receive(BENCH_EVENT, uMT_ANY, &eventout);
+
+		SetA.Add((BenchTime_t)(BENCH_NOW() - Stamp));
+	}
+
+	Kernel.Tk_DeleteTask();
+}
+
+static void IsrPeer()
+{
+	Event_t	eventout;
+
+	for (unsigned idx = 0; idx < BENCH_SAMPLES; idx++)
+	{
+		Kernel.Ev_Receive(BENCH_EVENT, uMT_ANY, &eventout);
+
+		SetB.Add((BenchTime_t)(BENCH_NOW() - IsrStamp));
+	}
+
+	Kernel.Tk_DeleteTask();
+}
+
+
+static void StartPeer(FuncAddress_t Peer, TaskPrio_t Priority)
+{
+	TaskPrio_t OldPrio;
+
+	SetA.Reset();
+	SetB.Reset();
+
+	CheckError(F("Tk_CreateTask"), Kernel.Tk_CreateTask(Peer, PeerTid));
+	CheckError(F("Tk_SetPriority"), Kernel.Tk_SetPriority(PeerTid, Priority, OldPrio));
+	CheckError(F("Tk_StartTask"), Kernel.Tk_StartTask(PeerTid));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	Benchmarks (run by TID 1, PRIO_NORMAL)
+//
+////////////////////////////////////////////////////////////////////////////////////
+static void BenchYield()
+{
+	StartPeer(YieldPeer, PRIO_NORMAL);
+
+	Kernel.Tk_Yield();
+
+	for (unsigned idx = 0; idx < BENCH_SAMPLES; idx++)
+	{
+		Stamp = BENCH_NOW();
+
+		Kernel.Tk_Yield();
+	}
+
+	Kernel.Tk_Yield();		// Let the peer delete itself
+
+	SetA.Print(F("yield"), F(BENCH_UNIT));
+}
+
+static void BenchSemaphores()
+{
+	// Higher priority peer: it runs at once and blocks in Sm_Claim()
+	StartPeer(SemPeer, PRIO_NORMAL + 1);
+
+	for (unsigned idx = 0; idx < BENCH_SAMPLES; idx++)
+	{
+		Stamp = BENCH_NOW();
+
+		Kernel.Sm_Release(BENCH_SEM_HANDOFF);
+	}
+
+	SetA.Print(F("sem_handoff"), F(BENCH_UNIT));
+
+	SetA.Reset();
+
+	Kernel.Sm_Release(BENCH_SEM_FREE);
+
+	for (unsigned idx = 0; idx < BENCH_SAMPLES; idx++)
+	{
+		BenchTime_t Start = BENCH_NOW();
+
+		Kernel.Sm_Claim(BENCH_SEM_FREE, uMT_WAIT);
+		Kernel.Sm_Release(BENCH_SEM_FREE);
+
+		SetA.Add((BenchTime_t)(BENCH_NOW() - Start));
+	}
+
+	SetA.Print(F("sem_uncontended"), F(BENCH_UNIT));
+}
+
+static void BenchEvents()
+{
+	StartPeer(EventPeer, PRIO_NORMAL + 1);
+
+	for (unsigned idx = 0; idx < BENCH_SAMPLES; idx++)
+	{
+		Stamp = BENCH_NOW();
+
+		Kernel.Ev_Send(PeerTid, BENCH_EVENT);
+	}
+
+	SetA.Print(F("ev_wakeup"), F(BENCH_UNIT));
+}
+
+static void BenchTimers()
+{
+	TimerId_t	BgTimer[BENCH_BG_TIMERS];
+	TimerId_t	TmId;
+
+	SetA.Reset();
+	SetB.Reset();
+
+	for (unsigned idx = 0; idx < BENCH_BG_TIMERS; idx++)
+		CheckError(F("Tm_EvAfter"), Kernel.Tm_EvAfter(BgTimeout[idx], BENCH_EVENT, BgTimer[idx]));
+
+	for (unsigned idx = 0; idx < BENCH_SAMPLES; idx++)
+	{
+		BenchTime_t Start = BENCH_NOW();
+
+		Kernel.Tm_EvAfter(1000 + idx, BENCH_EVENT, TmId);
+
+		BenchTime_t Middle = BENCH_NOW();
+
+		Kernel.Tm_Cancel(TmId);
+
+		BenchTime_t End = BENCH_NOW();
+
+		SetA.Add((BenchTime_t)(Middle - Start));
+		SetB.Add((BenchTime_t)(End - Middle));
+	}
+
+	for (unsigned idx = 0; idx < BENCH_BG_TIMERS; idx++)
+		Kernel.Tm_Cancel(BgTimer[idx]);
+
+	SetA.Print(F("tm_insert"), F(BENCH_UNIT));
+	SetB.Print(F("tm_cancel"), F(BENCH_UNIT));
+
+	SetA.Reset();
+
+	for (unsigned idx = 0; idx < BENCH_SAMPLES; idx++)
+	{
+		unsigned long Start = micros();
+
+		Kernel.Tm_WakeupAfter(1);
+
+		SetA.Add(micros() - Start);
+	}
+
+	SetA.Print(F("tm_wakeup"), F("us"));
+}
+
+static void BenchInterrupts()
+{
+	IsrSetup();
+
+	IsrPreempt = TRUE;
+
+	StartPeer(IsrPeer, PRIO_NORMAL + 1);
+
+	for (unsigned idx = 0; idx < BENCH_SAMPLES; idx++)
+		IsrTrigger();
+
+	SetA.Print(F("isr_entry"), F(BENCH_UNIT));
+	SetB.Print(F("isr_to_task"), F(BENCH_UNIT));
+
+#if uMT_USE_ISR_PREEMPTION==1
+	// Without it the peer would only run at the next System Tick
+	IsrPreempt = FALSE;
+
+	StartPeer(IsrPeer, PRIO_NORMAL + 1);
+
+	for (unsigned idx = 0; idx < BENCH_SAMPLES; idx++)
+		IsrTrigger();
+
+	SetB.Print(F("isr_defer_to_task"), F(BENCH_UNIT));
+#endif
+}
+
+
+void setup()
+{
+	// put your setup code here, to run once:
+
+	Serial.begin(57600);
+
+	Serial.println(F("MySetup(): Initialising..."));
+	delay(100); //Allow for serial print to complete.
+
+	Serial.println(F("================= KERNEL LATENCY benchmarks ================="));
+	Serial.flush();
+
+	uMTcfg Cfg;
+
+	Kernel.Kn_GetConfiguration(Cfg);
+
+	Cfg.rw.BlinkingLED = FALSE;
+	Cfg.rw.TimeSharingEnabled = FALSE;
+
+	CheckError(F("Kn_Start"), Kernel.Kn_Start(Cfg));
+}
+
+
+void loop()		// TASK TID=1
+{
+	BenchTimeSetup();
+
+	BenchSet::PrintHeader();
+
+	BenchYield();
+	BenchSemaphores();
+	BenchEvents();
+	BenchTimers();
+	BenchInterrupts();
+
+	Serial.println(F("================= KERNEL LATENCY benchmarks END ================="));
+	Serial.flush();
+
+	Kernel.isr_Kn_Reboot();
+
+	while (1)
+		;
+}
+
+#else
+
+void setup()
+{
+	Serial.begin(57600);
+
+	Serial.println(F("Bench01_KernelLatency: Semaphores, Events and Timers are required!"));
+	Serial.flush();
+}
+
+void loop()
+{
+}
+
+#endif
+
+
+////////////////////// EOF
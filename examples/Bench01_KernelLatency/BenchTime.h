@@ -0,0 +1,204 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: BenchTime.h
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef BenchTime_h
+#define BenchTime_h
+
+///////////////////////////////////////////////////////////////////////////////////
+//
+// High resolution time stamps and sample statistics for the benchmarks.
+//
+//	AVR:	the kernel CPU time source (uMT_CpuTicks(), see uMTcpuTime.h) when
+//			uMT_USE_TASK_STATISTICS>=2 selects a counter other than micros(),
+//			otherwise micros(). TIMER 1 is never touched: the kernel may own it.
+//	SAM:	DWT cycle counter (32 bits)
+//	LINUX:	CLOCK_MONOTONIC, nanoseconds
+//
+// Deltas are computed in BenchTime_t, so a single wrap of the counter is harmless.
+//
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#if defined(ARDUINO_ARCH_AVR)
+
+typedef uint32_t	BenchTime_t;
+
+#define BENCH_SAMPLES		32
+
+#if uMT_USE_TASK_STATISTICS>=2 && uMT_CPU_TIMESOURCE!=uMT_CPUTIME_MICROS
+
+#define BENCH_UNIT			"cputicks"		// uMT_CPU_TICKS_PER_US per microsecond
+
+// uMT_CpuTicks() must be entered with INTS disabled
+inline BenchTime_t BENCH_NOW()
+{
+	uint8_t		sreg = SREG;
+
+	cli();
+	BenchTime_t	Now = uMT_CpuTicks();
+	SREG = sreg;
+
+	return(Now);
+}
+
+#else
+
+#define BENCH_UNIT			"us"
+
+#define BENCH_NOW()			micros()
+
+#endif
+
+inline void BenchTimeSetup()
+{
+}
+
+#elif defined(ARDUINO_ARCH_SAM)
+
+typedef uint32_t	BenchTime_t;
+
+#define BENCH_UNIT			"cycles"
+#define BENCH_SAMPLES		256
+
+#define BENCH_NOW()			DWT->CYCCNT
+
+inline void BenchTimeSetup()
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+#elif defined(uMT_POSIX)
+
+#include <time.h>
+
+typedef uint32_t	BenchTime_t;
+
+#define BENCH_UNIT			"ns"
+#define BENCH_SAMPLES		256
+
+inline BenchTime_t BENCH_NOW()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return((BenchTime_t)((uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec));
+}
+
+inline void BenchTimeSetup()
+{
+}
+
+#else
+#error "Unsupported architecture"
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	BenchSet: one set of samples
+//
+// Printed as a CSV line:
+//	BENCH,<name>,<unit>,<count>,<min>,<avg>,<p50>,<p90>,<p99>,<max>
+//
+////////////////////////////////////////////////////////////////////////////////////
+class BenchSet
+{
+public:
+	uint32_t	Sample[BENCH_SAMPLES];
+	unsigned	Count;
+
+	void	Reset() { Count = 0; };
+
+	void	Add(uint32_t Value)
+	{
+		if (Count < BENCH_SAMPLES)
+			Sample[Count++] = Value;
+	};
+
+	static void	PrintHeader()
+	{
+		Serial.println(F("BENCH,name,unit,count,min,avg,p50,p90,p99,max"));
+		Serial.flush();
+	};
+
+	void	Print(const __FlashStringHelper *Name, const __FlashStringHelper *Unit)
+	{
+		if (Count == 0)
+			return;
+
+		// Insertion sort: BENCH_SAMPLES is small
+		for (unsigned idx = 1; idx < Count; idx++)
+		{
+			uint32_t	Value = Sample[idx];
+			unsigned	pos = idx;
+
+			for (; pos > 0 && Sample[pos - 1] > Value; pos--)
+				Sample[pos] = Sample[pos - 1];
+
+			Sample[pos] = Value;
+		}
+
+		uint64_t Sum = 0;
+
+		for (unsigned idx = 0; idx < Count; idx++)
+			Sum += Sample[idx];
+
+		Serial.print(F("BENCH,"));
+		Serial.print(Name);
+		Serial.print(',');
+		Serial.print(Unit);
+		Serial.print(',');
+		Serial.print(Count);
+		Serial.print(',');
+		Serial.print(Sample[0]);
+		Serial.print(',');
+		Serial.print((uint32_t)(Sum / Count));
+		Serial.print(',');
+		Serial.print(Percentile(50));
+		Serial.print(',');
+		Serial.print(Percentile(90));
+		Serial.print(',');
+		Serial.print(Percentile(99));
+		Serial.print(',');
+		Serial.println(Sample[Count - 1]);
+		Serial.flush();
+	};
+
+private:
+	// Nearest rank, samples already sorted
+	uint32_t	Percentile(unsigned Pct)
+	{
+		unsigned Rank = (Pct * Count + 99) / 100;
+
+		return(Sample[Rank > 0 ? Rank - 1 : 0]);
+	};
+};
+
+
+#endif
+
+////////////////////// EOF
@@ -0,0 +1,6 @@
+
+// Demo configuration
+
+#define TEST_MUTEX		1 
+
+/////////// EOF
\ No newline at end of file
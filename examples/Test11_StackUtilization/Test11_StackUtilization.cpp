@@ -155,6 +155,9 @@ void LOOP()		// TASK TID=1
 	{
 		Kernel.Tm_WakeupAfter(4000);
 		Kernel.Kn_PrintInternals(TRUE);
+
+		// Same counters, printed with preemption enabled
+		Kernel.Kn_PrintSnapshot();
 	}
 
 }
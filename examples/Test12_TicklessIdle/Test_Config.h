@@ -0,0 +1,6 @@
+
+// Demo configuration
+
+#define TEST_TICKLESS_IDLE		1 
+
+/////////// EOF
\ No newline at end of file
@@ -0,0 +1,5 @@
+extern void setup();
+extern void loop();
+
+
+////////////////////// EOF
\ No newline at end of file
@@ -0,0 +1,277 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: Test19_RwLocks.cpp
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "Test_Config.h"
+
+
+#if TEST_RWLOCKS==1
+#define SETUP()	setup()
+#define LOOP()	loop()
+#else
+#define SETUP()	RWLOCKS_setup()
+#define LOOP()	RWLOCKS_loop()
+#endif
+
+#include <Arduino.h>
+
+#include <uMT.h>
+
+
+#if uMT_USE_RWLOCKS==1 && uMT_USE_EVENTS==1 && uMT_USE_TIMERS==1
+
+///////////////////////////////////////////////////////////////////////////////////
+//
+// A calibration table is read by READERS tasks and updated by one writer, all of
+// them yielding while holding the lock:
+// 1) readers hold the lock together, never while the writer holds it;
+// 2) readers always see a consistent table;
+// 3) a waiting writer keeps new readers out (writer preference) until it times out;
+// 4) when it times out the readers get in at once, even if the writer cannot run.
+//
+///////////////////////////////////////////////////////////////////////////////////
+
+#define READERS				3
+#define ROUNDS				500
+#define TABLE_SIZE			8
+
+#define EV_DONE				0x0001
+
+static RwLockId_t		TableLock;
+static TaskId_t			MainTid;
+static uint16_t			Table[TABLE_SIZE];
+
+static volatile uint8_t	ActiveReaders;
+static volatile uint8_t	MaxActiveReaders;
+static volatile Bool_t	Writing;
+static volatile uint8_t	RunningTasks;		// The last one sends EV_DONE
+static volatile Bool_t	LateReaderIn;
+
+
+static void CheckError(const __FlashStringHelper *Msg, Errno_t error, Errno_t expected = E_SUCCESS)
+{
+	if (error != expected)
+	{
+		Serial.print(F("FATAL ERROR: "));
+		Serial.print(Msg);
+		Serial.print(F(" - ERRNO = "));
+		Serial.println((unsigned)error);
+		Serial.flush();
+
+		Kernel.isr_Kn_FatalError();
+	}
+}
+
+
+static TaskId_t	StartTask(FuncAddress_t Task, TaskPrio_t Priority)
+{
+	TaskId_t	Tid;
+	TaskPrio_t	OldPrio;
+
+	CheckError(F("Tk_CreateTask"), Kernel.Tk_CreateTask(Task, Tid));
+	CheckError(F("Tk_SetPriority"), Kernel.Tk_SetPriority(Tid, Priority, OldPrio));
+	CheckError(F("Tk_StartTask"), Kernel.Tk_StartTask(Tid));
+
+	return(Tid);
+}
+
+
+static void ReaderTask()
+{
+	for (uint16_t Round = 0; Round < ROUNDS; Round++)
+	{
+		CheckError(F("Reader: Rw_ReadLock"), Kernel.Rw_ReadLock(TableLock, uMT_WAIT));
+		CheckError(F("Reader: writer active"), (Writing == FALSE ? E_SUCCESS : E_INVALID_OPTION));
+
+		if (++ActiveReaders > MaxActiveReaders)
+			MaxActiveReaders = ActiveReaders;
+
+		uint16_t Version = Table[0];
+
+		Kernel.Tk_Yield();		// Still holding the lock
+
+		for (int idx = 1; idx < TABLE_SIZE; idx++)
+			CheckError(F("Reader: inconsistent table"), (Table[idx] == Version ? E_SUCCESS : E_INVALID_OPTION));
+
+		ActiveReaders--;
+
+		CheckError(F("Reader: Rw_Unlock"), Kernel.Rw_Unlock(TableLock));
+	}
+
+	if (--RunningTasks == 0)
+		Kernel.Ev_Send(MainTid, EV_DONE);
+
+	Kernel.Tk_DeleteTask();
+}
+
+
+static void WriterTask()
+{
+	for (uint16_t Round = 1; Round <= ROUNDS / 10; Round++)
+	{
+		CheckError(F("Writer: Rw_WriteLock"), Kernel.Rw_WriteLock(TableLock, uMT_WAIT));
+		CheckError(F("Writer: readers active"), (ActiveReaders == 0 ? E_SUCCESS : E_INVALID_OPTION));
+
+		Writing = TRUE;
+
+		for (int idx = 0; idx < TABLE_SIZE; idx++)
+		{
+			Table[idx] = Round;
+
+			Kernel.Tk_Yield();		// Still holding the lock
+		}
+
+		Writing = FALSE;
+
+		CheckError(F("Writer: Rw_Unlock"), Kernel.Rw_Unlock(TableLock));
+
+		Kernel.Tk_Yield();
+	}
+
+	if (--RunningTasks == 0)
+		Kernel.Ev_Send(MainTid, EV_DONE);
+
+	Kernel.Tk_DeleteTask();
+}
+
+
+static void TimeoutWriterTask()
+{
+	CheckError(F("Rw_WriteLock(timeout)"), Kernel.Rw_WriteLock(TableLock, uMT_WAIT, 20), E_TIMEOUT);
+
+	Kernel.Ev_Send(MainTid, EV_DONE);
+
+	Kernel.Tk_DeleteTask();
+}
+
+
+static void LateReaderTask()
+{
+	CheckError(F("Rw_ReadLock(writer timed out)"), Kernel.Rw_ReadLock(TableLock, uMT_WAIT, 1000));
+
+	LateReaderIn = TRUE;
+
+	CheckError(F("Rw_Unlock"), Kernel.Rw_Unlock(TableLock));
+
+	Kernel.Tk_DeleteTask();
+}
+
+
+void SETUP()
+{
+	// put your setup code here, to run once:
+
+	Serial.begin(57600);
+
+	Serial.println(F("MySetup(): Initialising..."));
+	delay(100); //Allow for serial print to complete.
+
+	Serial.println(F("================= RW LOCKS test ================="));
+	Serial.flush();
+
+	Serial.println(F("MySetup(): => Kernel.Kn_Start()"));
+	Serial.flush();
+
+	Kernel.Kn_Start(FALSE);		// NO timesharing
+}
+
+
+void LOOP()		// TASK TID=1
+{
+	Event_t		eventout;
+
+	Kernel.Tk_GetMyTid(MainTid);
+
+	CheckError(F("Rw_Create"), Kernel.Rw_Create(TableLock));
+
+	// Error cases
+	CheckError(F("Rw_Unlock(not held)"), Kernel.Rw_Unlock(TableLock), E_NOT_OWNED_RWLOCK);
+	CheckError(F("Rw_WriteLock"), Kernel.Rw_WriteLock(TableLock, uMT_NOWAIT));
+	CheckError(F("Rw_WriteLock(again)"), Kernel.Rw_WriteLock(TableLock, uMT_WAIT), E_NOT_ALLOWED);
+	CheckError(F("isr_Rw_TryReadLock(writer)"), Kernel.isr_Rw_TryReadLock(TableLock), E_WOULD_BLOCK);
+	CheckError(F("Rw_ReadLock(timeout)"), Kernel.Rw_ReadLock(TableLock, uMT_WAIT, 5), E_TIMEOUT);
+	CheckError(F("Rw_Unlock"), Kernel.Rw_Unlock(TableLock));
+	CheckError(F("isr_Rw_TryReadLock"), Kernel.isr_Rw_TryReadLock(TableLock));
+	CheckError(F("Rw_WriteLock(readers)"), Kernel.Rw_WriteLock(TableLock, uMT_NOWAIT), E_WOULD_BLOCK);
+	CheckError(F("isr_Rw_ReadUnlock"), Kernel.isr_Rw_ReadUnlock(TableLock));
+
+	// 1) and 2) Readers and writer
+	RunningTasks = READERS + 1;
+
+	for (int idx = 0; idx < READERS; idx++)
+		StartTask(ReaderTask, PRIO_NORMAL);
+
+	StartTask(WriterTask, PRIO_NORMAL);
+
+	CheckError(F("Ev_Receive(EV_DONE)"), Kernel.Ev_Receive(EV_DONE, uMT_ANY, &eventout));
+
+	CheckError(F("Readers not in parallel"), (MaxActiveReaders == READERS ? E_SUCCESS : E_INVALID_OPTION));
+	CheckError(F("Last update lost"), (Table[0] == ROUNDS / 10 ? E_SUCCESS : E_INVALID_OPTION));
+
+	Serial.print(F(" Task1(): readers in parallel => "));
+	Serial.println(MaxActiveReaders);
+	Serial.flush();
+
+	// 3) Writer preference
+	CheckError(F("Rw_ReadLock"), Kernel.Rw_ReadLock(TableLock, uMT_NOWAIT));
+
+	StartTask(TimeoutWriterTask, PRIO_HIGH);		// Waits for the write lock
+
+	CheckError(F("isr_Rw_TryReadLock(writer waiting)"), Kernel.isr_Rw_TryReadLock(TableLock), E_WOULD_BLOCK);
+	CheckError(F("Ev_Receive(EV_DONE)"), Kernel.Ev_Receive(EV_DONE, uMT_ANY, &eventout));
+	CheckError(F("isr_Rw_TryReadLock(writer gone)"), Kernel.isr_Rw_TryReadLock(TableLock));
+	CheckError(F("isr_Rw_ReadUnlock"), Kernel.isr_Rw_ReadUnlock(TableLock));
+	CheckError(F("Rw_Unlock"), Kernel.Rw_Unlock(TableLock));
+
+	// 4) A low priority writer times out while this task keeps the CPU busy
+	CheckError(F("Rw_ReadLock"), Kernel.Rw_ReadLock(TableLock, uMT_NOWAIT));
+
+	StartTask(TimeoutWriterTask, PRIO_LOW);
+	Kernel.Tm_WakeupAfter(2);						// Let it wait for the write lock
+
+	StartTask(LateReaderTask, PRIO_HIGH);			// Waits behind the writer
+
+	uint32_t Start = millis();
+
+	while (LateReaderIn == FALSE && millis() - Start < 200)
+		;
+
+	CheckError(F("Reader blocked by a timed out writer"), (LateReaderIn == TRUE ? E_SUCCESS : E_INVALID_OPTION));
+	CheckError(F("Rw_Unlock"), Kernel.Rw_Unlock(TableLock));
+	CheckError(F("Ev_Receive(EV_DONE)"), Kernel.Ev_Receive(EV_DONE, uMT_ANY, &eventout));
+
+	Serial.print(F(" Task1(): reader in after writer timeout => "));
+	Serial.println(millis() - Start);
+
+	Serial.println(F("================= END ================="));
+	Serial.flush();
+
+	Kernel.isr_Kn_Reboot();
+}
+
+
+#endif
+
+
+////////////////////// EOF
@@ -0,0 +1,198 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: Test21_Profiler.cpp
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "Test_Config.h"
+
+
+#if TEST_PROFILER==1
+#define SETUP()	setup()
+#define LOOP()	loop()
+#else
+#define SETUP()	PROFILER_setup()
+#define LOOP()	PROFILER_loop()
+#endif
+
+#include <Arduino.h>
+
+#include <uMT.h>
+
+
+#if uMT_USE_PROFILER==1 && uMT_USE_EVENTS==1 && uMT_USE_TIMERS==1
+
+///////////////////////////////////////////////////////////////////////////////////
+//
+// Two time sharing tasks spin for RUN_MS: one spends 3/4 of its time in
+// HeavyWork(), the other only calls LightWork(). The profile is then dumped to
+// Serial. Save the output and map it to functions:
+//
+//	extras/profile/uMTprofile.py firmware.elf serial.log
+//
+///////////////////////////////////////////////////////////////////////////////////
+
+#define RUN_MS				2000
+
+#define EV_DONE				0x0001
+
+static TaskId_t		MainTid;
+static uint8_t		RunningTasks;
+static volatile uint32_t	Counter;
+
+
+static void CheckError(const __FlashStringHelper *Msg, Errno_t error, Errno_t expected = E_SUCCESS)
+{
+	if (error != expected)
+	{
+		Serial.print(F("FATAL ERROR: "));
+		Serial.print(Msg);
+		Serial.print(F(" - ERRNO = "));
+		Serial.println((unsigned)error);
+		Serial.flush();
+
+		Kernel.isr_Kn_FatalError();
+	}
+}
+
+
+static void __attribute__((noinline)) HeavyWork()
+{
+	for (int idx = 0; idx < 300; idx++)
+		Counter++;
+}
+
+
+static void __attribute__((noinline)) LightWork()
+{
+	for (int idx = 0; idx < 100; idx++)
+		Counter++;
+}
+
+
+static void Done()
+{
+	CpuStatusReg_t	CpuFlags = Kernel.isr_Kn_IntLock();
+
+	Bool_t Last = (--RunningTasks == 0);
+
+	Kernel.isr_Kn_IntUnlock(CpuFlags);
+
+	if (Last)
+		Kernel.Ev_Send(MainTid, EV_DONE);
+
+	Kernel.Tk_DeleteTask();
+}
+
+
+static void HeavyTask()
+{
+	uint32_t Start = millis();
+
+	while (millis() - Start < RUN_MS)
+	{
+		HeavyWork();
+		LightWork();
+	}
+
+	Done();
+}
+
+
+static void LightTask()
+{
+	uint32_t Start = millis();
+
+	while (millis() - Start < RUN_MS)
+		LightWork();
+
+	Done();
+}
+
+
+void SETUP()
+{
+	// put your setup code here, to run once:
+
+	Serial.begin(57600);
+
+	Serial.println(F("MySetup(): Initialising..."));
+	delay(100); //Allow for serial print to complete.
+
+	Serial.println(F("================= PROFILER test ================="));
+	Serial.flush();
+
+	Serial.println(F("MySetup(): => Kernel.Kn_Start()"));
+	Serial.flush();
+
+	Kernel.Kn_Start(TRUE);		// Timesharing
+}
+
+
+void LOOP()		// TASK TID=1
+{
+	TaskId_t	Tid;
+	Event_t		eventout;
+
+	Kernel.Tk_GetMyTid(MainTid);
+
+	RunningTasks = 2;
+
+	CheckError(F("Kn_ProfilerStart"), Kernel.Kn_ProfilerStart(1));
+
+	CheckError(F("Tk_CreateTask"), Kernel.Tk_CreateTask(HeavyTask, Tid));
+	CheckError(F("Tk_StartTask"), Kernel.Tk_StartTask(Tid));
+
+	CheckError(F("Tk_CreateTask"), Kernel.Tk_CreateTask(LightTask, Tid));
+	CheckError(F("Tk_StartTask"), Kernel.Tk_StartTask(Tid));
+
+	CheckError(F("Ev_Receive"), Kernel.Ev_Receive(EV_DONE, uMT_ANY, &eventout));
+
+	CheckError(F("Kn_ProfilerDump"), Kernel.Kn_ProfilerDump());
+
+	Serial.println(F("================= END ================="));
+	Serial.flush();
+
+	Kernel.isr_Kn_Reboot();
+}
+
+
+#else
+
+void SETUP()
+{
+	Serial.begin(57600);
+
+	Serial.println(F("Test21_Profiler: set uMT_USE_PROFILER to 1 in uMTconfiguration.h"));
+	Serial.flush();
+
+	Kernel.isr_Kn_Reboot();
+}
+
+void LOOP()
+{
+}
+
+#endif
+
+
+////////////////////// EOF
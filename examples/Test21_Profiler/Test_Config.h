@@ -0,0 +1,6 @@
+
+// Demo configuration
+
+#define TEST_PROFILER		1 
+
+/////////// EOF
\ No newline at end of file
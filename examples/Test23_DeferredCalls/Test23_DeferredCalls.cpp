@@ -0,0 +1,208 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: Test23_DeferredCalls.cpp
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include "Test_Config.h"
+
+
+#if TEST_DPC==1
+#define SETUP()	setup()
+#define LOOP()	loop()
+#else
+#define SETUP()	DPC_setup()
+#define LOOP()	DPC_loop()
+#endif
+
+#include <Arduino.h>
+
+#include <uMT.h>
+
+
+#if uMT_USE_DPC==1 && uMT_USE_EVENTS==1 && uMT_USE_TIMERS==1
+
+///////////////////////////////////////////////////////////////////////////////////
+//
+// Set uMT_USE_DPC to 1 in uMTconfiguration.h.
+//
+// A higher priority producer posts bursts of deferred calls with isr_Dp_Post(),
+// as an ISR would, and then sleeps for one tick. The service task runs them and
+// DeferredWork() checks that nothing is lost or reordered. At the end the queue
+// is filled up with INTS disabled to check the lost entries counter.
+//
+///////////////////////////////////////////////////////////////////////////////////
+
+#define BURST				5
+#define CALL_NUM			1000
+
+#define EV_DONE				0x0001
+
+static TaskId_t		MainTid;
+static uint16_t		Expected;
+
+
+static void CheckError(const __FlashStringHelper *Msg, Errno_t error, Errno_t expected = E_SUCCESS)
+{
+	if (error != expected)
+	{
+		Serial.print(F("FATAL ERROR: "));
+		Serial.print(Msg);
+		Serial.print(F(" - ERRNO = "));
+		Serial.println((unsigned)error);
+		Serial.flush();
+
+		Kernel.isr_Kn_FatalError();
+	}
+}
+
+
+static void DeferredWork(void *Arg)
+{
+	CheckError(F("DeferredWork: wrong sequence"), ((uint16_t)(uintptr_t)Arg == Expected ? E_SUCCESS : E_INVALID_OPTION));
+
+	if (++Expected == CALL_NUM)
+		Kernel.Ev_Send(MainTid, EV_DONE);
+}
+
+
+static void NoWork(void *Arg)
+{
+	(void)Arg;
+}
+
+
+static void ProducerTask()
+{
+	uint16_t	SeqNo = 0;
+
+	while (SeqNo < CALL_NUM)
+	{
+		for (int idx = 0; idx < BURST && SeqNo < CALL_NUM; idx++, SeqNo++)
+			CheckError(F("Producer: isr_Dp_Post"), Kernel.isr_Dp_Post(DeferredWork, (void *)(uintptr_t)SeqNo));
+
+		Kernel.Tm_WakeupAfter(1);
+	}
+
+	Kernel.Tk_DeleteTask();
+}
+
+
+void SETUP()
+{
+	// put your setup code here, to run once:
+
+	Serial.begin(57600);
+
+	Serial.println(F("MySetup(): Initialising..."));
+	delay(100); //Allow for serial print to complete.
+
+	Serial.println(F("================= DEFERRED CALLS test ================="));
+	Serial.flush();
+
+	Serial.println(F("MySetup(): => Kernel.Kn_Start()"));
+	Serial.flush();
+
+	Kernel.Kn_Start(FALSE);		// NO timesharing
+}
+
+
+void LOOP()		// TASK TID=1
+{
+	TaskId_t	Tid;
+	TaskPrio_t	OldPrio;
+	Event_t		eventout;
+	uMTdpcInfo	Info;
+
+	Kernel.Tk_GetMyTid(MainTid);
+
+	// Error cases
+	CheckError(F("Dp_Post(NULL)"), Kernel.Dp_Post(NULL, NULL), E_INVALID_OPTION);
+
+	CheckError(F("Tk_CreateTask"), Kernel.Tk_CreateTask(ProducerTask, Tid));
+	CheckError(F("Tk_SetPriority"), Kernel.Tk_SetPriority(Tid, PRIO_HIGH, OldPrio));
+	CheckError(F("Tk_StartTask"), Kernel.Tk_StartTask(Tid));
+
+	CheckError(F("Ev_Receive(EV_DONE)"), Kernel.Ev_Receive(EV_DONE, uMT_ANY, &eventout, 5000));
+
+	CheckError(F("Dp_GetInfo"), Kernel.Dp_GetInfo(Info));
+	CheckError(F("Posted"), (Info.Posted == CALL_NUM ? E_SUCCESS : E_INVALID_OPTION));
+	CheckError(F("Lost"), (Info.Lost == 0 ? E_SUCCESS : E_INVALID_OPTION));
+
+	Serial.print(F(" Task1(): calls deferred => "));
+	Serial.print(CALL_NUM);
+	Serial.print(F(" (max queued = "));
+	Serial.print(Info.MaxCount);
+	Serial.println(F(")"));
+
+	// Fill up the queue: the service task cannot run with INTS disabled
+	CpuStatusReg_t	CpuFlags = Kernel.isr_Kn_IntLock();
+
+	Errno_t	error = E_SUCCESS;
+
+	for (unsigned int idx = 0; idx < Info.QueueSize && error == E_SUCCESS; idx++)
+		error = Kernel.isr_Dp_Post(NoWork, NULL);
+
+	Errno_t	errorFull = Kernel.isr_Dp_Post(NoWork, NULL);
+
+	Kernel.isr_Kn_IntUnlock(CpuFlags);
+
+	CheckError(F("isr_Dp_Post"), error);
+	CheckError(F("isr_Dp_Post(FULL)"), errorFull, E_DPC_QUEUE_FULL);
+
+	Kernel.Tm_WakeupAfter(2);
+
+	CheckError(F("Dp_GetInfo"), Kernel.Dp_GetInfo(Info));
+	CheckError(F("Count(EMPTY)"), (Info.Count == 0 ? E_SUCCESS : E_INVALID_OPTION));
+	CheckError(F("Lost"), (Info.Lost == 1 ? E_SUCCESS : E_INVALID_OPTION));
+
+	Serial.print(F(" Task1(): lost => "));
+	Serial.println(Info.Lost);
+
+	Serial.println(F("================= END ================="));
+	Serial.flush();
+
+	Kernel.isr_Kn_Reboot();
+}
+
+
+#else
+
+void SETUP()
+{
+	Serial.begin(57600);
+
+	Serial.println(F("Test23_DeferredCalls: set uMT_USE_DPC to 1 in uMTconfiguration.h"));
+	Serial.flush();
+
+	Kernel.isr_Kn_Reboot();
+}
+
+void LOOP()
+{
+}
+
+#endif
+
+
+////////////////////// EOF
@@ -0,0 +1,355 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: Arduino.cpp (Linux host)
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <signal.h>
+#include <ucontext.h>
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	Emulated RAM: Arduino loop() (uMT TID 1) runs on this STACK
+//
+////////////////////////////////////////////////////////////////////////////////////
+#define RAM_SIZE	(256 * 1024)
+
+static uint8_t		Ram[RAM_SIZE] __attribute__((aligned(16)));
+
+uintptr_t	__ram_start = (uintptr_t)&Ram[0];
+uintptr_t	__ram_end = (uintptr_t)&Ram[RAM_SIZE - 16];
+
+HardwareSerial Serial;
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	Time
+//
+////////////////////////////////////////////////////////////////////////////////////
+static uint64_t	Monotonic_us()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return((uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
+}
+
+static uint64_t	Start_us = Monotonic_us();
+
+unsigned long millis()
+{
+	return((uint32_t)((Monotonic_us() - Start_us) / 1000));
+}
+
+unsigned long micros()
+{
+	return((uint32_t)(Monotonic_us() - Start_us));
+}
+
+// Busy wait, like Arduino (the System Tick must keep running)
+void delayMicroseconds(unsigned int us)
+{
+	uint64_t End = Monotonic_us() + us;
+
+	while (Monotonic_us() < End)
+		;
+}
+
+void delay(unsigned long ms)
+{
+	uint64_t End = Monotonic_us() + (uint64_t)ms * 1000;
+
+	while (Monotonic_us() < End)
+		;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	Digital I/O: no pins on the host
+//
+////////////////////////////////////////////////////////////////////////////////////
+static uint8_t	Pins[256];
+
+void pinMode(uint8_t, uint8_t)
+{
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+	Pins[pin] = val;
+}
+
+int digitalRead(uint8_t pin)
+{
+	return(Pins[pin]);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	Interrupts: the uMT System Tick is SIGALRM
+//
+////////////////////////////////////////////////////////////////////////////////////
+void noInterrupts()
+{
+	sigset_t	Set;
+
+	sigemptyset(&Set);
+	sigaddset(&Set, SIGALRM);
+	sigprocmask(SIG_BLOCK, &Set, NULL);
+}
+
+void interrupts()
+{
+	sigset_t	Set;
+
+	sigemptyset(&Set);
+	sigaddset(&Set, SIGALRM);
+	sigprocmask(SIG_UNBLOCK, &Set, NULL);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	Random
+//
+////////////////////////////////////////////////////////////////////////////////////
+long random(long howbig)
+{
+	if (howbig == 0)
+		return(0);
+
+	return(::random() % howbig);
+}
+
+long random(long howsmall, long howbig)
+{
+	if (howsmall >= howbig)
+		return(howsmall);
+
+	return(random(howbig - howsmall) + howsmall);
+}
+
+void randomSeed(unsigned long seed)
+{
+	srandom(seed);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	Serial
+//
+// libc is not reentrant: the System Tick is blocked while writing, so a task switch
+// cannot happen in the middle of a print().
+//
+////////////////////////////////////////////////////////////////////////////////////
+static size_t	WriteOut(const char *buf, size_t len)
+{
+	sigset_t	Set;
+	sigset_t	OldSet;
+
+	sigemptyset(&Set);
+	sigaddset(&Set, SIGALRM);
+	sigprocmask(SIG_BLOCK, &Set, &OldSet);
+
+	size_t Done = 0;
+
+	while (Done < len)
+	{
+		ssize_t n = ::write(1, buf + Done, len - Done);
+
+		if (n <= 0)
+			break;
+
+		Done += n;
+	}
+
+	sigprocmask(SIG_SETMASK, &OldSet, NULL);
+
+	return(Done);
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+	char ch = (char)c;
+
+	return(WriteOut(&ch, 1));
+}
+
+size_t HardwareSerial::write(const char *str)
+{
+	return(WriteOut(str, strlen(str)));
+}
+
+size_t HardwareSerial::print(const char *str)
+{
+	return(write(str));
+}
+
+size_t HardwareSerial::print(char c)
+{
+	return(write((uint8_t)c));
+}
+
+size_t HardwareSerial::print(unsigned char n, int base)
+{
+	return(print((unsigned long)n, base));
+}
+
+size_t HardwareSerial::print(int n, int base)
+{
+	return(print((long)n, base));
+}
+
+size_t HardwareSerial::print(unsigned int n, int base)
+{
+	return(print((unsigned long)n, base));
+}
+
+size_t HardwareSerial::print(long n, int base)
+{
+	if (base == DEC && n < 0)
+		return(write((uint8_t)'-') + print((unsigned long)-n, base));
+
+	return(print((unsigned long)n, base));
+}
+
+size_t HardwareSerial::print(unsigned long n, int base)
+{
+	char	buf[8 * sizeof(long) + 1];
+	char	*p = &buf[sizeof(buf) - 1];
+
+	if (base < 2)
+		base = DEC;
+
+	*p = '\0';
+
+	do
+	{
+		unsigned digit = n % base;
+
+		n /= base;
+
+		*--p = (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+	} while (n != 0);
+
+	return(write(p));
+}
+
+size_t HardwareSerial::print(double n, int digits)
+{
+	char	buf[64];
+
+	snprintf(buf, sizeof(buf), "%.*f", digits, n);
+
+	return(write(buf));
+}
+
+size_t HardwareSerial::println()
+{
+	return(write("\r\n"));
+}
+
+size_t HardwareSerial::println(const char *str)
+{
+	return(print(str) + println());
+}
+
+size_t HardwareSerial::println(char c)
+{
+	return(print(c) + println());
+}
+
+size_t HardwareSerial::println(unsigned char n, int base)
+{
+	return(print(n, base) + println());
+}
+
+size_t HardwareSerial::println(int n, int base)
+{
+	return(print(n, base) + println());
+}
+
+size_t HardwareSerial::println(unsigned int n, int base)
+{
+	return(print(n, base) + println());
+}
+
+size_t HardwareSerial::println(long n, int base)
+{
+	return(print(n, base) + println());
+}
+
+size_t HardwareSerial::println(unsigned long n, int base)
+{
+	return(print(n, base) + println());
+}
+
+size_t HardwareSerial::println(double n, int digits)
+{
+	return(print(n, digits) + println());
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	main: run setup() and loop() on the emulated RAM STACK
+//
+////////////////////////////////////////////////////////////////////////////////////
+static ucontext_t	MainContext;
+static ucontext_t	ArduinoContext;
+
+static void ArduinoMain()
+{
+	setup();
+
+	for (;;)
+		loop();
+}
+
+int main()
+{
+	setvbuf(stdout, NULL, _IONBF, 0);
+
+	getcontext(&ArduinoContext);
+
+	ArduinoContext.uc_stack.ss_sp = Ram;
+	ArduinoContext.uc_stack.ss_size = __ram_end - __ram_start;
+	ArduinoContext.uc_link = &MainContext;
+
+	makecontext(&ArduinoContext, ArduinoMain, 0);
+
+	swapcontext(&MainContext, &ArduinoContext);
+
+	return(0);
+}
+
+////////////////////// EOF
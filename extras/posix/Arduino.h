@@ -0,0 +1,143 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: Arduino.h (Linux host)
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////
+//
+// Minimal Arduino "core" used to build uMT and its examples as a Linux executable.
+// Only the subset of the Arduino API used by uMT and by the examples is provided.
+//
+// The Arduino loop() runs on a private "RAM" area (RAMSTART-RAMEND) so that
+// uMT can manage TID 1 stack exactly as on the boards.
+//
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+#define HIGH			0x1
+#define LOW				0x0
+
+#define INPUT			0x0
+#define OUTPUT			0x1
+#define INPUT_PULLUP	0x2
+
+#define LED_BUILTIN		13
+
+#define DEC				10
+#define HEX				16
+#define OCT				8
+#define BIN				2
+
+
+// No separate FLASH address space on the host
+typedef char __FlashStringHelper;
+#define F(string_literal)		(string_literal)
+#define PROGMEM
+#define PSTR(s)					(s)
+#define pgm_read_byte(addr)		(*(const uint8_t *)(addr))
+#define pgm_read_word(addr)		(*(const uint16_t *)(addr))
+#define pgm_read_dword(addr)	(*(const uint32_t *)(addr))
+
+
+// Emulated RAM: the Arduino loop() stack lives in [RAMSTART, RAMEND]
+extern uintptr_t	__ram_start;
+extern uintptr_t	__ram_end;
+
+#define RAMSTART	(__ram_start)
+#define RAMEND		(__ram_end)
+
+
+unsigned long	millis();
+unsigned long	micros();
+void			delay(unsigned long ms);
+void			delayMicroseconds(unsigned int us);
+
+void			pinMode(uint8_t pin, uint8_t mode);
+void			digitalWrite(uint8_t pin, uint8_t val);
+int				digitalRead(uint8_t pin);
+
+void			noInterrupts();
+void			interrupts();
+
+long			random(long howbig);
+long			random(long howsmall, long howbig);
+void			randomSeed(unsigned long seed);
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	Serial: written to the standard output
+//
+////////////////////////////////////////////////////////////////////////////////////
+class HardwareSerial
+{
+public:
+	void	begin(unsigned long) {};
+	void	end() {};
+	void	flush() {};
+	int		available() { return(0); };
+	int		read() { return(-1); };
+
+	size_t	write(uint8_t c);
+	size_t	write(const char *str);
+
+	size_t	print(const char *str);
+	size_t	print(char c);
+	size_t	print(unsigned char n, int base = DEC);
+	size_t	print(int n, int base = DEC);
+	size_t	print(unsigned int n, int base = DEC);
+	size_t	print(long n, int base = DEC);
+	size_t	print(unsigned long n, int base = DEC);
+	size_t	print(double n, int digits = 2);
+
+	size_t	println();
+	size_t	println(const char *str);
+	size_t	println(char c);
+	size_t	println(unsigned char n, int base = DEC);
+	size_t	println(int n, int base = DEC);
+	size_t	println(unsigned int n, int base = DEC);
+	size_t	println(long n, int base = DEC);
+	size_t	println(unsigned long n, int base = DEC);
+	size_t	println(double n, int digits = 2);
+
+	operator bool() { return(true); };
+};
+
+extern HardwareSerial Serial;
+
+
+// Provided by the sketch
+extern void setup();
+extern void loop();
+
+#endif
+
+////////////////////// EOF
@@ -0,0 +1,26 @@
+#!/bin/sh
+#
+# Build one uMT example as a Linux host executable.
+#
+#   usage: extras/posix/build.sh examples/Test06_YieldSpeed [output]
+#
+# Run it from the library root directory. CXX and CXXFLAGS are honoured.
+#
+set -e
+
+EXAMPLE=${1:?usage: $0 <example directory> [output]}
+NAME=$(basename "$EXAMPLE")
+OUT=${2:-$NAME}
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+# Arduino sketches are .ino files: compile them as C++
+for f in "$EXAMPLE"/*.ino; do
+	[ -f "$f" ] && cp "$f" "$TMP/$(basename "$f" .ino).cpp"
+done
+for f in "$EXAMPLE"/*.cpp "$EXAMPLE"/*.h; do
+	[ -f "$f" ] && cp "$f" "$TMP/"
+done
+
+${CXX:-g++} ${CXXFLAGS:--O2 -g} -Wall -Wextra -I extras/posix -I src -I "$TMP" \
+	extras/posix/*.cpp src/*.cpp "$TMP"/*.cpp -o "$OUT"
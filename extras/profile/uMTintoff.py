@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+#
+# uMTintoff.py - interrupts-off windows from a uMT Kn_IntOffDump() capture
+#
+# Usage: uMTintoff.py firmware.elf serial.log [--nm NM]
+#
+# Any text before "uMT-IOFF BEGIN" and after "uMT-IOFF END" is ignored, so the
+# whole Serial log can be given. The call sites of isr_Kn_IntLock() are mapped to
+# functions with the symbol table of the ELF (use --nm arm-none-eabi-nm or avr-nm
+# for the boards).
+#
+
+import argparse
+import sys
+
+from uMTprofile import ANCHOR, lookup, read_symbols
+
+
+def read_dump(lines):
+	header = None
+	sites = []
+	hist = []
+
+	for line in lines:
+		line = line.strip()
+
+		if line.startswith("uMT-IOFF BEGIN"):
+			fields = line.split()
+			header = {"windows": int(fields[2]), "ticks_per_us": int(fields[3]),
+				"anchor": int(fields[4], 16)}
+			sites = []
+			hist = []
+		elif line.startswith("uMT-IOFF END"):
+			break
+		elif header is not None:
+			fields = line.split()
+			if len(fields) == 4 and fields[0] == "SITE":
+				sites.append((int(fields[1], 16), int(fields[2]), int(fields[3])))
+			elif len(fields) == 3 and fields[0] == "HIST":
+				hist.append((int(fields[1]), int(fields[2])))
+
+	if header is None:
+		sys.exit("uMTintoff: no uMT-IOFF BEGIN line found")
+
+	return header, sites, hist
+
+
+def main():
+	parser = argparse.ArgumentParser(description="uMT interrupts-off windows")
+	parser.add_argument("elf")
+	parser.add_argument("log")
+	parser.add_argument("--nm", default="nm", help="nm of the target toolchain")
+	args = parser.parse_args()
+
+	with open(args.log, errors="replace") as f:
+		header, sites, hist = read_dump(f)
+
+	symbols = read_symbols(args.elf, args.nm)
+	starts = [s[0] for s in symbols]
+
+	# Relocation (PIE on LINUX): the dump carries the run time address of IdleLoop()
+	offset = 0
+	for start, size, name in symbols:
+		if name == ANCHOR:
+			offset = (header["anchor"] & ~1) - start
+			break
+
+	us = float(max(header["ticks_per_us"], 1))
+
+	print("Windows %d" % header["windows"])
+	print("\n   max us  windows  caller of isr_Kn_IntLock()")
+
+	for site, max_ticks, count in sorted(sites, key=lambda item: -item[1]):
+		# The site is a return address: look up the call instruction
+		print("  %7.1f  %7d  %s" % (max_ticks / us, count, lookup(symbols, starts, site - offset - 1)))
+
+	print("\n         us range  windows")
+
+	for bucket, count in hist:
+		low = (1 << bucket) if bucket > 0 else 0
+		print("  %7.1f-%-7.1f  %7d" % (low / us, ((2 << bucket) - 1) / us, count))
+
+
+if __name__ == "__main__":
+	main()
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+#
+# uMTprofile.py - per-task flat profile from a uMT Kn_ProfilerDump() capture
+#
+# Usage: uMTprofile.py firmware.elf serial.log [--nm NM] [--top N]
+#
+# Any text before "uMT-PROF BEGIN" and after "uMT-PROF END" is ignored, so the
+# whole Serial log can be given. The sampled PCs are mapped to functions with the
+# symbol table of the ELF (use --nm arm-none-eabi-nm or avr-nm for the boards).
+#
+
+import argparse
+import bisect
+import subprocess
+import sys
+from collections import defaultdict
+
+ANCHOR = "uMT::IdleLoop()"
+
+
+def read_dump(lines):
+	header = None
+	samples = []
+
+	for line in lines:
+		line = line.strip()
+
+		if line.startswith("uMT-PROF BEGIN"):
+			fields = line.split()
+			header = {"samples": int(fields[2]), "lost": int(fields[3]),
+				"divider": int(fields[4]), "anchor": int(fields[5], 16)}
+			samples = []
+		elif line.startswith("uMT-PROF END"):
+			break
+		elif header is not None:
+			fields = line.split()
+			if len(fields) == 3:
+				samples.append([int(f, 16) for f in fields])
+
+	if header is None:
+		sys.exit("uMTprofile: no uMT-PROF BEGIN line found")
+
+	return header, samples
+
+
+def read_symbols(elf, nm):
+	out = subprocess.run([nm, "-C", "-n", "-S", "--defined-only", elf],
+		stdout=subprocess.PIPE, universal_newlines=True, check=True).stdout
+
+	symbols = []
+	for line in out.splitlines():
+		fields = line.split(None, 3)
+		if len(fields) == 4 and fields[2] in "TtWw":
+			# Thumb functions have bit 0 set
+			symbols.append((int(fields[0], 16) & ~1, int(fields[1], 16), fields[3]))
+
+	symbols.sort()
+	return symbols
+
+
+def lookup(symbols, starts, addr):
+	idx = bisect.bisect_right(starts, addr) - 1
+
+	if idx >= 0:
+		start, size, name = symbols[idx]
+		if size == 0 or addr < start + size:
+			return name
+
+	return "?? 0x%x" % addr
+
+
+def main():
+	parser = argparse.ArgumentParser(description="uMT PC sampling profile")
+	parser.add_argument("elf")
+	parser.add_argument("log")
+	parser.add_argument("--nm", default="nm", help="nm of the target toolchain")
+	parser.add_argument("--top", type=int, default=20, help="functions listed per task")
+	args = parser.parse_args()
+
+	with open(args.log, errors="replace") as f:
+		header, samples = read_dump(f)
+
+	symbols = read_symbols(args.elf, args.nm)
+	starts = [s[0] for s in symbols]
+
+	# Relocation (PIE on LINUX): the dump carries the run time address of IdleLoop()
+	offset = 0
+	for start, size, name in symbols:
+		if name == ANCHOR:
+			offset = (header["anchor"] & ~1) - start
+			break
+
+	per_task = defaultdict(lambda: defaultdict(int))
+	total = 0
+
+	for pc, tid, count in samples:
+		per_task[tid][lookup(symbols, starts, pc - offset)] += count
+		total += count
+
+	print("Samples %d (every %d ticks), lost %d" % (header["samples"], header["divider"], header["lost"]))
+
+	for tid in sorted(per_task):
+		funcs = per_task[tid]
+		task_total = sum(funcs.values())
+
+		print("\nTask %d: %d samples (%.1f%%)" % (tid, task_total, 100.0 * task_total / max(total, 1)))
+		print("   %%task  %%total  samples  function")
+
+		for name, count in sorted(funcs.items(), key=lambda item: -item[1])[:args.top]:
+			print("  %6.1f  %6.1f  %7d  %s" % (100.0 * count / task_total, 100.0 * count / max(total, 1), count, name))
+
+
+if __name__ == "__main__":
+	main()
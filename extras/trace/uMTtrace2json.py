@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+#
+# uMTtrace2json.py - convert a uMT Kn_TraceDump() capture to Chrome trace / Perfetto JSON
+#
+# Usage: uMTtrace2json.py serial.log [trace.json]
+#
+# Any text before "uMT-TRACE BEGIN" and after "uMT-TRACE END" is ignored, so the
+# whole Serial log can be given. Open the result in chrome://tracing or ui.perfetto.dev.
+#
+
+import json
+import sys
+
+TR_SWITCH, TR_READY, TR_BLOCK, TR_EV_SEND, TR_SM_CLAIM, TR_SM_RELEASE, \
+	TR_TIMER, TR_ISR_ENTER, TR_ISR_EXIT, TR_USER = range(1, 11)
+
+STATUS = ["S_UNUSED", "S_CREATED", "S_READY", "S_RUNNING", "S_SBLOCKED",
+	"S_EBLOCKED", "S_TBLOCKED", "S_SUSPENDED", "S_ZOMBIE"]
+
+ISR_TID_BASE = 1000		# ISR tracks, after the tasks
+
+
+def status(value):
+	return STATUS[value] if value < len(STATUS) else str(value)
+
+
+def read_dump(lines):
+	records = None
+	ticks_per_us = 1
+
+	for line in lines:
+		line = line.strip()
+
+		if line.startswith("uMT-TRACE BEGIN"):
+			ticks_per_us = int(line.split()[2]) or 1
+			records = []
+		elif line.startswith("uMT-TRACE END"):
+			break
+		elif records is not None:
+			fields = line.split()
+			if len(fields) == 4:
+				records.append([int(f, 16) for f in fields])
+
+	if records is None:
+		sys.exit("uMTtrace2json: no uMT-TRACE BEGIN line found")
+
+	# Times are 32 bits: unwrap them
+	base = 0
+	last = None
+	for rec in records:
+		if last is not None and rec[0] < last:
+			base += 1 << 32
+		last = rec[0]
+		rec[0] = round((rec[0] + base) / float(ticks_per_us), 3)
+
+	return records
+
+
+def convert(records):
+	events = []
+	tids = set()
+	running = None
+	started = 0.0
+	t0 = records[0][0] if records else 0.0
+
+	def instant(ts, tid, name, args):
+		events.append({"name": name, "ph": "i", "s": "t", "ts": ts, "pid": 1, "tid": tid, "args": args})
+
+	for time, rtype, obj, arg in records:
+		ts = round(time - t0, 3)
+
+		if rtype == TR_SWITCH:
+			if running is not None:
+				events.append({"name": "Task %d" % running, "ph": "X", "ts": started,
+					"dur": round(ts - started, 3), "pid": 1, "tid": running})
+			running = obj
+			started = ts
+			tids.add(obj)
+		elif rtype == TR_READY:
+			tids.add(obj)
+			instant(ts, obj, "READY", {"from": status(arg)})
+		elif rtype == TR_BLOCK:
+			tids.add(obj)
+			instant(ts, obj, "BLOCK", {"status": status(arg)})
+		elif rtype == TR_EV_SEND:
+			instant(ts, running or 0, "Ev_Send", {"to": obj, "event": hex(arg)})
+		elif rtype == TR_SM_CLAIM:
+			instant(ts, running or 0, "Sm_Claim", {"sid": obj, "value": arg})
+		elif rtype == TR_SM_RELEASE:
+			instant(ts, running or 0, "Sm_Release", {"sid": obj, "value": arg})
+		elif rtype == TR_TIMER:
+			instant(ts, obj, "Timer", {"flags": hex(arg)})
+		elif rtype == TR_ISR_ENTER:
+			tids.add(ISR_TID_BASE + obj)
+			events.append({"name": "ISR %d" % obj, "ph": "B", "ts": ts, "pid": 1, "tid": ISR_TID_BASE + obj})
+		elif rtype == TR_ISR_EXIT:
+			tids.add(ISR_TID_BASE + obj)
+			events.append({"name": "ISR %d" % obj, "ph": "E", "ts": ts, "pid": 1, "tid": ISR_TID_BASE + obj})
+		elif rtype == TR_USER:
+			instant(ts, running or 0, "User %d" % obj, {"arg": arg})
+
+	if running is not None and records:
+		events.append({"name": "Task %d" % running, "ph": "X", "ts": started,
+			"dur": round(records[-1][0] - t0 - started, 3), "pid": 1, "tid": running})
+
+	events.append({"name": "process_name", "ph": "M", "pid": 1, "args": {"name": "uMT"}})
+	for tid in sorted(tids):
+		if tid >= ISR_TID_BASE:
+			name = "ISR %d" % (tid - ISR_TID_BASE)
+		else:
+			name = "IDLE" if tid == 0 else "Task %d" % tid
+		events.append({"name": "thread_name", "ph": "M", "pid": 1, "tid": tid, "args": {"name": name}})
+
+	return {"traceEvents": events, "displayTimeUnit": "ns"}
+
+
+def main():
+	if len(sys.argv) < 2:
+		sys.exit("Usage: uMTtrace2json.py serial.log [trace.json]")
+
+	with open(sys.argv[1], errors="replace") as f:
+		trace = convert(read_dump(f))
+
+	if len(sys.argv) > 2:
+		with open(sys.argv[2], "w") as f:
+			json.dump(trace, f)
+	else:
+		json.dump(trace, sys.stdout)
+
+
+if __name__ == "__main__":
+	main()
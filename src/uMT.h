@@ -52,6 +52,7 @@
 // 11)	TIMERS are numbered the same as TASK ID for TIMER_TASKS, "index+uMT_MAX_TASK_NUM" for AGENT times.
 //		AGENT timers can be more than TASKS to increase flexibility in delivering future Events.
 // 12)	When called from ISR, uMT routine must NOT preempt the calling task but "NeedResched" is set for TimeTick further processing
+//		With uMT_USE_ISR_PREEMPTION a task switch is also requested for the return from interrupt (PendSwitch())
 // 12)	When called from ISRp, uMT routine can preempt the calling task
 // 13)	To support Tk_DeleteTask() (suicide...), a dedicated STACK must be allocated in Suspend() for the Kernel.
 //		The size of this task is critical: it cannot be too small (otherwise there is the risk to CRASH the kernel)
@@ -60,6 +61,8 @@
 //		SAM: 256 bytes (defined in "uMT_SAM_SysTick.cpp")
 //		Remember that Suspend() is executed with INTS disabled as well as the rest of the Kernel until 
 //		next task switching, so this STACK will only be needed to accomodate Kernel needs.
+//		SAM: the private STACK is ONLY used for a suicide. Any other switch runs the scheduler
+//		in PendSV on the stack of the outgoing task (see uMT_SwitchContext()).
 //
 //////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -122,6 +125,7 @@
 #define uMT_NOWAIT		0x02			// Do not wait, E_WOULD_BLOCK returned
 #define uMT_ANY			0x10			// ev_receive, any event
 #define uMT_ALL			0x20			// ev_receive, any event
+#define uMT_CLEAR		0x40			// eg_wait, clear the requested flags on exit
 
 typedef uint8_t			uMToptions_t;		// 8 bits - EVENT flags
 
@@ -135,7 +139,7 @@ typedef uint8_t			uMToptions_t;		// 8 bits - EVENT flags
 ////////////////////////////////////////////////////////////////////////////////////
 
 #if  defined(ARDUINO_ARCH_SAM)  || defined(ARDUINO_ARCH_SAMD) || defined(WIN32)
-extern "C" { unsigned int sysTickHook(); void pendSVHook();};
+extern "C" { unsigned int sysTickHook(); void pendSVHook(); StackPtr_t uMT_SwitchContext(StackPtr_t SP);};
 
 #define uMTmalloc	malloc
 #define uMTfree		free
@@ -155,10 +159,21 @@ extern void *uMTrealloc(void *ptr, size_t len);
 ////////////////////////////////////////////////////////////////////////////////////
 
 #include "uMTextendedTime.h"
+#include "uMTcpuTime.h"
+#include "uMTtrace.h"
+#include "uMTprofiler.h"
+#include "uMTintOff.h"
 #include "uMTtimer.h"
 #include "uMTtask.h"
 #include "uMTqueue.h"
 #include "uMTsemaphores.h"
+#include "uMTmutex.h"
+#include "uMTpool.h"
+#include "uMTmsgQueue.h"
+#include "uMTeventGroup.h"
+#include "uMTrwLock.h"
+#include "uMTsnapshot.h"
+#include "uMTdpc.h"
 
 
 class uMT
@@ -170,12 +185,17 @@ class uMT
 	friend void KLL_MainLoop();			// Test0_KernelLowLevel.cpp
 
 	friend unsigned uMTdoTicksWork();	// uMTarduinoCommon.cpp
+	friend unsigned uMTcheckTicks();	// uMTarduinoCommon.cpp
 
 	friend void uMT_SystemTicks();		// uMT_AVR_SysTick.cpp
+	friend void uMT_IsrSwitch();		// uMT_AVR_SysTick.cpp, uMT_POSIX_SysTick.cpp
 	friend void pendSVHook();			// uMT_SAM_SysTick.cpp
 	friend unsigned int sysTickHook();	// uMT_SAM_SysTick.cpp
+	friend StackPtr_t uMT_SwitchContext(StackPtr_t SP);	// uMT_SAM_SysTick.cpp
+	friend void uMT_MpuFault();			// uMT_SAM_SysDep.cpp
 
 	friend class uMTtaskQueue;
+	friend class uMTreadyQueue;
 
 private:
 
@@ -190,8 +210,11 @@ volatile uint16_t TimeSlice;			// How many ticks the current task can run
 	uMTextendedTime	msTickCounter;	// Ticks counter in milliSeconds
 
 #if	uMT_USE_TASK_STATISTICS>=2
-	Timer_t			usUserStartTime;		// Set to micros() when task is restarted
-	uMTextendedTime	usKernelRunningTime;	// Kernel Running Time in micro seconds
+	CpuTicks_t		CpuUserStartTime;		// uMT_CpuTicks() when the task was resumed
+	CpuTicks_t		CpuIsrSlice;			// ISR time since the task was resumed
+	uMTextendedTime	CpuKernelTime;			// Kernel Running Time in CPU ticks
+	uMTextendedTime	CpuIsrTime;				// System Tick ISR Time in CPU ticks
+	uMTextendedTime	CpuTotalTime;			// Tasks + Kernel + ISR Time in CPU ticks
 #endif
 
 Errno_t		doStart();
@@ -208,6 +231,7 @@ Errno_t		doStart();
 	//////////////////////////////////////////////////////////////////////////////////////////
 	void		Tk_RemoveFromAnyQueue(uTask *pTask);	// Remove TASK from any QUEUE
 	void		ReadyTask(uTask *pTask);		// Make a task ready and insert in the Ready list
+	void		Tk_ChangePriority(uTask *pTask, TaskPrio_t npriority);	// Set Priority and reorder its queue
 
 	//////////////////////////////////////////////////////////////////////////////////////////
 	// INTERNAL: Preemption
@@ -220,6 +244,16 @@ volatile Bool_t		NeedResched;		// Set if a Reschedule is needed
 	// If reschedule is required, suspend me...
 inline	void		Check4NeedReschedule() { if (NeedResched && NoPreempt == FALSE) Suspend(); };
 
+#if uMT_USE_ISR_PREEMPTION==1
+	void		PendSwitch();		// Request a task switch on return from interrupt (port specific)
+
+	// From ISR, if reschedule is required, switch task when the interrupt returns...
+inline	void		Check4IsrReschedule() { if (NeedResched && NoPreempt == FALSE) PendSwitch(); };
+#else
+	// ... or wait for the next System Tick
+inline	void		Check4IsrReschedule() { };
+#endif
+
 
 
 
@@ -256,6 +290,10 @@ volatile Bool_t	NoPreempt;			// If set, current task cannot be pre-empted
 	// INTERNAL: SYSTEM SPECIFIC
 	//////////////////////////////////////////////////////////////////////////////////////////
 	void		SetupSysTicks();
+#if uMT_USE_MPU_STACK_GUARD==1
+	void		MpuStackGuard(uTask *pTask);	// MPU guard region at the bottom of pTask stack (NULL: none)
+#endif
+	uint32_t	TickInterrupts;		// Number of System Tick interrupts
 	void		NewStackReschedule();	// Switch to a private STACK and call Reschedule()
 	void		NewStackReborn();	// Switch a private STACK and call Reborn()
 	StackPtr_t	NewTask(StackPtr_t TaskStackBase, StackSize_t StackSize, void (*TaskStartAddr)(), void (*BadExit)());
@@ -263,6 +301,10 @@ volatile Bool_t	NoPreempt;			// If set, current task cannot be pre-empted
 	void		Suspend();
 	void		doDeleteTask(uTask *pTask);
 
+#if defined(uMT_POSIX)
+static	void		KernelEntry();		// Entry point of the private Kernel context (uMT_POSIX_SysDep.cpp)
+#endif
+
 
 //#ifndef WIN32		// Arduino
 
@@ -279,7 +321,7 @@ void	CheckTimerMagic(uTimer *timer, const __FlashStringHelper *String);
 	// INTERNAL: Tasks
 	//////////////////////////////////////////////////////////////////////////////////////////
 	uint8_t		ActiveTaskNo;		// Number of Active tasks, excluding IDLE
-	uMTtaskQueue ReadyQueue;		// Ready QUEUE
+	uMTreadyQueue ReadyQueue;		// Ready QUEUE (one list per priority)
 	uTask		*UnusedQueue;		// Pointer to the UNUSED task list (no TotQueue counter)
 	uTask		*Running;			// Pointer to the running task
 	uTask		*LastRunning;		// Pointer to the running task
@@ -292,13 +334,23 @@ void	CheckTimerMagic(uTimer *timer, const __FlashStringHelper *String);
 #endif
 
 static void		IdleLoop();				// Idle routine
-	void		Reschedule();			// Find next RUNNING task
+
+#if uMT_USE_TICKLESS==1
+	uint32_t	TicksSkipped;			// System Ticks not signalled while sleeping in IDLE
+	void		TicklessIdle();			// Sleep up to the next deadline
+	Timer_t		isr_Kn_TicklessSleep(Timer_t Ticks);	// SYSTEM SPECIFIC: one-shot System Tick and sleep
+#endif
+	void		Reschedule();			// Find next RUNNING task and resume it
+	void		doReschedule();			// Find next RUNNING task
 	void		Reborn();				// Restart current task
 	void 		SetupTaskStacks();		// Setting up tasks' stacks
 	void 		SetupMallocLimits();	// Setup MALLOC() limitis
 	void 		SetupStackGuard(uTask *	pTask);		// Setup stack guard data
 	Errno_t		doGetTaskInfo(uTask *pTask, uMTtaskInfo &Info);
 	StackSize_t	MaxUsedStack(uTask *pTask);
+#if uMT_USE_STACK_CHECK==1
+	void		StackCheck(uTask *pTask);					// High-water mark and overflow check at task switch
+#endif
 
 #if uMT_USE_RESTARTTASK==1
 		Errno_t	doReStartTask(uTask *pTask);
@@ -339,13 +391,127 @@ inline Bool_t	SemId_Check(SemId_t Sid) { return((Sid >= kernelCfg.Semaphores_Num
 #endif
 
 
+#if uMT_USE_MUTEX==1
+	//////////////////////////////////////////////////////////////////////////////////////////
+	// INTERNAL: Mutex
+	//////////////////////////////////////////////////////////////////////////////////////////
+#if uMT_ALLOCATION_TYPE==uMT_FIXED_STATIC
+	uMTmutex	MxList[uMT_DEFAULT_MUTEX_NUM];
+#else
+	uMTmutex	*MxList;
+#endif
+
+inline Bool_t	MxId_Check(MutexId_t Mxid) { return((Mxid >= kernelCfg.Mutexes_Num) ? FALSE : TRUE); };
+	void		MxGiveTo(uMTmutex *pMx, uTask *pTask);			// New owner
+	void		MxRelease(uMTmutex *pMx);						// Hand off to the first waiting task, if any
+	void		MxReleaseAll(uTask *pTask);						// Release all the Mutexes owned by pTask
+	TaskPrio_t	MxInheritedPrio(uTask *pTask);					// max(BasePriority, waiting tasks)
+	void		MxUpdatePrio(uTask *pTask);						// Apply inheritance along the owners chain
+#endif
+
+
+#if uMT_USE_POOLS==1
+	//////////////////////////////////////////////////////////////////////////////////////////
+	// INTERNAL: memory Pools
+	//////////////////////////////////////////////////////////////////////////////////////////
+#if uMT_ALLOCATION_TYPE==uMT_FIXED_STATIC
+	uMTpool		PlList[uMT_DEFAULT_POOL_NUM];
+	uint8_t		PlArea[uMT_DEFAULT_POOL_AREA_SIZE];
+#else
+	uMTpool		*PlList;
+	uint8_t		*PlArea;
+#endif
+	Cfg_data_t	PlAreaUsed;			// Bytes of the Pool area already assigned to Pools
+
+inline Bool_t	PlId_Check(PoolId_t Plid) { return((Plid >= kernelCfg.Pools_Num || PlList[Plid].Area == NULL) ? FALSE : TRUE); };
+#endif
+
+
+#if uMT_USE_MSGQUEUES==1
+	//////////////////////////////////////////////////////////////////////////////////////////
+	// INTERNAL: Message Queues
+	//////////////////////////////////////////////////////////////////////////////////////////
+#if uMT_ALLOCATION_TYPE==uMT_FIXED_STATIC
+	uMTmsgQueue	MqList[uMT_DEFAULT_MSGQ_NUM];
+#else
+	uMTmsgQueue	*MqList;
+#endif
+
+inline Bool_t	MqId_Check(MsgQueueId_t Mqid) { return((Mqid >= kernelCfg.MsgQueues_Num || MqList[Mqid].Buffer == NULL) ? FALSE : TRUE); };
+	Errno_t		doMq_Send(MsgQueueId_t Mqid, const void *pMsg, MsgSize_t Size, uMToptions_t Options, Timer_t timeout, Bool_t AllowPreemption);
+	Errno_t		doMq_Receive(MsgQueueId_t Mqid, void *pMsg, MsgSize_t Size, uMToptions_t Options, Timer_t timeout, Bool_t AllowPreemption);
+	Errno_t		MqWait(uMTtaskQueue *pWaitq, void *pMsg, Timer_t timeout, CpuStatusReg_t CpuFlags);	// Block in Send/Recv queue
+	void		MqWakeup(uMTtaskQueue *pWaitq);					// Make READY the first waiting task
+#endif
+
+
+#if uMT_USE_EVENTGROUPS==1
+	//////////////////////////////////////////////////////////////////////////////////////////
+	// INTERNAL: Event Groups
+	//////////////////////////////////////////////////////////////////////////////////////////
+#if uMT_ALLOCATION_TYPE==uMT_FIXED_STATIC
+	uMTeventGroup	EgList[uMT_DEFAULT_EVGRP_NUM];
+#else
+	uMTeventGroup	*EgList;
+#endif
+
+inline Bool_t	EgId_Check(EventGroupId_t Egid) { return((Egid >= kernelCfg.EventGroups_Num || EgList[Egid].Created == FALSE) ? FALSE : TRUE); };
+	Errno_t		doEg_Set(EventGroupId_t Egid, Event_t Event, Bool_t AllowPreemption);
+	Bool_t		EgVerified(Event_t Flags, uTask *pTask);
+#endif
+
+
+#if uMT_USE_RWLOCKS==1
+	//////////////////////////////////////////////////////////////////////////////////////////
+	// INTERNAL: Readers-writer locks
+	//////////////////////////////////////////////////////////////////////////////////////////
+#if uMT_ALLOCATION_TYPE==uMT_FIXED_STATIC
+	uMTrwLock	RwList[uMT_DEFAULT_RWLOCK_NUM];
+#else
+	uMTrwLock	*RwList;
+#endif
+
+inline Bool_t	RwId_Check(RwLockId_t Rwid) { return((Rwid >= kernelCfg.RwLocks_Num || RwList[Rwid].Created == FALSE) ? FALSE : TRUE); };
+	Errno_t		doRw_Lock(RwLockId_t Rwid, Bool_t Write, uMToptions_t Options, Timer_t timeout);
+	Errno_t		doRw_Unlock(RwLockId_t Rwid, Bool_t AllowPreemption);
+	void		RwWakeup(uMTrwLock *pRw);						// Grant the lock to the waiting tasks, if possible
+	void		RwReleaseAll(uTask *pTask);						// Release the write locks owned by pTask
+#endif
+
+
+#if uMT_USE_DPC==1
+	//////////////////////////////////////////////////////////////////////////////////////////
+	// INTERNAL: Deferred procedure calls
+	//////////////////////////////////////////////////////////////////////////////////////////
+	uMTdpcEntry	DpcQueue[uMT_DPC_QUEUE_SIZE];	// FIFO of deferred calls
+	uint8_t		DpcIn;				// Next entry to write
+	uint8_t		DpcOut;				// Next entry to run
+	uint8_t		DpcCount;			// Entries queued
+	uint8_t		DpcMaxCount;		// Highest DpcCount (high-water mark)
+	uint32_t	DpcPosted;			// Entries queued since Kn_Start()
+	uint32_t	DpcLost;			// Entries dropped on a full queue
+	TaskId_t	DpcTid;				// Service task
+
+	Errno_t		DpcStart();						// Create and start the service task
+static	void	DpcLoop();						// Service task
+	Errno_t		doDp_Post(DpcFunc_t Func, void *Arg, Bool_t AllowPreemption);
+#endif
+
+
 
 #if uMT_USE_TIMERS==1
 	//////////////////////////////////////////////////////////////////////////////////////////
 	// INTERNAL: Timers used for not blocked tasks
 	//////////////////////////////////////////////////////////////////////////////////////////
 	Bool_t		AlarmExpired;		// Set if an alarm is expired.
+#if uMT_USE_TIMER_WHEEL==1
+	uTimer		*WheelHead[uMT_WHEEL_SLOTS];	// Timer wheel slots, OVERFLOW and EXPIRED lists
+	uint32_t	WheelMap[uMT_WHEEL_LEVELS];		// Not empty slots, one bit per slot
+	uMTextendedTime	WheelTime;					// Next tick to be processed by the wheel
+	uMTextendedTime	WheelDeadline;				// Tick with wheel work due, checked by the System Tick
+#else
 	uTimer		*TimerQueue;		// Pointer to the Timer queue
+#endif
 	uTimer		*FreeTimerQueue;	// Pointer to the FREE Timer queue
 	uint8_t		TotTimerQueued;		// Total queued
 
@@ -356,13 +522,27 @@ inline Bool_t	SemId_Check(SemId_t Sid) { return((Sid >= kernelCfg.Semaphores_Num
 #endif
 
 	void		TimerQ_Insert(uTimer *pTimer);
+	void		TimerQ_Remove(uTimer *pTimer);
 	uTimer		*TimerQ_Pop();
+	Bool_t		TimerQ_AlarmDue();
+	Bool_t		TimerQ_isrAlarmDue();
+	Timer_t		TimerQ_NextDeadline();
+	uTimer		*TimerQ_Next(uTimer *pTimer);
 	void		TimerQ_Expired(uTimer *pTimer);
 	void		TimerQ_PushFree(uTimer *pTimer);
 	uTimer		*TimerQ_PopFree();
 	Errno_t		TimerQ_CancelTimer(uTimer *pTimer);
 	void		TimerQ_CancelAll(uTask *pTask);
 
+#if uMT_USE_TIMER_WHEEL==1
+	void		TimerW_Link(uTimer *pTimer, uint8_t Slot);
+	void		TimerW_Unlink(uTimer *pTimer);
+	void		TimerW_Place(uTimer *pTimer);
+	void		TimerW_Cascade(uint8_t Slot);
+	void		TimerW_Advance();
+	void		TimerW_SetDeadline();
+#endif
+
 	inline uTimer	*Tmid2TimerPtr(TimerId_t TmId)		// Return NULL if invalid TmId
 	{
 		// Is index in the range?
@@ -387,6 +567,49 @@ inline Bool_t	SemId_Check(SemId_t Sid) { return((Sid >= kernelCfg.Semaphores_Num
 	const __FlashStringHelper *EventFlag2String(uMToptions_t EventFlag);
 #endif
 
+#if uMT_USE_TRACE==1
+	//////////////////////////////////////////////////////////////////////////////////////////
+	// INTERNAL: Kernel trace
+	//////////////////////////////////////////////////////////////////////////////////////////
+	uMTtraceRec		TraceBuf[uMT_TRACE_SIZE];	// Ring buffer
+	uint16_t		TraceIn;					// Next record to write
+	uint16_t		TraceCount;					// Valid records
+	volatile Bool_t	TraceOn;					// Recording
+
+	void		TraceRecord(uint8_t Type, uint8_t Obj, uint16_t Arg);
+#endif
+
+#if uMT_USE_PROFILER==1
+	//////////////////////////////////////////////////////////////////////////////////////////
+	// INTERNAL: PC sampling profiler
+	//////////////////////////////////////////////////////////////////////////////////////////
+	uMTprofSlot		ProfTable[uMT_PROFILER_SIZE];	// Histogram (hash table)
+	uint32_t		ProfSamples;				// Samples taken
+	uint32_t		ProfLost;					// Samples without a free slot
+	uint16_t		ProfDivider;				// Sample every ... System Ticks
+	uint16_t		ProfTicks;					// System Ticks since the last sample
+	volatile Bool_t	ProfOn;						// Sampling
+#if defined(ARDUINO_ARCH_SAM) || defined(ARDUINO_ARCH_SAMD)
+	volatile Bool_t	ProfPending;				// Sample in the next PendSV
+#endif
+#endif
+
+#if uMT_USE_INTOFF_PROFILER==1
+	//////////////////////////////////////////////////////////////////////////////////////////
+	// INTERNAL: Interrupts off profiler
+	//////////////////////////////////////////////////////////////////////////////////////////
+	uMTintOffSite	IntOffTop[uMT_INTOFF_TOP];		// Longest windows, one per call site
+	uint32_t		IntOffHist[uMT_INTOFF_BUCKETS];	// Windows per log2(CPU ticks)
+	uint32_t		IntOffWindows;				// Windows measured
+	CpuTicks_t		IntOffStart;				// Open window: start time...
+	IntOffSite_t	IntOffSite;					// ... and call site (0 if none)
+	volatile Bool_t	IntOffOn;					// Measuring
+
+static	CpuStatusReg_t	IntLockRaw();			// Port specific isr_Kn_IntLock()
+static	void			IntUnlockRaw(CpuStatusReg_t Flags);	// Port specific isr_Kn_IntUnlock()
+	void		IntOffClose(CpuTicks_t Now);	// Record the open window, if any
+#endif
+
 
 	//////////////////////////////////////////////////////////////////////////////////////////
 	//////////////////////////////////////////////////////////////////////////////////////////
@@ -416,7 +639,7 @@ public:
 	};
 
 
-#if defined(ARDUINO_ARCH_SAM) || defined(ARDUINO_ARCH_SAMD) || defined(__AVR_ATmega2560__) || defined(WIN32)
+#if defined(ARDUINO_ARCH_SAM) || defined(ARDUINO_ARCH_SAMD) || defined(__AVR_ATmega2560__) || defined(WIN32) || defined(uMT_POSIX)
 	// WIN32 to force compilation
 	Errno_t		Kn_Start(uMTcfg &Cfg) { if (Inited == TRUE) return(E_ALREADY_INITED); kernelCfg = Cfg.rw; return(doStart()); };
 #else
@@ -454,21 +677,48 @@ StackPtr_t	Kn_GetSP();
 #define	Kn_GetSP() (StackPtr_t)SP
 #endif
 
-#if defined(ARDUINO_ARCH_SAM) || defined(ARDUINO_ARCH_SAMD)
+#if defined(ARDUINO_ARCH_SAM) || defined(ARDUINO_ARCH_SAMD) || defined(uMT_POSIX)
 static	StackPtr_t	Kn_GetSP();
 #endif
 #endif
 
 		Errno_t	Kn_PrintInternals(Bool_t PrintMaxUsedStack = FALSE);	// Print internals structure to Serial
+		Errno_t	Kn_GetSnapshot(uMTsnapshot &Snap, uMTtaskSnapshot *pTasks, unsigned int MaxTasks);	// Copy kernel and task counters
+		Errno_t	Kn_PrintSnapshot();						// Print kernel and task counters to Serial, preemption enabled
 
 		Errno_t	Kn_GetConfiguration(uMTcfg &pCfg);		// Returns internal configuration
 		Errno_t	Kn_PrintConfiguration(uMTcfg &pCfg);	// Print configuration to Serial
 
+#if uMT_USE_TRACE==1
+		Errno_t	Kn_TraceStart();						// Clear the trace buffer and start recording
+		Errno_t	Kn_TraceStop();
+		Errno_t	Kn_TraceDump();							// Stop recording and print the trace to Serial
+
+inline	void	isr_Kn_TraceIsrEnter(uint8_t Irq) {TraceRecord(TR_ISR_ENTER, Irq, 0);};
+inline	void	isr_Kn_TraceIsrExit(uint8_t Irq) {TraceRecord(TR_ISR_EXIT, Irq, 0);};
+inline	void	isr_Kn_TraceUser(uint8_t Code, uint16_t Arg) {TraceRecord(TR_USER, Code, Arg);};
+#endif
+
+#if uMT_USE_PROFILER==1
+		Errno_t	Kn_ProfilerStart(uint16_t Divider = 1);	// Clear the histogram and sample every Divider System Ticks
+		Errno_t	Kn_ProfilerStop();
+		Errno_t	Kn_ProfilerDump();						// Stop sampling and print the histogram to Serial
+
+		void	isr_Kn_ProfileSample(ProfPC_t PC);		// Count PC for the Running task (INTS disabled)
+#endif
+
+#if uMT_USE_INTOFF_PROFILER==1
+		Errno_t	Kn_IntOffStart();						// Clear the statistics and start measuring
+		Errno_t	Kn_IntOffStop();
+		Errno_t	Kn_IntOffDump();						// Stop measuring and print the longest windows to Serial
+#endif
+
 static 	CpuStatusReg_t	isr_Kn_IntLock();
 static 	void			isr_Kn_IntUnlock(CpuStatusReg_t Flags);
 
 	// Generic KERNEL, can be called from ISR
 inline Timer_t	isr_Kn_GetKernelTick() { return (msTickCounter.Low); };
+inline uint32_t	isr_Kn_GetTickInterrupts() { return (TickInterrupts); };
 
 	////////////////////////////////////////////////////////
 	// TASK management
@@ -518,7 +768,7 @@ inline	Errno_t	Tk_GetTaskInfo(uMTtaskInfo &Info) { return(doGetTaskInfo(Running,
 	////////////////////////////////////////////////////////
 #if uMT_USE_TIMERS==1
 		Errno_t	Sm_Claim(SemId_t Sid, uMToptions_t Options, Timer_t timeout=(Timer_t)0);
-inline	Errno_t	isr_Sm_Claim(SemId_t Sid) {Sm_Claim(Sid, uMT_NOWAIT, 0); };		// uMT_NOWAIT!!!!!
+inline	Errno_t	isr_Sm_Claim(SemId_t Sid) {return(Sm_Claim(Sid, uMT_NOWAIT, 0)); };		// uMT_NOWAIT!!!!!
 #else
 	Errno_t	Sm_Claim(SemId_t Sid, uMToptions_t Options);
 #endif
@@ -530,6 +780,117 @@ inline	Errno_t	isr_p_Sm_Release(SemId_t Sid) {return(doSm_Release(Sid, TRUE)); }
 
 
 		Errno_t	Sm_SetQueueMode(SemId_t Sid, QueueMode_t Mode);
+		Errno_t	Sm_SetHandoff(SemId_t Sid, Bool_t Handoff);
+		Errno_t	Sm_GetInfo(SemId_t Sid, uMTsemInfo &Info, Bool_t Reset=FALSE);
+#endif
+
+
+#if uMT_USE_MUTEX==1
+	////////////////////////////////////////////////////////
+	// MUTEX management (cannot be called from ISR)
+	////////////////////////////////////////////////////////
+#if uMT_USE_TIMERS==1
+		Errno_t	Mx_Lock(MutexId_t Mxid, uMToptions_t Options, Timer_t timeout=(Timer_t)0);
+#else
+		Errno_t	Mx_Lock(MutexId_t Mxid, uMToptions_t Options);
+#endif
+		Errno_t	Mx_Unlock(MutexId_t Mxid);
+#endif
+
+
+#if uMT_USE_POOLS==1
+	////////////////////////////////////////////////////////
+	// memory POOL management (Pl_Alloc() & Pl_Free() can be called from ISR)
+	////////////////////////////////////////////////////////
+		Errno_t	Pl_Create(PoolSize_t BlockSize, PoolSize_t BlockNum, PoolId_t &Plid);
+		Errno_t	Pl_Alloc(PoolId_t Plid, void *&pBlock);
+		Errno_t	Pl_Free(PoolId_t Plid, void *pBlock);
+		Errno_t	Pl_GetInfo(PoolId_t Plid, uMTpoolInfo &Info);
+
+inline	Errno_t	isr_Pl_Alloc(PoolId_t Plid, void *&pBlock) {return(Pl_Alloc(Plid, pBlock)); };
+inline	Errno_t	isr_Pl_Free(PoolId_t Plid, void *pBlock) {return(Pl_Free(Plid, pBlock)); };
+#endif
+
+
+#if uMT_USE_MSGQUEUES==1
+	////////////////////////////////////////////////////////
+	// MESSAGE QUEUE management
+	////////////////////////////////////////////////////////
+		Errno_t	Mq_Create(MsgSize_t MsgSize, MsgSize_t MsgNum, MsgQueueId_t &Mqid);	// Permanent: queues cannot be deleted
+
+#if uMT_USE_TIMERS==1
+inline	Errno_t	Mq_Send(MsgQueueId_t Mqid, const void *pMsg, uMToptions_t Options, Timer_t timeout=(Timer_t)0) {return(doMq_Send(Mqid, pMsg, 0, Options, timeout, TRUE)); };
+inline	Errno_t	Mq_Receive(MsgQueueId_t Mqid, void *pMsg, uMToptions_t Options, Timer_t timeout=(Timer_t)0) {return(doMq_Receive(Mqid, pMsg, 0, Options, timeout, TRUE)); };
+
+	// Zero copy: only the pointer is queued (MsgSize must be sizeof(void *))
+inline	Errno_t	Mq_SendPtr(MsgQueueId_t Mqid, void *Ptr, uMToptions_t Options, Timer_t timeout=(Timer_t)0) {return(doMq_Send(Mqid, &Ptr, sizeof(void *), Options, timeout, TRUE)); };
+inline	Errno_t	Mq_ReceivePtr(MsgQueueId_t Mqid, void *&Ptr, uMToptions_t Options, Timer_t timeout=(Timer_t)0) {return(doMq_Receive(Mqid, &Ptr, sizeof(void *), Options, timeout, TRUE)); };
+#else
+inline	Errno_t	Mq_Send(MsgQueueId_t Mqid, const void *pMsg, uMToptions_t Options) {return(doMq_Send(Mqid, pMsg, 0, Options, 0, TRUE)); };
+inline	Errno_t	Mq_Receive(MsgQueueId_t Mqid, void *pMsg, uMToptions_t Options) {return(doMq_Receive(Mqid, pMsg, 0, Options, 0, TRUE)); };
+
+	// Zero copy: only the pointer is queued (MsgSize must be sizeof(void *))
+inline	Errno_t	Mq_SendPtr(MsgQueueId_t Mqid, void *Ptr, uMToptions_t Options) {return(doMq_Send(Mqid, &Ptr, sizeof(void *), Options, 0, TRUE)); };
+inline	Errno_t	Mq_ReceivePtr(MsgQueueId_t Mqid, void *&Ptr, uMToptions_t Options) {return(doMq_Receive(Mqid, &Ptr, sizeof(void *), Options, 0, TRUE)); };
+#endif
+
+	// Message Queue I/O from ISR (uMT_NOWAIT!!!!!)
+inline	Errno_t	isr_Mq_Send(MsgQueueId_t Mqid, const void *pMsg) {return(doMq_Send(Mqid, pMsg, 0, uMT_NOWAIT, 0, FALSE)); };
+inline	Errno_t	isr_p_Mq_Send(MsgQueueId_t Mqid, const void *pMsg) {return(doMq_Send(Mqid, pMsg, 0, uMT_NOWAIT, 0, TRUE)); };
+inline	Errno_t	isr_Mq_SendPtr(MsgQueueId_t Mqid, void *Ptr) {return(doMq_Send(Mqid, &Ptr, sizeof(void *), uMT_NOWAIT, 0, FALSE)); };
+inline	Errno_t	isr_Mq_Receive(MsgQueueId_t Mqid, void *pMsg) {return(doMq_Receive(Mqid, pMsg, 0, uMT_NOWAIT, 0, FALSE)); };
+inline	Errno_t	isr_Mq_ReceivePtr(MsgQueueId_t Mqid, void *&Ptr) {return(doMq_Receive(Mqid, &Ptr, sizeof(void *), uMT_NOWAIT, 0, FALSE)); };
+#endif
+
+
+#if uMT_USE_EVENTGROUPS==1
+	////////////////////////////////////////////////////////
+	// EVENT GROUP management
+	////////////////////////////////////////////////////////
+		Errno_t	Eg_Create(EventGroupId_t &Egid);
+#if uMT_USE_TIMERS==1
+		Errno_t	Eg_Wait(EventGroupId_t Egid, Event_t eventin, uMToptions_t flags, Event_t *eventout, Timer_t timeout=(Timer_t)0);
+#else
+		Errno_t	Eg_Wait(EventGroupId_t Egid, Event_t eventin, uMToptions_t flags, Event_t *eventout);
+#endif
+
+	// EVENT GROUP set/clear can be called from ISR
+inline 	Errno_t	Eg_Set(EventGroupId_t Egid, Event_t Event) {return(doEg_Set(Egid, Event, TRUE));};
+inline 	Errno_t	isr_Eg_Set(EventGroupId_t Egid, Event_t Event) {return(doEg_Set(Egid, Event, FALSE));};
+inline 	Errno_t	isr_p_Eg_Set(EventGroupId_t Egid, Event_t Event) {return(doEg_Set(Egid, Event, TRUE));};
+		Errno_t	Eg_Clear(EventGroupId_t Egid, Event_t Event);
+inline 	Errno_t	isr_Eg_Clear(EventGroupId_t Egid, Event_t Event) {return(Eg_Clear(Egid, Event));};
+#endif
+
+
+#if uMT_USE_RWLOCKS==1
+	////////////////////////////////////////////////////////
+	// READERS-WRITER LOCK management
+	////////////////////////////////////////////////////////
+		Errno_t	Rw_Create(RwLockId_t &Rwid);
+#if uMT_USE_TIMERS==1
+inline	Errno_t	Rw_ReadLock(RwLockId_t Rwid, uMToptions_t Options, Timer_t timeout=(Timer_t)0) {return(doRw_Lock(Rwid, FALSE, Options, timeout)); };
+inline	Errno_t	Rw_WriteLock(RwLockId_t Rwid, uMToptions_t Options, Timer_t timeout=(Timer_t)0) {return(doRw_Lock(Rwid, TRUE, Options, timeout)); };
+#else
+inline	Errno_t	Rw_ReadLock(RwLockId_t Rwid, uMToptions_t Options) {return(doRw_Lock(Rwid, FALSE, Options, 0)); };
+inline	Errno_t	Rw_WriteLock(RwLockId_t Rwid, uMToptions_t Options) {return(doRw_Lock(Rwid, TRUE, Options, 0)); };
+#endif
+inline	Errno_t	Rw_Unlock(RwLockId_t Rwid) {return(doRw_Unlock(Rwid, TRUE)); };
+
+	// From ISR only read locks, never waiting
+inline	Errno_t	isr_Rw_TryReadLock(RwLockId_t Rwid) {return(doRw_Lock(Rwid, FALSE, uMT_NOWAIT, 0)); };
+inline	Errno_t	isr_Rw_ReadUnlock(RwLockId_t Rwid) {return(doRw_Unlock(Rwid, FALSE)); };
+#endif
+
+
+#if uMT_USE_DPC==1
+	////////////////////////////////////////////////////////
+	// DEFERRED PROCEDURE CALLS (run by the service task)
+	////////////////////////////////////////////////////////
+inline	Errno_t	Dp_Post(DpcFunc_t Func, void *Arg) {return(doDp_Post(Func, Arg, TRUE)); };
+inline	Errno_t	isr_Dp_Post(DpcFunc_t Func, void *Arg) {return(doDp_Post(Func, Arg, FALSE)); };
+inline	Errno_t	isr_p_Dp_Post(DpcFunc_t Func, void *Arg) {return(doDp_Post(Func, Arg, TRUE)); };
+		Errno_t	Dp_GetInfo(uMTdpcInfo &Info);
 #endif
 
 
@@ -588,6 +949,8 @@ inline 	Errno_t	isr_p_Ev_Send(TaskId_t Tid, Event_t Event) {return(doEv_Send(Tid
 
 extern uMT Kernel;
 
+#include "uMTring.h"
+
 #endif
 
 //////////////////// EOF
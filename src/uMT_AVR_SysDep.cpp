@@ -235,7 +235,11 @@ void __attribute__ ((noinline)) uMT::Suspend()
 // It returns the status register & disables INTERRUPT (GLOBAL)
 //
 /////////////////////////////////////////////////////////////////////////////////////////////////
+#if uMT_USE_INTOFF_PROFILER==1
+CpuStatusReg_t uMT::IntLockRaw()		// Instrumented isr_Kn_IntLock() in uMTintOff.cpp
+#else
 CpuStatusReg_t uMT::isr_Kn_IntLock()
+#endif
 {
 	uint8_t oldSREG = SREG;
 
@@ -254,7 +258,11 @@ CpuStatusReg_t uMT::isr_Kn_IntLock()
 // It restore the previous status register (enabling INTERRUPTs (GLOBAL) if previously enabled)
 //
 /////////////////////////////////////////////////////////////////////////////////////////////////
+#if uMT_USE_INTOFF_PROFILER==1
+void uMT::IntUnlockRaw(CpuStatusReg_t Param)		// Instrumented isr_Kn_IntUnlock() in uMTintOff.cpp
+#else
 void uMT::isr_Kn_IntUnlock(CpuStatusReg_t Param)
+#endif
 {
 
 //	sei();
@@ -365,6 +373,39 @@ void uMT::CheckInterrupts(const __FlashStringHelper *String)
 #endif
 
 
+#if	uMT_USE_TASK_STATISTICS>=2 && uMT_CPU_TIMESOURCE==uMT_CPUTIME_CYCLES
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT_CpuTimeInit - ARDUINO_UNO
+//
+// TIMER 1 becomes a free running counter at F_CPU/8, its overflows extend it to 32 bits
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+volatile uint16_t uMT_CpuTicksHigh;
+
+ISR(TIMER1_OVF_vect)
+{
+	uMT_CpuTicksHigh++;
+}
+
+void uMT_CpuTimeInit()
+{
+	uint8_t oldSREG = SREG;
+
+	cli();
+
+	TCCR1A = 0;					// Normal mode
+	TCCR1B = _BV(CS11);			// F_CPU/8
+	TCNT1 = 0;
+	uMT_CpuTicksHigh = 0;
+	TIFR1 = _BV(TOV1);			// Clear pending overflow
+	TIMSK1 = _BV(TOIE1);
+
+	SREG = oldSREG;
+}
+#endif
+
+
 #endif
 
 
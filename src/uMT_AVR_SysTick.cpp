@@ -44,6 +44,21 @@ extern void uMT_SystemTicks();
 extern unsigned uMTdoTicksWork();
 
 
+#if uMT_USE_PROFILER==1
+// Return address pushed by the interrupt, just above the 33 bytes saved by iMT_ISR_Entry():
+// MSB first, in words. To be used in the naked ISR, right after iMT_ISR_Entry().
+#if defined(__AVR_3_BYTE_PC__)
+#define uMT_AVR_ISR_PC(p)	((((uint32_t)(p)[0] << 16) | ((uint32_t)(p)[1] << 8) | (p)[2]) << 1)
+#else
+#define uMT_AVR_ISR_PC(p)	((((uint32_t)(p)[0] << 8) | (p)[1]) << 1)
+#endif
+
+#define uMT_AVR_PROFILE()	Kernel.isr_Kn_ProfileSample(uMT_AVR_ISR_PC((uint8_t *)SP + 1 + 33))
+#else
+#define uMT_AVR_PROFILE()
+#endif
+
+
 
 #if uMT_USE_WTD_4_TICKS==1
 
@@ -108,6 +123,8 @@ ISR(WDT_vect, ISR_NAKED)
 {
 	iMT_ISR_Entry();
 
+	uMT_AVR_PROFILE();
+
 	/////////////////////////////////////////
 	// uMT Specific
 	/////////////////////////////////////////
@@ -260,6 +277,8 @@ ISR(TIMER0_OVF_vect, ISR_NAKED)
 {
 	iMT_ISR_Entry();
 
+	uMT_AVR_PROFILE();
+
 
 	///////////////////////////////////////////////////////////////////
 	// ARDUINO original wiring.c
@@ -358,6 +377,73 @@ inline void uMT_SystemTicks()
 }
 
 
+#if uMT_USE_ISR_PREEMPTION==1
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT_IsrSwitch
+//
+// Deferred task switch requested by an isr_ call (see uMT::PendSwitch()).
+// It must be inlined in the naked ISR: the saved SP is the one left by iMT_ISR_Entry().
+//
+////////////////////////////////////////////////////////////////////////////////////
+inline __attribute__((always_inline)) void uMT_IsrSwitch()
+{
+	if (Kernel.NeedResched == TRUE && Kernel.NoPreempt == FALSE)
+	{
+		cli();		/* No interrupts now! */
+
+		if (Kernel.KernelStackMode == FALSE)			// to support Restart()
+			Kernel.Running->SavedSP = SP;	// Save Task's Stack Pointer
+
+		Kernel.NoPreempt = TRUE;		// Prevent further rescheduling.... until next one
+
+		// Switch to private stack and call Reschedule();
+		Kernel.NewStackReschedule();
+
+		// Never returns...
+	}
+}
+
+
+/***************************************************
+    Name:        ISR(SPM_READY_vect)
+    Returns:     Nothing.
+    Parameters:  None.
+    Description: Software interrupt for the deferred
+                 task switch. With SPMIE set it fires
+                 as soon as INTS are enabled (SPM is
+                 never busy in the application) and
+                 it has the lowest priority, so it
+                 runs after the requesting ISR and
+                 any other pending one.
+ ***************************************************/
+ISR(SPM_READY_vect, ISR_NAKED)
+{
+	iMT_ISR_Entry();
+
+	SPMCSR &= ~_BV(SPMIE);		// One shot
+
+	uMT_IsrSwitch();
+
+	iMT_ISR_Exit();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::PendSwitch - ARDUINO_UNO/MEGA
+//
+// Called by the isr_ routines when NeedResched is set: the switch happens on return
+// from the current interrupt instead of at the next System Tick.
+//
+////////////////////////////////////////////////////////////////////////////////////
+void uMT::PendSwitch()
+{
+	SPMCSR |= _BV(SPMIE);
+}
+#endif
+
+
 
 
 ////////////////////////////////////////////////////////////////////////////////////
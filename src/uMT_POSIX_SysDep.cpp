@@ -0,0 +1,409 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: uMT_POSIX_SysDep.cpp
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+#include <Arduino.h>
+
+#include "uMT.h"
+
+
+#include "uMTdebug.h"
+
+
+
+#if defined(uMT_POSIX)
+
+#include <signal.h>
+#include <ucontext.h>
+#include <stdio.h>
+
+///////////////////////////////////////////////////////////////////////////////////
+//
+// This file contains CPU dependendent routines (Stack and ask Switches, Interrupts disabling/enabling, ...
+//
+///////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// LINUX HOST
+//
+// The "CPU" is the process, the "interrupts" are the uMT_POSIX_TICK_SIGNAL signal
+// (and uMT_POSIX_SWITCH_SIGNAL, the deferred task switch of uMT_USE_ISR_PREEMPTION):
+//
+//		INTS disabled	=>	uMT_POSIX_TICK_SIGNAL blocked
+//		INTS enabled	=>	uMT_POSIX_TICK_SIGNAL unblocked
+//
+// The task context is a ucontext_t stored in the task's own STACK (like the AVR/SAM
+// register frame) and SavedSP points to it. Because a ucontext_t also stores the
+// signal mask, a task is always resumed with the "INTS" state it had when suspended.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Kernel PRIVATE STACK
+/////////////////////////////////////////////////////////////////////////////////////////////////
+static 	uint8_t KernelStack[uMT_KERNEL_STACK_SIZE] __attribute__((aligned(16)));
+static	ucontext_t KernelContext;
+
+// What to run in the private Kernel context (Reschedule or Reborn)
+static void (uMT::*KernelAction)();
+
+
+// Signals blocked when INTS are disabled
+static void IntsSet(sigset_t *pSet)
+{
+	sigemptyset(pSet);
+	sigaddset(pSet, uMT_POSIX_TICK_SIGNAL);
+#if uMT_USE_ISR_PREEMPTION==1
+	sigaddset(pSet, uMT_POSIX_SWITCH_SIGNAL);
+#endif
+}
+
+
+// Used by uMTmain.cpp & uMTarduinoCommon.cpp (AVR malloc() compatible names)
+char *__malloc_heap_start;
+char *__malloc_heap_end;
+char *__brkval;
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::KernelEntry - LINUX
+//
+// Entry point of the Kernel context, running on the private Kernel STACK with INTS disabled
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+void uMT::KernelEntry()
+{
+	// We are using Kernel Private STACK
+	Kernel.KernelStackMode = TRUE;
+
+	(Kernel.*KernelAction)();
+
+	// Never returns...
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	SwitchToKernelStack - LINUX
+//
+// Entered with INTS disabled! The signal mask (blocked) is inherited by the Kernel context.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+static void SwitchToKernelStack(void (*KernelEntry)())
+{
+	getcontext(&KernelContext);
+
+	KernelContext.uc_stack.ss_sp = KernelStack;
+	KernelContext.uc_stack.ss_size = sizeof(KernelStack);
+	KernelContext.uc_link = NULL;
+
+	makecontext(&KernelContext, KernelEntry, 0);
+
+	setcontext(&KernelContext);
+
+	// Never returns...
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::NewStackReschedule - LINUX
+//
+// Switch to private stack and call Reschedule();
+// Entered with INTS disabled!
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+void __attribute__((noinline)) uMT::NewStackReschedule()
+{
+	KernelAction = &uMT::Reschedule;
+
+	SwitchToKernelStack(KernelEntry);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::NewStackReborn - LINUX
+//
+// Switch to private stack and call Reborn();
+// Entered with INTS disabled!
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+void __attribute__((noinline)) uMT::NewStackReborn()
+{
+	KernelAction = &uMT::Reborn;
+
+	SwitchToKernelStack(KernelEntry);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::Kn_GetSP - LINUX
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+StackPtr_t __attribute__((noinline)) uMT::Kn_GetSP()
+{
+	return((StackPtr_t)__builtin_frame_address(0));
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TaskTrampoline - LINUX
+//
+// makecontext() only passes "int" parameters, so the 2 addresses are split in 32 bits halves
+// The task is entered with INTS disabled (see NewTask()) and enables them here.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+static void TaskTrampoline(unsigned StartHi, unsigned StartLo, unsigned ExitHi, unsigned ExitLo)
+{
+	void (*TaskStartAddr)() = (void (*)())(((uintptr_t)StartHi << 32) | StartLo);
+	void (*BadExit)() = (void (*)())(((uintptr_t)ExitHi << 32) | ExitLo);
+
+	// Now running on the task STACK
+	Kernel.isr_Kn_IntUnlock(0);
+
+	TaskStartAddr();
+
+	// Last return is BadExit()...
+	BadExit();
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	NewTask - LINUX
+//
+//	Setup new Stack for this stack, ready to be restarted
+//
+//	The initial context is stored on top of the task STACK, the remaining area is the STACK itself
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+StackPtr_t __attribute__ ((noinline)) uMT::NewTask(
+	StackPtr_t	TaskStackBase,
+	StackSize_t	StackSize,
+	void		(*TaskStartAddr)(),
+	void		(*BadExit)()
+	)
+{
+	// Stack is growing down... store the context on the top, 16 bytes aligned
+	StackPtr_t ContextAddr = (TaskStackBase + StackSize - sizeof(ucontext_t)) & ~((StackPtr_t)15);
+
+	ucontext_t *pContext = (ucontext_t *)ContextAddr;
+
+	getcontext(pContext);
+
+	pContext->uc_stack.ss_sp = (void *)TaskStackBase;
+	pContext->uc_stack.ss_size = ContextAddr - TaskStackBase;
+	pContext->uc_link = NULL;
+
+	// setcontext() restores the signal mask BEFORE switching STACK: a pending tick would
+	// be served on the Kernel STACK. Start with INTS disabled, TaskTrampoline() enables them.
+	IntsSet(&pContext->uc_sigmask);
+
+	makecontext(pContext, (void (*)())TaskTrampoline, 4,
+		(unsigned)((uintptr_t)TaskStartAddr >> 32), (unsigned)(uintptr_t)TaskStartAddr,
+		(unsigned)((uintptr_t)BadExit >> 32), (unsigned)(uintptr_t)BadExit);
+
+	return(ContextAddr);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	ResumeTask - LINUX
+//
+// This never returns!!!!!
+/////////////////////////////////////////////////////////////////////////////////////////////////
+void __attribute__ ((noinline)) uMT::ResumeTask(StackPtr_t StackPtr)
+{
+	// We are using application STACK
+	KernelStackMode = FALSE;
+
+	// Reload the whole context, including the signal mask (INTS)
+	setcontext((ucontext_t *)StackPtr);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Suspend - LINUX
+//
+// This is called from KENEL routine if a reschedule is needed
+// Usually entered with INTS ENABLED
+/////////////////////////////////////////////////////////////////////////////////////////////////
+void __attribute__ ((noinline)) uMT::Suspend()
+{
+	// Create a context frame in the task STACK
+	ucontext_t TaskContext;
+	volatile Bool_t	Resumed = FALSE;
+
+	isr_Kn_IntLock();		/* No interrupts now! */
+
+	getcontext(&TaskContext);
+
+	if (Resumed == FALSE)
+	{
+		Resumed = TRUE;
+
+		Running->SavedSP = (StackPtr_t)&TaskContext;	// Save Task's "Stack Pointer"
+
+		NoPreempt = TRUE;		// Prevent further rescheduling.... until next
+
+		// Switch to private stack and call Reschedule();
+		NewStackReschedule();
+
+		// Never returns...
+	}
+
+	// Returning to the caller only when this task is again the RUNNING task
+	// After resume, INTS enabled!!!!
+	isr_Kn_IntUnlock(0);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	isr_Kn_IntLock - LINUX
+//
+// It returns the status register & disables INTERRUPT (GLOBAL)
+// The returned value is 1 if INTS were already disabled
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+#if uMT_USE_INTOFF_PROFILER==1
+CpuStatusReg_t uMT::IntLockRaw()		// Instrumented isr_Kn_IntLock() in uMTintOff.cpp
+#else
+CpuStatusReg_t uMT::isr_Kn_IntLock()
+#endif
+{
+	sigset_t	IntSet;
+	sigset_t	OldSet;
+
+	IntsSet(&IntSet);
+
+	sigprocmask(SIG_BLOCK, &IntSet, &OldSet);
+
+	return((CpuStatusReg_t)sigismember(&OldSet, uMT_POSIX_TICK_SIGNAL));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	isr_Kn_IntUnlock - LINUX
+//
+// It restore the previous status register (enabling INTERRUPTs (GLOBAL) if previously enabled)
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+#if uMT_USE_INTOFF_PROFILER==1
+void uMT::IntUnlockRaw(CpuStatusReg_t Param)		// Instrumented isr_Kn_IntUnlock() in uMTintOff.cpp
+#else
+void uMT::isr_Kn_IntUnlock(CpuStatusReg_t Param)
+#endif
+{
+	if (Param != 0)
+		return;			// INTS were disabled, leave them disabled
+
+	sigset_t	IntSet;
+
+	IntsSet(&IntSet);
+
+	sigprocmask(SIG_UNBLOCK, &IntSet, NULL);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Kn_GetFreeRAM - LINUX
+//
+// The "RAM" is the area provided by extras/posix (RAMSTART-RAMEND) where loop() is running
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+StackPtr_t uMT::Kn_GetFreeRAM()
+{
+	return(Kn_GetSP() - Kn_GetSPbase());
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Kn_GetFreeRAMend - LINUX
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+StackPtr_t uMT::Kn_GetFreeRAMend()
+{
+	return(Kn_GetRAMend() - Kn_GetSPbase());
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Kn_GetSPbase - LINUX
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+StackPtr_t uMT::Kn_GetSPbase()
+{
+	return((StackPtr_t)RAMSTART);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Kn_GetRAMend - LINUX
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+StackPtr_t uMT::Kn_GetRAMend()
+{
+	return((StackPtr_t)RAMEND);
+}
+
+
+#if uMT_SAFERUN==1
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CheckInterrupts - LINUX
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+void __attribute__ ((noinline)) uMT::CheckInterrupts(const __FlashStringHelper *String)
+{
+	sigset_t	CurrentSet;
+
+	sigprocmask(SIG_BLOCK, NULL, &CurrentSet);
+
+	if (sigismember(&CurrentSet, uMT_POSIX_TICK_SIGNAL) == 0)
+	{
+		Serial.print(F("!uMT: CheckInterrupts(): INTERRUPTS incorrectly enabled, Func="));
+		Serial.println(String);
+		Serial.flush();
+
+		isr_Kn_FatalError();
+	}
+}
+
+#endif
+
+
+#endif
+
+////////////////////// EOF
@@ -0,0 +1,355 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: uMT_POSIX_SysTick.cpp
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+#include <Arduino.h>
+
+#include "uMT.h"
+
+
+#include "uMTdebug.h"
+
+
+#if defined(uMT_POSIX)
+
+#include <signal.h>
+#include <ucontext.h>
+#include <sys/time.h>
+
+
+extern void uMT_SystemTicks();
+extern unsigned uMTdoTicksWork();
+
+
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+//				CLASS uMT
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT_SystemTicks - LINUX
+//
+// This is called by the uMT_POSIX_TICK_SIGNAL handler, signal blocked (INTS disabled).
+//
+////////////////////////////////////////////////////////////////////////////////////
+void __attribute__((noinline)) uMT_SystemTicks()
+{
+	uint32_t CurrentTick = millis();
+
+	if (CurrentTick < Kernel.msTickCounter.Low) // RollOver..
+				Kernel.msTickCounter.High++;
+
+
+	Kernel.msTickCounter.Low = CurrentTick;		// Simply copy ticks counter...
+
+
+	if (Kernel.kernelCfg.BlinkingLED)
+	{
+		if ((Kernel.msTickCounter % uMT_TICKS_SECONDS) == 0)
+		{
+			volatile static Bool_t f_led = TRUE;
+
+			if (f_led == TRUE)
+			{
+				f_led = FALSE;
+				digitalWrite(LED_BUILTIN, HIGH);
+			}
+			else
+			{
+				f_led = TRUE;
+				digitalWrite(LED_BUILTIN, LOW);
+			}
+		}
+	}
+
+	if (uMTdoTicksWork() == 1)
+	{
+		///////////////////////////////////////////
+		// Suspend task and force a reschedule
+		///////////////////////////////////////////
+
+		// Create a context frame in the task STACK (signal frame is below it)
+		ucontext_t TaskContext;
+		volatile Bool_t	Resumed = FALSE;
+
+		getcontext(&TaskContext);
+
+		if (Resumed == FALSE)
+		{
+			Resumed = TRUE;
+
+			if (Kernel.KernelStackMode == FALSE)			// to support Restart()
+				Kernel.Running->SavedSP = (StackPtr_t)&TaskContext;	// Save Task's "Stack Pointer"
+
+			Kernel.NoPreempt = TRUE;		// Prevent further rescheduling.... until next one
+
+			// Switch to private stack and call Reschedule();
+			Kernel.NewStackReschedule();
+		}
+
+		// Returning to the caller only when this task is again the RUNNING task
+	}
+}
+
+
+#if uMT_USE_ISR_PREEMPTION==1
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT_IsrSwitch - LINUX
+//
+// Deferred task switch requested by an isr_ call (see uMT::PendSwitch()).
+// This is called by the uMT_POSIX_SWITCH_SIGNAL handler, INTS disabled.
+//
+////////////////////////////////////////////////////////////////////////////////////
+void __attribute__((noinline)) uMT_IsrSwitch()
+{
+	if (Kernel.NeedResched == TRUE && Kernel.NoPreempt == FALSE)
+	{
+		// Create a context frame in the task STACK (signal frame is below it)
+		ucontext_t TaskContext;
+		volatile Bool_t	Resumed = FALSE;
+
+		getcontext(&TaskContext);
+
+		if (Resumed == FALSE)
+		{
+			Resumed = TRUE;
+
+			if (Kernel.KernelStackMode == FALSE)			// to support Restart()
+				Kernel.Running->SavedSP = (StackPtr_t)&TaskContext;	// Save Task's "Stack Pointer"
+
+			Kernel.NoPreempt = TRUE;		// Prevent further rescheduling.... until next one
+
+			// Switch to private stack and call Reschedule();
+			Kernel.NewStackReschedule();
+		}
+
+		// Returning to the caller only when this task is again the RUNNING task
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	SwitchHandler - LINUX
+//
+// Raised by PendSwitch(): it is delivered as soon as INTS are enabled, i.e. when the
+// isr_ caller returns to the task. A signal handler which only blocks
+// uMT_POSIX_TICK_SIGNAL gets it immediately: the switch is then left to the next tick.
+//
+////////////////////////////////////////////////////////////////////////////////////
+static void SwitchHandler(int, siginfo_t *, void *Context)
+{
+	if (sigismember(&((ucontext_t *)Context)->uc_sigmask, uMT_POSIX_TICK_SIGNAL) == 0)
+		uMT_IsrSwitch();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::PendSwitch - LINUX
+//
+////////////////////////////////////////////////////////////////////////////////////
+void uMT::PendSwitch()
+{
+	raise(uMT_POSIX_SWITCH_SIGNAL);
+}
+#endif
+
+
+#if uMT_USE_PROFILER==1
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	InterruptedPC - LINUX
+//
+// PC of the interrupted code, from the signal context
+//
+////////////////////////////////////////////////////////////////////////////////////
+static ProfPC_t InterruptedPC(void *Context)
+{
+	mcontext_t *pRegs = &((ucontext_t *)Context)->uc_mcontext;
+
+#if defined(__x86_64__)
+	return((ProfPC_t)pRegs->gregs[REG_RIP]);
+#elif defined(__i386__)
+	return((ProfPC_t)pRegs->gregs[REG_EIP]);
+#elif defined(__aarch64__)
+	return((ProfPC_t)pRegs->pc);
+#elif defined(__arm__)
+	return((ProfPC_t)pRegs->arm_pc);
+#else
+	(void)pRegs;
+	return(0);
+#endif
+}
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	SysTickHandler - LINUX
+//
+////////////////////////////////////////////////////////////////////////////////////
+static void SysTickHandler(int, siginfo_t *, void *Context)
+{
+#if uMT_USE_PROFILER==1
+	Kernel.isr_Kn_ProfileSample(InterruptedPC(Context));
+#else
+	(void)Context;
+#endif
+
+	uMT_SystemTicks();
+
+	// Returning from the signal handler restores the task's signal mask (INTS enabled)
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	SetTickTimer - LINUX
+//
+// Program the interval timer: "Ticks" System Ticks, periodic or one-shot.
+// The expiry is aligned to a tick boundary of micros(), so msTickCounter follows millis().
+//
+////////////////////////////////////////////////////////////////////////////////////
+static void SetTickTimer(Timer_t Ticks, Bool_t Periodic)
+{
+	struct itimerval Tick;
+	uint32_t	TickUs = 1000000 / uMT_TICKS_SECONDS;
+	uint64_t	us = (uint64_t)Ticks * TickUs - (micros() % TickUs);
+
+	Tick.it_value.tv_sec = us / 1000000;
+	Tick.it_value.tv_usec = us % 1000000;
+
+	if (Periodic == TRUE)
+	{
+		Tick.it_interval.tv_sec = 0;
+		Tick.it_interval.tv_usec = TickUs;
+	}
+	else
+		timerclear(&Tick.it_interval);
+
+	setitimer(ITIMER_REAL, &Tick, NULL);
+}
+
+
+#if uMT_USE_TICKLESS==1
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::isr_Kn_TicklessSleep - LINUX
+//
+// Entered with INTs disabled (uMT_POSIX_TICK_SIGNAL blocked).
+// Program a one-shot System Tick after "Ticks" and wait for it without running the
+// handler, then restore the periodic tick and leave the signal pending: the handler
+// runs as soon as INTs are enabled again and aligns msTickCounter to millis().
+// Return the number of ticks not signalled.
+//
+////////////////////////////////////////////////////////////////////////////////////
+Timer_t uMT::isr_Kn_TicklessSleep(Timer_t Ticks)
+{
+	uint32_t	Start = millis();
+	sigset_t	Set;
+	int			Signal;
+
+	SetTickTimer(Ticks, FALSE);
+
+	sigemptyset(&Set);
+	sigaddset(&Set, uMT_POSIX_TICK_SIGNAL);
+
+	sigwait(&Set, &Signal);
+
+	SetTickTimer(1, TRUE);
+
+	raise(uMT_POSIX_TICK_SIGNAL);
+
+	Timer_t Elapsed = millis() - Start;
+
+	return(Elapsed > 1 ? Elapsed - 1 : 0);
+}
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::SetupSysTicks - LINUX
+//
+////////////////////////////////////////////////////////////////////////////////////
+void uMT::SetupSysTicks()
+{
+	// Switch LED off
+	pinMode(LED_BUILTIN, OUTPUT);
+	digitalWrite(LED_BUILTIN, LOW);
+
+	// Align SystemTick
+	Kernel.msTickCounter.Low = millis();
+
+	struct sigaction Action;
+
+	memset(&Action, 0, sizeof(Action));
+	Action.sa_sigaction = SysTickHandler;
+	Action.sa_flags = SA_RESTART | SA_SIGINFO;
+	sigemptyset(&Action.sa_mask);
+#if uMT_USE_ISR_PREEMPTION==1
+	sigaddset(&Action.sa_mask, uMT_POSIX_SWITCH_SIGNAL);		// INTS disabled in the handler
+#endif
+
+	sigaction(uMT_POSIX_TICK_SIGNAL, &Action, NULL);
+
+#if uMT_USE_ISR_PREEMPTION==1
+	// The deferred task switch
+	Action.sa_sigaction = SwitchHandler;
+	sigaddset(&Action.sa_mask, uMT_POSIX_TICK_SIGNAL);
+
+	sigaction(uMT_POSIX_SWITCH_SIGNAL, &Action, NULL);
+#endif
+
+	// One tick every 1/uMT_TICKS_SECONDS seconds
+	SetTickTimer(1, TRUE);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	isr_Kn_Reboot - LINUX
+//
+// Terminate the process
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+void	uMT::isr_Kn_Reboot()
+{
+	NoPreempt = TRUE;		// Prevent further rescheduling.... until next one
+
+	Serial.flush();
+
+	exit(EXIT_SUCCESS);
+}
+
+
+
+#endif
+
+///////////// EOF
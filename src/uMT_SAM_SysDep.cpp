@@ -98,11 +98,7 @@
 #define SAM_INITIAL_PSR		(0x01000000)
 #define SAM_EXCEPTION_LR	(0xFFFFFFF9)
 
-// Generate a "pendSVHook" exception
-#define GeneratePendSVHook_int()	SCB->ICSR |= SCB_ICSR_PENDSVSET_Msk
-
-#define EnableInterrupts() asm volatile ("cpsie i")
-#define DisableInterrupts() asm volatile ("cpsid i")
+#include "uMTarduinoSAM.h"
 
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -111,6 +107,58 @@
 static 	StackPtr_t KernelStack[uMT_KERNEL_STACK_SIZE];
 
 
+#if uMT_USE_MPU_STACK_GUARD==1
+
+extern "C" {
+
+// Top of the Kernel PRIVATE STACK, loaded by MemManage_Handler()
+StackPtr_t	uMT_MpuFaultSP = (StackPtr_t)&KernelStack[uMT_KERNEL_STACK_SIZE - 4];
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT_MpuFault - ARDUINO_SAM
+//
+// The Running task has hit its MPU guard region. Running on the Kernel private stack.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+void __attribute__((noinline)) uMT_MpuFault()
+{
+	// Back to the default memory map: the kernel can scan the faulty stack
+	MPU->CTRL = 0;
+	__DSB();
+	__ISB();
+
+	Kernel.KernelStackMode = TRUE;
+
+	Serial.print(F("uMT: MPU stack guard - TaskId = "));
+	Serial.println(Kernel.Running->myTid.GetID());
+	Serial.flush();
+
+	Kernel.isr_Kn_FatalError(F("uMT: Stack overflow!"));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	MemManage_Handler - ARDUINO_SAM
+//
+// It replaces the Arduino "weak" version. SP is inside the guard region (the exception
+// frame could not even be stacked): move to the Kernel private stack first.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+void __attribute__((naked)) __attribute__((noinline)) MemManage_Handler(void)
+{
+	asm volatile (
+		"ldr   r0, =uMT_MpuFaultSP;"
+		"ldr   r0, [r0];"
+		"mov   sp, r0;"
+		"b     uMT_MpuFault;");
+}
+
+};		// extern "C" linkage
+
+#endif
+
+
 /////////////////////////////////////////////////////////////////////////////////////////////////
 //
 //	uMT::NewStackReschedule - ARDUINO_SAM
@@ -272,25 +320,9 @@ void __attribute__((naked)) __attribute__ ((noinline)) uMT::ResumeTask(StackPtr_
 	// Re-enable INTS in case not enabled!!!!
 	EnableInterrupts();
 
-	// Restore all the General Purposes registers (13) from the STACK, 
-	// plus the LR register (14 registers total) and thend jump back to the caller (in LR)
-
-#if defined(ARDUINO_ARCH_SAMD)
-
-	/* for cortex m0, ldm and stm are restricted to low registers */
-	asm volatile (
-		"pop   {r2-r6};"
-		"mov   r8, r3;"
-		"mov   r7, r2;"
-		"pop   {r0-r3};"
-		"mov   r9, r0;"
-		"mov   r10, r1;"
-		"mov   r11, r2;"
-		"mov   lr, r3;"
-		"bx	lr;");
-#else
-	asm volatile ("pop   {r4-r11, lr};" "bx	lr;");
-#endif
+	// Restore r4-r11 (and s16-s31 if the task has an FP context) from the STACK, 
+	// plus the LR register and then jump back to the caller (in LR)
+	uMT_SAM_RestoreContext();
 }
 
 
@@ -319,6 +351,23 @@ void __attribute__ ((noinline)) uMT::Suspend()
 	// Returning to the caller only when this task is again the RUNNING task
 }
 
+
+#if uMT_USE_ISR_PREEMPTION==1
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	PendSwitch - ARDUINO_SAM
+//
+// Called by the isr_ routines when NeedResched is set. "pendSVHook" has the lowest priority,
+// so it is tail-chained when the last nested ISR returns and the switch happens then.
+// From a task (or with INTS disabled) it is taken as soon as INTS are enabled.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+void uMT::PendSwitch()
+{
+	GeneratePendSVHook_int();
+}
+#endif
+
 	
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -328,7 +377,11 @@ void __attribute__ ((noinline)) uMT::Suspend()
 // It returns the status register & disables INTERRUPT (GLOBAL)
 //
 /////////////////////////////////////////////////////////////////////////////////////////////////
+#if uMT_USE_INTOFF_PROFILER==1
+CpuStatusReg_t uMT::IntLockRaw()		// Instrumented isr_Kn_IntLock() in uMTintOff.cpp
+#else
 CpuStatusReg_t uMT::isr_Kn_IntLock()
+#endif
 {
 	// This function disables IRQ interrupts by setting the I-bit in the CPSR.
 	// It can only be executed in Privileged modes.
@@ -342,7 +395,11 @@ CpuStatusReg_t uMT::isr_Kn_IntLock()
 // It restore the previous status register (enabling INTERRUPTs (GLOBAL) if previously enabled)
 //
 /////////////////////////////////////////////////////////////////////////////////////////////////
+#if uMT_USE_INTOFF_PROFILER==1
+void uMT::IntUnlockRaw(CpuStatusReg_t Param)		// Instrumented isr_Kn_IntUnlock() in uMTintOff.cpp
+#else
 void uMT::isr_Kn_IntUnlock(CpuStatusReg_t Param)
+#endif
 {
 	// This function enables IRQ interrupts by clearing the I-bit in the CPSR.
 	// It can only be executed in Privileged modes.
@@ -48,12 +48,13 @@ extern unsigned uMTdoTicksWork();
 
 extern uint32_t GetTickCount();
 
+#if uMT_USE_TICKLESS==1
+extern void TimeTick_Increment();
+#endif
+
 
 
-// Generate a "pendSVHook" exception
-#define GeneratePendSVHook_int()	SCB->ICSR |= SCB_ICSR_PENDSVSET_Msk
-#define EnableInterrupts() asm volatile ("cpsie i")
-#define DisableInterrupts() asm volatile ("cpsid i")
+#include "uMTarduinoSAM.h"
 
 
 
@@ -67,55 +68,21 @@ extern "C" {
 //	sysTickHook
 //
 // This is called by the ARM SysTick interrupt routine.
+// It does the tick work and, only if a reschedule is needed, it pends a PendSV
+// which is tail-chained when SysTick returns.
 // It must return 0 so any other step is performed in the original SysTick_Handler
 ////////////////////////////////////////////////////////////////////////////////////
 unsigned int  __attribute__((noinline)) sysTickHook()
 {
 #if USE_TICK_HOOD_SAM==1
 
-	// Generate a "pendSVHook" exception
-	if (uMT::Inited == TRUE)
-		GeneratePendSVHook_int();
-
-#endif
-
-	return (0);
-}
-
-
-////////////////////////////////////////////////////////////////////////////////////
-//
-//	pendSVHook
-//
-// This is executed when "pendSVHook" exception is generated.
-//
-////////////////////////////////////////////////////////////////////////////////////
-void __attribute__ ((naked)) __attribute__((noinline)) pendSVHook(void)
-{
-	//  On entry, HW_EXCP is already saved 
+	if (uMT::Inited == FALSE)
+		return (0);
 
 #if defined(ARDUINO_ARCH_SAMD)
-	/* for cortex m0, ldm and stm are restricted to low registers */
-	asm volatile (
-		"mov   r3, lr;"
-		"mov   r2, r11;"
-		"mov   r1, r10;"
-		"mov   r0, r9;"
-		"push   {r0-r3};"
-
-		"mov   r3, r8;"
-		"mov   r2, r7;"
-		"push   {r2-r6};" 
-		);
-
 	uint32_t CurrentTick = millis();
-
 #else
-	// Save the remaining registers
-	asm volatile ("push {r4-r11,lr}");
-
 	uint32_t CurrentTick = GetTickCount();
-
 #endif
 	
 
@@ -147,49 +114,137 @@ void __attribute__ ((naked)) __attribute__((noinline)) pendSVHook(void)
 
 	if (uMTdoTicksWork() == 1)
 	{
-		///////////////////////////////////////////
-		// Suspend task and force a reschedule
-		///////////////////////////////////////////
+		// Generate a "pendSVHook" exception to switch task
+		Kernel.NeedResched = TRUE;
 
-		// Disable INTS
-		DisableInterrupts();
+		GeneratePendSVHook_int();
+	}
+#if uMT_USE_PROFILER==1
+	else if (Kernel.ProfOn == TRUE)
+	{
+		GeneratePendSVHook_int();		// Only to sample the task's PC
+	}
 
-		register StackPtr_t stack_ptr asm ("sp");
+	Kernel.ProfPending = Kernel.ProfOn;
+#endif
 
-		if (Kernel.KernelStackMode == FALSE)			// to support Restart()
-			Kernel.Running->SavedSP = stack_ptr;	// Save Task's Stack Pointer
+#endif
 
-		Kernel.NoPreempt = TRUE;		// Prevent further rescheduling.... until next one
+	return (0);
+}
 
-		// Switch to private stack and call Reschedule();
-		Kernel.NewStackReschedule();
 
-		// Returning to the caller only when this task is again the RUNNING task
-	}
-	else
-	{
+#if uMT_USE_PROFILER==1
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	StackedPC
+//
+// PC in the exception frame of the task which was running when PendSV was taken.
+// SP points to the registers saved by uMT_SAM_SaveContext(): 9 words, EXC_RETURN
+// last, plus s16-s31 when the task has an FP context.
+//
+////////////////////////////////////////////////////////////////////////////////////
+static ProfPC_t StackedPC(StackPtr_t SP)
+{
+	uint32_t *pFrame = (uint32_t *)SP;
 
-#if defined(ARDUINO_ARCH_SAMD)
+#if uMT_SAM_FPU==1
+	if ((pFrame[8] & 0x10) == 0)
+		pFrame += 16;
+#endif
 
-		/* for cortex m0, ldm and stm are restricted to low registers */
-		asm volatile (
-		"pop   {r2-r6};"
-		"mov   r8, r3;"
-		"mov   r7, r2;"
-		"pop   {r0-r3};"
-		"mov   r9, r0;"
-		"mov   r10, r1;"
-		"mov   r11, r2;"
-		"mov   lr, r3;"
-		"bx    lr;");
-#else
-		// Restore registers
-		asm volatile ("pop {r4-r11,lr}");
+	// r0, r1, r2, r3, r12, LR, PC, xPSR
+	return((ProfPC_t)pFrame[9 + 6]);
+}
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT_SwitchContext
+//
+// Called by pendSVHook() on the stack of the outgoing task, just below its saved
+// context: SP is the value to store in Running->SavedSP.
+// It returns the SP of the task to resume.
+//
+// Only a task which has deleted itself (S_ZOMBIE) cannot run Reschedule on its own
+// stack, which is released in doDeleteTask(): that case still moves to the private
+// Kernel stack and NEVER RETURNS.
+//
+// With uMT_USE_MPU_STACK_GUARD the guard region follows the Running task: it is
+// removed while the kernel works (free() of a released stack writes into it).
+//
+////////////////////////////////////////////////////////////////////////////////////
+StackPtr_t __attribute__((noinline)) uMT_SwitchContext(StackPtr_t SP)
+{
+	// Disable INTS
+	DisableInterrupts();
 
-		// Return from EXCEPTION
-		asm volatile ("bx lr");
+#if uMT_USE_MPU_STACK_GUARD==1
+	Kernel.MpuStackGuard(NULL);
 #endif
+
+	if (Kernel.KernelStackMode == FALSE)		// to support Restart()
+		Kernel.Running->SavedSP = SP;		// Save Task's Stack Pointer
+
+#if uMT_USE_PROFILER==1
+	if (Kernel.ProfPending == TRUE)
+	{
+		Kernel.ProfPending = FALSE;
+
+		if (Kernel.KernelStackMode == FALSE)
+			Kernel.isr_Kn_ProfileSample(StackedPC(SP));
+	}
+#endif
+
+	if (Kernel.NeedResched == TRUE)
+	{
+		if (Kernel.Running->TaskStatus == S_ZOMBIE)
+		{
+			// Switch to private stack and call Reschedule();
+			Kernel.NewStackReschedule();
+		}
+
+		Kernel.doReschedule();
 	}
+
+#if uMT_USE_MPU_STACK_GUARD==1
+	Kernel.MpuStackGuard(Kernel.Running);
+#endif
+
+	// Re-enable INTS: PRIMASK is not part of the exception frame
+	EnableInterrupts();
+
+	return (Kernel.Running->SavedSP);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	pendSVHook
+//
+// This is executed when "pendSVHook" exception is generated (by Suspend(), by
+// sysTickHook() or by PendSwitch() in an isr_ call). It is the lowest priority
+// exception, so it never preempts another ISR: the whole switch is a single
+// save/restore of the task context.
+//
+////////////////////////////////////////////////////////////////////////////////////
+void __attribute__ ((naked)) __attribute__((noinline)) pendSVHook(void)
+{
+	//  On entry, HW_EXCP is already saved 
+
+	// Save the remaining registers
+	uMT_SAM_SaveContext();
+
+	// r0 = SP of the outgoing task, keep the AAPCS 8 bytes alignment for the call
+	asm volatile (
+		"mov   r0, sp;"
+		"sub   sp, #4;"
+		"bl    uMT_SwitchContext;"
+		"mov   sp, r0;");
+
+	// Restore registers of the incoming task and return from EXCEPTION
+	uMT_SAM_RestoreContext();
 }
 
 
@@ -248,12 +303,117 @@ void uMT::SetupSysTicks()
 
 #endif
 
+#if uMT_SAM_FPU==1
+	// Automatic + lazy FP state preservation (reset values, but some cores change them)
+	FPU->FPCCR |= FPU_FPCCR_ASPEN_Msk | FPU_FPCCR_LSPEN_Msk;
+#endif
+
+#if uMT_USE_MPU_STACK_GUARD==1
+	// Guard the Arduino loop() task, the default memory map for everything else
+	MpuStackGuard(Running);
+
+	MPU->CTRL = MPU_CTRL_PRIVDEFENA_Msk | MPU_CTRL_ENABLE_Msk;
+
+	// Lowest priority, as PendSV: the UART interrupt must run while the fault is reported.
+	// An overflow with INTS disabled or inside an ISR escalates to HardFault.
+	NVIC_SetPriority(MemoryManagement_IRQn, 0xFF);
+	SCB->SHCSR |= SCB_SHCSR_MEMFAULTENA_Msk;
+
+	__DSB();
+	__ISB();
+#endif
+
 
 	// Enable SVCall_IRQn
 	// NVIC_EnableIRQ (SVCall_IRQn) ;	// It seems useless
 }
 
 
+#if uMT_USE_MPU_STACK_GUARD==1
+
+#define uMT_MPU_GUARD_REGION	7		// Highest numbered region: it wins over any other
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::MpuStackGuard - ARDUINO DUE
+//
+// The first uMT_MPU_GUARD_SIZE aligned bytes of the task stack become a no access
+// region: the first push below them raises a MemManage fault, before anything
+// else is overwritten. The uMT_STACK_GUARD_SKIP bytes reserved at the bottom of
+// every stack always contain it.
+//
+// Entered with INTS disabled
+//
+////////////////////////////////////////////////////////////////////////////////////
+void uMT::MpuStackGuard(uTask *pTask)
+{
+	MPU->RNR = uMT_MPU_GUARD_REGION;
+
+	if (pTask == NULL)
+	{
+		MPU->RASR = 0;		// Region disabled
+	}
+	else
+	{
+		MPU->RBAR = (pTask->StackBaseAddr + uMT_MPU_GUARD_SIZE - 1) & ~(uMT_MPU_GUARD_SIZE - 1);
+
+		// 32 bytes (2^(SIZE+1)), AP=0 (no access), no execution
+		MPU->RASR = MPU_RASR_XN_Msk | (4 << MPU_RASR_SIZE_Pos) | MPU_RASR_ENABLE_Msk;
+	}
+
+	__DSB();
+	__ISB();
+}
+#endif
+
+
+#if uMT_USE_TICKLESS==1
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::isr_Kn_TicklessSleep - ARDUINO DUE
+//
+// Entered with INTs disabled.
+// SysTick is reloaded with "Ticks" periods (24 bits counter: about 199ms at 84MHz) and
+// the CPU sleeps with WFI: a pending interrupt wakes it up even if INTs are disabled.
+// The periodic tick is then restored and the Arduino tick count is advanced by the
+// ticks not signalled (a fraction of tick is lost when woken up by another interrupt).
+// Any pending interrupt (SysTick too) is served as soon as INTs are enabled again.
+//
+////////////////////////////////////////////////////////////////////////////////////
+Timer_t uMT::isr_Kn_TicklessSleep(Timer_t Ticks)
+{
+	uint32_t TickCycles = SystemCoreClock / uMT_TICKS_SECONDS;
+	uint32_t MaxTicks = (SysTick_LOAD_RELOAD_Msk + 1) / TickCycles;
+
+	if (Ticks > MaxTicks)
+		Ticks = MaxTicks;
+
+	// One long period
+	SysTick->LOAD = Ticks * TickCycles - 1;
+	SysTick->VAL = 0;					// Restart, clear COUNTFLAG
+
+	__DSB();
+	__WFI();
+
+	Timer_t Skipped;
+
+	if (SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk)
+		Skipped = Ticks - 1;			// Expired: SysTick interrupt pending
+	else
+		Skipped = (SysTick->LOAD - SysTick->VAL) / TickCycles;	// Woken up by another interrupt
+
+	// Back to the periodic tick
+	SysTick->LOAD = TickCycles - 1;
+	SysTick->VAL = 0;
+
+	for (Timer_t idx = 0; idx < Skipped; idx++)
+		TimeTick_Increment();
+
+	return(Skipped);
+}
+#endif
+
+
 /////////////////////////////////////////////////////////////////////////////////////////////////
 //
 //	isr_Kn_Reboot - ARDUINO_UNO/MEGA
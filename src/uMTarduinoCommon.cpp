@@ -97,6 +97,10 @@ void	uMT::isr_Kn_FatalError()
 
 	Kn_PrintInternals();
 
+#if defined(uMT_POSIX)
+	exit(EXIT_FAILURE);		// Make the failure visible to the caller (test scripts)
+#endif
+
 	isr_Kn_Reboot();
 
 }
@@ -119,6 +123,10 @@ void	uMT::isr_Kn_FatalError(const __FlashStringHelper *String)
 
 	Kn_PrintInternals();
 
+#if defined(uMT_POSIX)
+	exit(EXIT_FAILURE);		// Make the failure visible to the caller (test scripts)
+#endif
+
 	isr_Kn_Reboot();
 
 }
@@ -140,12 +148,13 @@ void uMT::IdleLoop()
 		}
 
 #if uMT_IDLE_TIMEOUT==1
-		// Every time the timeslice for IDLE expires, this triggers some special action (e.g., PrintInternals()
+		// Every time the timeslice for IDLE expires, this triggers some special action (e.g., PrintSnapshot()
+		// Kn_PrintInternals() would freeze rescheduling while printing to Serial
 
 		if (Kernel.TimeSlice <= 1)
 		{
 //			digitalWrite(LED_BUILTIN, HIGH);
-			Kernel.Kn_PrintInternals();
+			Kernel.Kn_PrintSnapshot();
 			
 			// Reset
 			Kernel.TimeSlice = uMT_IDLE_TIMEOUTVALUE;
@@ -163,9 +172,62 @@ void uMT::IdleLoop()
 			Kernel.Tk_Yield();
 		}
 
+#if uMT_USE_TICKLESS==1
+		Kernel.TicklessIdle();
+#endif
+
 	}
 }
 
+
+#if uMT_USE_TICKLESS==1
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TicklessIdle - ARDUINO SAM/LINUX
+//
+// Called by the IDLE task: if nothing is ready, the System Tick is reprogrammed to expire
+// at the next timer deadline (or IDLE timeout, or LED toggle) and the CPU sleeps.
+// When waking up msTickCounter is aligned by the next System Tick, which is left pending.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+void uMT::TicklessIdle()
+{
+	CpuStatusReg_t CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+	if (ReadyQueue.IsEmpty() == TRUE && NeedResched == FALSE && NoPreempt == FALSE)
+	{
+		Timer_t Ticks = TimeSlice;		// At least wake up for the IDLE timeout
+
+#if uMT_USE_TIMERS==1
+		Timer_t Deadline = TimerQ_NextDeadline();
+
+		if (Deadline < Ticks)
+			Ticks = Deadline;
+#endif
+
+		if (kernelCfg.BlinkingLED)
+		{
+			// Wake up for the next LED toggle
+			Timer_t Blink = uMT_TICKS_SECONDS - (msTickCounter % uMT_TICKS_SECONDS);
+
+			if (Blink < Ticks)
+				Ticks = Blink;
+		}
+
+		// Not worth for 1 tick...
+		if (Ticks > 1)
+		{
+			Timer_t Skipped = isr_Kn_TicklessSleep(Ticks);
+
+			TimeSlice = (Skipped < TimeSlice ? TimeSlice - Skipped : 0);
+			TicksSkipped += Skipped;
+		}
+	}
+
+	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+}
+#endif
+
 		
 
 #if uMT_SAFERUN==1
@@ -432,7 +494,7 @@ Errno_t	uMT::Kn_PrintInternals(Bool_t PrintMaxUsedStack)
 	SerialPRINT(NeedResched);
 
 	SerialPRINT(F(" HEAP_FreeRAM(bytes)="));
-#if uMT_ALLOCATION_TYPE==uMT_VARIABLE_DYNAMIC
+#if uMT_ALLOCATION_TYPE==uMT_VARIABLE_DYNAMIC && !defined(uMT_POSIX)
 	SerialPRINT((size_t)(__malloc_heap_end - __brkval));
 #else
 	SerialPRINT(Kn_GetFreeRAM());
@@ -460,6 +522,14 @@ Errno_t	uMT::Kn_PrintInternals(Bool_t PrintMaxUsedStack)
 		SerialPRINT(F(" Prio="));
 		SerialPRINT(pTask->Priority);
 
+#if uMT_USE_MUTEX==1
+		if (pTask->BasePriority != pTask->Priority)
+		{
+			SerialPRINT(F(" BasePrio="));
+			SerialPRINT(pTask->BasePriority);
+		}
+#endif
+
 		SerialPRINT(F(" SP="));
 		SerialPRINT2((unsigned int)pTask->SavedSP, PRINT_MODE);
 
@@ -501,12 +571,12 @@ Errno_t	uMT::Kn_PrintInternals(Bool_t PrintMaxUsedStack)
 
 #if	uMT_USE_TASK_STATISTICS>=2
 		SerialPRINT(F(" RunningTime="));
-		PrintMicroSeconds(pTask->usRunningTime);
+		PrintMicroSeconds(uMT_CpuTicks2us(pTask->CpuRunningTime));
 
-		usTotalRunning = usTotalRunning + pTask->usRunningTime;
+		usTotalRunning = usTotalRunning + pTask->CpuRunningTime;
 
 		SerialPRINT(F(" LastRun="));
-		PrintMicroSeconds(pTask->usLastRun);
+		PrintMicroSeconds(uMT_CpuTicks2us(pTask->CpuLastRun));
 #endif
 
 		SerialPRINTln(F(" >"));
@@ -524,11 +594,16 @@ Errno_t	uMT::Kn_PrintInternals(Bool_t PrintMaxUsedStack)
 	PrintMilliSeconds(msTickCounter);
 
 #if	uMT_USE_TASK_STATISTICS>=2
+	usTotalRunning = uMT_CpuTicks2us(usTotalRunning);
+
 	SerialPRINT(F(" UserTime="));
 	PrintMicroSeconds(usTotalRunning);
 
 	SerialPRINT(F(" KernelTime="));
-	PrintMicroSeconds(usKernelRunningTime);
+	PrintMicroSeconds(uMT_CpuTicks2us(CpuKernelTime));
+
+	SerialPRINT(F(" IsrTime="));
+	PrintMicroSeconds(uMT_CpuTicks2us(CpuIsrTime));
 
 	SerialPRINT(F(" msTickCounter-UserTime="));
 	msNow = msNow - usTotalRunning.DivideBy(1000);
@@ -551,30 +626,44 @@ Errno_t	uMT::Kn_PrintInternals(Bool_t PrintMaxUsedStack)
 
 #endif
 
+	SerialPRINT(F(" TickInterrupts="));
+	SerialPRINT(TickInterrupts);
+
+#if uMT_USE_TICKLESS==1
+	SerialPRINT(F(" TicksSkipped="));
+	SerialPRINT(TicksSkipped);
+#endif
 
 	SerialPRINTln(F(" =================="));
 
 	// Print ReadyQueue
-	pTask = ReadyQueue.Head;
 	SerialPRINTln(F("=========== ReadyQueue =================="));
 
-	while (pTask != NULL)
+	for (int prio = PRIO_MAXPRIO_MASK; prio >= 0; prio--)
 	{
+		pTask = ReadyQueue.Head[prio];
 
-		SerialPRINT(F(" Tid="));
-		SerialPRINT(pTask->myTid.GetID());
+		while (pTask != NULL)
+		{
 
-		SerialPRINT(F(" Status="));
-		SerialPRINT(pTask->TaskStatus2String());
+			SerialPRINT(F(" Tid="));
+			SerialPRINT(pTask->myTid.GetID());
+
+			SerialPRINT(F(" Prio="));
+			SerialPRINT(prio);
+
+			SerialPRINT(F(" Status="));
+			SerialPRINT(pTask->TaskStatus2String());
 
 #if uMT_SAFERUN==1
-		SerialPRINT(F(" magic=0x"));
-		SerialPRINT2(pTask->magic, HEX);
+			SerialPRINT(F(" magic=0x"));
+			SerialPRINT2(pTask->magic, HEX);
 #endif
 
-		SerialPRINTln(F(">"));
+			SerialPRINTln(F(">"));
 
-		pTask = pTask->Next;
+			pTask = pTask->Next;
+		}
 	}
 
 
@@ -586,12 +675,27 @@ Errno_t	uMT::Kn_PrintInternals(Bool_t PrintMaxUsedStack)
 	{
 		pTask = SemList[idx].SemQueue.Head;
 
-		if (SemList[idx].SemValue > 0 || pTask != NULL)
+		if ((SemList[idx].SemValue & uMT_SEM_COUNT_MASK) > 0 || pTask != NULL)
 		{
 			SerialPRINT(F("=========== SemQueue ("));
 			SerialPRINT(idx);
 			SerialPRINT(F(") SemVal="));
-			SerialPRINT(SemList[idx].SemValue);
+			SerialPRINT(SemList[idx].SemValue & uMT_SEM_COUNT_MASK);
+
+			if (SemList[idx].Handoff == FALSE)
+				SerialPRINT(F(" NoHandoff"));
+
+#if uMT_USE_SEM_STATISTICS==1
+			SerialPRINT(F(" Claims="));
+			SerialPRINT(SemList[idx].Stats.Claims);
+			SerialPRINT(F(" Contentions="));
+			SerialPRINT(SemList[idx].Stats.Contentions);
+			SerialPRINT(F(" Timeouts="));
+			SerialPRINT(SemList[idx].Stats.Timeouts);
+			SerialPRINT(F(" WaitMax="));
+			SerialPRINT(SemList[idx].Stats.usWaitMax);
+			SerialPRINT(F("us"));
+#endif
 			SerialPRINTln(F(") =================="));
 		}
 
@@ -621,12 +725,203 @@ Errno_t	uMT::Kn_PrintInternals(Bool_t PrintMaxUsedStack)
 		}
 	}
 
+
+#if uMT_USE_MUTEX==1
+	for (int idx = 0; idx < kernelCfg.Mutexes_Num; idx++)
+	{
+		uMTmutex *pMx = &MxList[idx];
+
+		if (pMx->Owner == NULL)
+		{
+			continue;		// Next Mutex
+		}
+
+		SerialPRINT(F("=========== MxQueue ("));
+		SerialPRINT(idx);
+		SerialPRINT(F(") Owner="));
+		SerialPRINT(pMx->Owner->myTid.GetID());
+		SerialPRINT(F(" Locks="));
+		SerialPRINT(pMx->MxLocks);
+		SerialPRINTln(F(") =================="));
+
+		for (pTask = pMx->MxQueue.Head; pTask != NULL; pTask = pTask->Next)
+		{
+			SerialPRINT(F(" Tid="));
+			SerialPRINT(pTask->myTid.GetID());
+
+			SerialPRINT(F(" Status="));
+			SerialPRINT(pTask->TaskStatus2String());
+
+			SerialPRINT(F(" Prio="));
+			SerialPRINT(pTask->Priority);
+
+			SerialPRINTln(F(">"));
+		}
+	}
+#endif
+
+#if uMT_USE_POOLS==1
+	SerialPRINT(F("=========== Pools (area used="));
+	SerialPRINT(PlAreaUsed);
+	SerialPRINT(F("/"));
+	SerialPRINT(kernelCfg.PoolArea_Size);
+	SerialPRINTln(F(") =================="));
+
+	for (int idx = 0; idx < kernelCfg.Pools_Num; idx++)
+	{
+		uMTpool *pPool = &PlList[idx];
+
+		if (pPool->Area == NULL)
+		{
+			continue;		// Next Pool
+		}
+
+		SerialPRINT(F(" PoolId="));
+		SerialPRINT(idx);
+
+		SerialPRINT(F(" BlockSize="));
+		SerialPRINT(pPool->BlockSize);
+
+		SerialPRINT(F(" BlockNum="));
+		SerialPRINT(pPool->BlockNum);
+
+		SerialPRINT(F(" Free="));
+		SerialPRINT(pPool->FreeNum);
+
+		SerialPRINT(F(" MaxUsed="));
+		SerialPRINT(pPool->BlockNum - pPool->MinFreeNum);
+
+		SerialPRINTln(F(">"));
+	}
+#endif
+
+#if uMT_USE_MSGQUEUES==1
+	for (int idx = 0; idx < kernelCfg.MsgQueues_Num; idx++)
+	{
+		uMTmsgQueue *pMq = &MqList[idx];
+
+		if (pMq->Buffer == NULL)
+		{
+			continue;		// Next Message Queue
+		}
+
+		SerialPRINT(F("=========== MsgQueue ("));
+		SerialPRINT(idx);
+		SerialPRINT(F(") MsgSize="));
+		SerialPRINT(pMq->MsgSize);
+		SerialPRINT(F(" Count="));
+		SerialPRINT(pMq->Count);
+		SerialPRINT(F("/"));
+		SerialPRINT(pMq->MsgNum);
+		SerialPRINT(F(" MaxCount="));
+		SerialPRINT(pMq->MaxCount);
+		SerialPRINTln(F(") =================="));
+
+		for (int Send = 0; Send < 2; Send++)
+		{
+			for (pTask = (Send ? pMq->SendQueue.Head : pMq->RecvQueue.Head); pTask != NULL; pTask = pTask->Next)
+			{
+				SerialPRINT((Send ? F(" Send: Tid=") : F(" Recv: Tid=")));
+				SerialPRINT(pTask->myTid.GetID());
+
+				SerialPRINT(F(" Status="));
+				SerialPRINT(pTask->TaskStatus2String());
+
+				SerialPRINT(F(" Prio="));
+				SerialPRINT(pTask->Priority);
+
+				SerialPRINTln(F(">"));
+			}
+		}
+	}
+#endif
+
+#if uMT_USE_EVENTGROUPS==1
+	for (int idx = 0; idx < kernelCfg.EventGroups_Num; idx++)
+	{
+		uMTeventGroup *pEg = &EgList[idx];
+
+		if (pEg->Created == FALSE)
+		{
+			continue;		// Next Event Group
+		}
+
+		SerialPRINT(F("=========== EventGroup ("));
+		SerialPRINT(idx);
+		SerialPRINT(F(") Flags=0x"));
+		SerialPRINT2(pEg->Flags, HEX);
+		SerialPRINTln(F(" =================="));
+
+		for (pTask = pEg->WaitQueue.Head; pTask != NULL; pTask = pTask->Next)
+		{
+			SerialPRINT(F(" Wait: Tid="));
+			SerialPRINT(pTask->myTid.GetID());
+
+			SerialPRINT(F(" Status="));
+			SerialPRINT(pTask->TaskStatus2String());
+
+			SerialPRINT(F(" Prio="));
+			SerialPRINT(pTask->Priority);
+
+			SerialPRINT(F(" Requested=0x"));
+			SerialPRINT2(pTask->EgRequested, HEX);
+
+			SerialPRINT(((pTask->EgCondition & uMT_ANY) ? F(" ANY") : F(" ALL")));
+
+			if (pTask->EgCondition & uMT_CLEAR)
+				SerialPRINT(F("+CLEAR"));
+
+			SerialPRINTln(F(">"));
+		}
+	}
+#endif
+
+#if uMT_USE_RWLOCKS==1
+	for (int idx = 0; idx < kernelCfg.RwLocks_Num; idx++)
+	{
+		uMTrwLock *pRw = &RwList[idx];
+
+		if (pRw->Created == FALSE)
+		{
+			continue;		// Next RW lock
+		}
+
+		SerialPRINT(F("=========== RwLock ("));
+		SerialPRINT(idx);
+		SerialPRINT(F(") Readers="));
+		SerialPRINT(pRw->Readers);
+		SerialPRINT(F(" Writer="));
+		if (pRw->Writer != NULL)
+			SerialPRINT(pRw->Writer->myTid.GetID());
+		else
+			SerialPRINT(F("NONE"));
+		SerialPRINTln(F(" =================="));
+
+		for (int Write = 1; Write >= 0; Write--)
+		{
+			for (pTask = (Write ? pRw->WriteQueue.Head : pRw->ReadQueue.Head); pTask != NULL; pTask = pTask->Next)
+			{
+				SerialPRINT((Write ? F(" Write: Tid=") : F(" Read: Tid=")));
+				SerialPRINT(pTask->myTid.GetID());
+
+				SerialPRINT(F(" Status="));
+				SerialPRINT(pTask->TaskStatus2String());
+
+				SerialPRINT(F(" Prio="));
+				SerialPRINT(pTask->Priority);
+
+				SerialPRINTln(F(">"));
+			}
+		}
+	}
+#endif
+
 	
 
 #if uMT_USE_TIMERS==1
 
 	// Print TimerQueue
-	uTimer *pTimer = TimerQueue;
+	uTimer *pTimer = TimerQ_Next(NULL);
 
 	SerialPRINT(F("=========== TimerQueue (total="));
 	SerialPRINT(TotTimerQueued);
@@ -671,7 +966,7 @@ Errno_t	uMT::Kn_PrintInternals(Bool_t PrintMaxUsedStack)
 
 		SerialPRINTln(F(">"));
 
-		pTimer = pTimer->Next;
+		pTimer = TimerQ_Next(pTimer);
 	}
 #endif
 
@@ -682,6 +977,134 @@ Errno_t	uMT::Kn_PrintInternals(Bool_t PrintMaxUsedStack)
 	return(E_SUCCESS);
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Kn_PrintSnapshot - ARDUINO
+//
+// Same kernel and task counters as Kn_PrintInternals(), but copied with Kn_GetSnapshot()
+// a few tasks at a time and printed with preemption enabled: higher priority tasks
+// keep running while Serial is busy. Queues are not printed.
+//
+// On AVR it runs in the IDLE task too (128 bytes of stack): the buffers are static
+// there, so only one task at a time may call it.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+#if defined(ARDUINO_ARCH_AVR)
+#define SNAPSHOT_CHUNK		1
+#define SNAPSHOT_STORAGE	static		// Not on the IDLE task stack
+#else
+#define SNAPSHOT_CHUNK		4
+#define SNAPSHOT_STORAGE
+#endif
+
+Errno_t	uMT::Kn_PrintSnapshot()
+{
+	SNAPSHOT_STORAGE uMTsnapshot		Snap;
+	SNAPSHOT_STORAGE uMTtaskSnapshot	Tasks[SNAPSHOT_CHUNK];
+	Errno_t			error;
+
+	Snap.Init();
+
+	if ((error = Kn_GetSnapshot(Snap, Tasks, SNAPSHOT_CHUNK)) != E_SUCCESS)
+		return(error);
+
+	SerialPRINTln(F("=========== KERNEL SNAPSHOT start =================="));
+
+	SerialPRINT(F("ActiveTaskNo="));
+	SerialPRINT(Snap.ActiveTaskNo);
+
+	SerialPRINT(F(" NoPreempt="));
+	SerialPRINT(Snap.NoPreempt);
+
+	SerialPRINT(F(" NeedResched="));
+	SerialPRINT(Snap.NeedResched);
+
+	SerialPRINT(F(" msTickCounter="));
+	PrintMilliSeconds(Snap.msTickCounter);
+
+	SerialPRINT(F(" TickInterrupts="));
+	SerialPRINT(Snap.TickInterrupts);
+
+#if uMT_USE_TICKLESS==1
+	SerialPRINT(F(" TicksSkipped="));
+	SerialPRINT(Snap.TicksSkipped);
+#endif
+
+#if	uMT_USE_TASK_STATISTICS>=2
+	SerialPRINT(F(" KernelTime="));
+	PrintMicroSeconds(uMT_CpuTicks2us(Snap.CpuKernelTime));
+
+	SerialPRINT(F(" IsrTime="));
+	PrintMicroSeconds(uMT_CpuTicks2us(Snap.CpuIsrTime));
+#endif
+
+	SerialPRINTln(F(""));
+
+	while (Snap.TaskNum > 0)
+	{
+		for (unsigned int idx = 0; idx < Snap.TaskNum; idx++)
+		{
+			uMTtaskSnapshot *pSnap = &Tasks[idx];
+
+			SerialPRINT(F("< Tid="));
+			SerialPRINT(pSnap->Tid.GetID());
+
+			SerialPRINT(F(" Status="));
+			SerialPRINT(uTask::TaskStatus2String(pSnap->TaskStatus));
+
+			SerialPRINT(F(" Prio="));
+			SerialPRINT(pSnap->Priority);
+
+#if uMT_USE_MUTEX==1
+			if (pSnap->BasePriority != pSnap->Priority)
+			{
+				SerialPRINT(F(" BasePrio="));
+				SerialPRINT(pSnap->BasePriority);
+			}
+#endif
+
+			SerialPRINT(F(" SPsize="));
+			SerialPRINT(pSnap->StackSize);
+
+			SerialPRINT(F(" SPfree="));
+			SerialPRINT(pSnap->FreeStack);
+
+#if uMT_USE_STACK_CHECK==1
+			SerialPRINT(F(" HighWater="));
+			SerialPRINT(pSnap->StackHighWater);
+#endif
+
+#if	uMT_USE_EVENTS==1
+			SerialPRINT(F(" EV_recv=0x"));
+			SerialPRINT2(pSnap->EV_received, HEX);
+
+			SerialPRINT(F(" EV_req=0x"));
+			SerialPRINT2(pSnap->EV_requested, HEX);
+#endif
+
+#if	uMT_USE_TASK_STATISTICS>=1
+			SerialPRINT(F(" Run#="));
+			SerialPRINT(pSnap->Run);
+#endif
+
+#if	uMT_USE_TASK_STATISTICS>=2
+			SerialPRINT(F(" RunningTime="));
+			PrintMicroSeconds(uMT_CpuTicks2us(pSnap->CpuRunningTime));
+#endif
+
+			SerialPRINTln(F(" >"));
+		}
+
+		// Next tasks
+		Kn_GetSnapshot(Snap, Tasks, SNAPSHOT_CHUNK);
+	}
+
+	SerialPRINTln(F("=========== KERNEL SNAPSHOT end =================="));
+
+	return(E_SUCCESS);
+}
+
+
 /////////////////////////////////////////////////////////////////////////////////////////////////
 //
 //	Tk_PrintInfo - ARDUINO
@@ -713,6 +1136,15 @@ Errno_t	uMT::Tk_PrintInfo(uMTtaskInfo &Info)
 #if	uMT_USE_TASK_STATISTICS>=2
 	SerialPRINT(F("RunningTime   : "));
 	PrintMicroSeconds(Info.usRunningTime);
+	SerialPRINTln(F(""));
+	SerialPRINT(F("CpuPercent    : "));
+	SerialPRINTln(Info.CpuPercent);
+	SerialPRINT(F("KernelTime    : "));
+	PrintMicroSeconds(Info.usKernelTime);
+	SerialPRINTln(F(""));
+	SerialPRINT(F("IsrTime       : "));
+	PrintMicroSeconds(Info.usIsrTime);
+	SerialPRINTln(F(""));
 #endif
 
 	SerialPRINT(F("StackSize     : "));
@@ -749,6 +1181,26 @@ Errno_t	uMT::Kn_PrintConfiguration(uMTcfg &Cfg)
 	SerialPRINTln((Cfg.ro.Use_Events ? F("YES") : F("NO")));
 	SerialPRINT(F("Use_Semaphores       : "));
 	SerialPRINTln((Cfg.ro.Use_Semaphores ? F("YES") : F("NO")));
+	SerialPRINT(F("Use_Mutexes          : "));
+	SerialPRINTln((Cfg.ro.Use_Mutexes ? F("YES") : F("NO")));
+	SerialPRINT(F("Use_Pools            : "));
+	SerialPRINTln((Cfg.ro.Use_Pools ? F("YES") : F("NO")));
+	SerialPRINT(F("Use_MsgQueues        : "));
+	SerialPRINTln((Cfg.ro.Use_MsgQueues ? F("YES") : F("NO")));
+	SerialPRINT(F("Use_EventGroups      : "));
+	SerialPRINTln((Cfg.ro.Use_EventGroups ? F("YES") : F("NO")));
+	SerialPRINT(F("Use_RwLocks          : "));
+	SerialPRINTln((Cfg.ro.Use_RwLocks ? F("YES") : F("NO")));
+	SerialPRINT(F("Use_Rings            : "));
+	SerialPRINTln((Cfg.ro.Use_Rings ? F("YES") : F("NO")));
+	SerialPRINT(F("Use_Trace            : "));
+	SerialPRINTln((Cfg.ro.Use_Trace ? F("YES") : F("NO")));
+	SerialPRINT(F("Use_Profiler         : "));
+	SerialPRINTln((Cfg.ro.Use_Profiler ? F("YES") : F("NO")));
+	SerialPRINT(F("Use_IntOffProfiler   : "));
+	SerialPRINTln((Cfg.ro.Use_IntOffProfiler ? F("YES") : F("NO")));
+	SerialPRINT(F("Use_Dpc              : "));
+	SerialPRINTln((Cfg.ro.Use_Dpc ? F("YES") : F("NO")));
 	SerialPRINT(F("Use_Timers           : "));
 	SerialPRINTln((Cfg.ro.Use_Timers ? F("YES") : F("NO")));
 	SerialPRINT(F("Use_RestartTask      : "));
@@ -762,6 +1214,18 @@ Errno_t	uMT::Kn_PrintConfiguration(uMTcfg &Cfg)
 	SerialPRINTln(Cfg.ro.Events_Num);
 	SerialPRINT(F("Semaphores_Num       : "));
 	SerialPRINTln(Cfg.rw.Semaphores_Num);
+	SerialPRINT(F("Mutexes_Num          : "));
+	SerialPRINTln(Cfg.rw.Mutexes_Num);
+	SerialPRINT(F("Pools_Num            : "));
+	SerialPRINTln(Cfg.rw.Pools_Num);
+	SerialPRINT(F("PoolArea_Size        : "));
+	SerialPRINTln(Cfg.rw.PoolArea_Size);
+	SerialPRINT(F("MsgQueues_Num        : "));
+	SerialPRINTln(Cfg.rw.MsgQueues_Num);
+	SerialPRINT(F("EventGroups_Num      : "));
+	SerialPRINTln(Cfg.rw.EventGroups_Num);
+	SerialPRINT(F("RwLocks_Num          : "));
+	SerialPRINTln(Cfg.rw.RwLocks_Num);
 	SerialPRINT(F("Events_Num           : "));
 	SerialPRINTln(Cfg.ro.Events_Num);
 	SerialPRINT(F("AgentTimers_Num      : "));
@@ -803,7 +1267,7 @@ Errno_t	uMT::Kn_PrintConfiguration(uMTcfg &Cfg)
 /////////////////////////////////////////////////////////////////////////////////////////////////
 const __FlashStringHelper *uTimer::Flags2String()
 {
-	switch (Flags)
+	switch (Flags & ~uMT_TM_QUEUED)
 	{
 	case (uMT_TM_IAM_AGENT | uMT_TM_SEND_EVENT | uMT_TM_REPEAT):	return(F("uMT_TM_IAM_AGENT | uMT_TM_SEND_EVENT | uMT_TM_REPEAT")); break;
 	case (uMT_TM_IAM_AGENT | uMT_TM_SEND_EVENT):					return(F("uMT_TM_IAM_AGENT | uMT_TM_SEND_EVENT")); break;
@@ -882,20 +1346,230 @@ Errno_t	uMT::Kn_PrintInternals()
 {
 	return(E_SUCCESS);
 }
+
+Errno_t	uMT::Kn_PrintSnapshot()
+{
+	return(E_SUCCESS);
+}
 #endif
 
 
 
+#if uMT_USE_TRACE==1 || uMT_USE_PROFILER==1 || uMT_USE_INTOFF_PROFILER==1
+static void PrintHex(uint32_t Value, uint8_t Digits)
+{
+	while (Digits-- > 0)
+		SerialPRINT2((unsigned int)((Value >> (Digits * 4)) & 0x0F), HEX);
+}
+#endif
+
+
+#if uMT_USE_TRACE==1
 ////////////////////////////////////////////////////////////////////////////////////
 //
-//	uMTdoTicksWork
+//	uMT::Kn_TraceDump
+//
+// Tracing is stopped and the records are printed oldest first, one per line:
+//
+//	uMT-TRACE BEGIN <ticks per us> <records>
+//	TTTTTTTT YY OO AAAA		(Time, Type, Obj, Arg in hex)
+//	uMT-TRACE END
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::Kn_TraceDump()
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	TraceOn = FALSE;
+
+	uint16_t Idx = (TraceIn - TraceCount) & (uMT_TRACE_SIZE - 1);
+
+	SerialPRINT(F("uMT-TRACE BEGIN "));
+	SerialPRINT((unsigned int)uMT_TRACE_TICKS_PER_US);
+	SerialPRINT(F(" "));
+	SerialPRINTln(TraceCount);
+
+	for (uint16_t Num = 0; Num < TraceCount; Num++)
+	{
+		uMTtraceRec *pRec = &TraceBuf[Idx];
+
+		PrintHex(pRec->Time, 8);
+		SerialPRINT(F(" "));
+		PrintHex(pRec->Type, 2);
+		SerialPRINT(F(" "));
+		PrintHex(pRec->Obj, 2);
+		SerialPRINT(F(" "));
+		PrintHex(pRec->Arg, 4);
+		SerialPRINTln(F(""));
+
+		Idx = (Idx + 1) & (uMT_TRACE_SIZE - 1);
+	}
+
+	SerialPRINTln(F("uMT-TRACE END"));
+	SerialFLUSH();
+
+	TraceCount = 0;
+
+	return(E_SUCCESS);
+}
+#endif
+
+
+#if uMT_USE_PROFILER==1
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::Kn_ProfilerDump
+//
+// Sampling is stopped and the used slots are printed, one per line:
+//
+//	uMT-PROF BEGIN <samples> <lost> <divider> <IdleLoop address>
+//	PPPPPPPP TT CCCC		(PC, Tid, Count in hex)
+//	uMT-PROF END
+//
+// The IdleLoop() address lets the host script relocate the PCs (e.g., PIE on LINUX).
+//
+////////////////////////////////////////////////////////////////////////////////////
+static void PrintPC(ProfPC_t PC)
+{
+	for (int Shift = (sizeof(ProfPC_t) - 4) * 8; Shift >= 0; Shift -= 32)
+		PrintHex((uint32_t)(PC >> Shift), 8);
+}
+
+Errno_t	uMT::Kn_ProfilerDump()
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	ProfOn = FALSE;
+
+	ProfPC_t Anchor = (ProfPC_t)&IdleLoop;
+
+#if defined(ARDUINO_ARCH_AVR)
+	Anchor <<= 1;					// Word address
+#elif defined(ARDUINO_ARCH_SAM) || defined(ARDUINO_ARCH_SAMD)
+	Anchor &= ~(ProfPC_t)1;			// Thumb bit
+#endif
+
+	SerialPRINT(F("uMT-PROF BEGIN "));
+	SerialPRINT(ProfSamples);
+	SerialPRINT(F(" "));
+	SerialPRINT(ProfLost);
+	SerialPRINT(F(" "));
+	SerialPRINT(ProfDivider);
+	SerialPRINT(F(" "));
+	PrintPC(Anchor);
+	SerialPRINTln(F(""));
+
+	for (uint16_t Idx = 0; Idx < uMT_PROFILER_SIZE; Idx++)
+	{
+		uMTprofSlot *pSlot = &ProfTable[Idx];
+
+		if (pSlot->Count == 0)
+			continue;
+
+		PrintPC(pSlot->PC);
+		SerialPRINT(F(" "));
+		PrintHex(pSlot->Tid, 2);
+		SerialPRINT(F(" "));
+		PrintHex(pSlot->Count, 4);
+		SerialPRINTln(F(""));
+	}
+
+	SerialPRINTln(F("uMT-PROF END"));
+	SerialFLUSH();
+
+	return(E_SUCCESS);
+}
+#endif
+
+
+#if uMT_USE_INTOFF_PROFILER==1
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::Kn_IntOffDump
+//
+// Measuring is stopped and the statistics are printed (ticks in decimal):
+//
+//	uMT-IOFF BEGIN <windows> <CPU ticks per us> <IdleLoop address>
+//	SITE <call site> <longest window ticks> <windows since the site got its entry>
+//	HIST <bucket> <windows>		(2^bucket..2^(bucket+1)-1 ticks, empty buckets skipped)
+//	uMT-IOFF END
+//
+////////////////////////////////////////////////////////////////////////////////////
+static void PrintSite(IntOffSite_t Site)
+{
+#if defined(ARDUINO_ARCH_AVR)
+	Site <<= 1;						// Word address
+#elif defined(ARDUINO_ARCH_SAM) || defined(ARDUINO_ARCH_SAMD)
+	Site &= ~(IntOffSite_t)1;		// Thumb bit
+#endif
+
+	for (int Shift = (sizeof(IntOffSite_t) - 4) * 8; Shift >= 0; Shift -= 32)
+		PrintHex((uint32_t)(Site >> Shift), 8);
+}
+
+Errno_t	uMT::Kn_IntOffDump()
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	IntOffOn = FALSE;
+
+	SerialPRINT(F("uMT-IOFF BEGIN "));
+	SerialPRINT(IntOffWindows);
+	SerialPRINT(F(" "));
+	SerialPRINT((unsigned int)uMT_CPU_TICKS_PER_US);
+	SerialPRINT(F(" "));
+	PrintSite((IntOffSite_t)&IdleLoop);
+	SerialPRINTln(F(""));
+
+	for (uint8_t Idx = 0; Idx < uMT_INTOFF_TOP; Idx++)
+	{
+		uMTintOffSite *pTop = &IntOffTop[Idx];
+
+		if (pTop->Site == 0)
+			continue;
+
+		SerialPRINT(F("SITE "));
+		PrintSite(pTop->Site);
+		SerialPRINT(F(" "));
+		SerialPRINT(pTop->MaxTicks);
+		SerialPRINT(F(" "));
+		SerialPRINTln(pTop->Count);
+	}
+
+	for (uint8_t Bucket = 0; Bucket < uMT_INTOFF_BUCKETS; Bucket++)
+	{
+		if (IntOffHist[Bucket] == 0)
+			continue;
+
+		SerialPRINT(F("HIST "));
+		SerialPRINT(Bucket);
+		SerialPRINT(F(" "));
+		SerialPRINTln(IntOffHist[Bucket]);
+	}
+
+	SerialPRINTln(F("uMT-IOFF END"));
+	SerialFLUSH();
+
+	return(E_SUCCESS);
+}
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMTcheckTicks
 //
 // Return 1 is a Reschedule is needed
 ////////////////////////////////////////////////////////////////////////////////////
-unsigned uMTdoTicksWork()
+inline unsigned uMTcheckTicks()
 {
 	int	ForceReschedule = 0;		// Assume NO
 
+	Kernel.TickInterrupts++;
+
 	// Decrement slice counter
 	Kernel.TimeSlice--;
 
@@ -911,13 +1585,10 @@ unsigned uMTdoTicksWork()
 
 #if uMT_USE_TIMERS==1
 	// Check if some ALARM is expired
-	if (Kernel.TimerQueue != NULL)
+	if (Kernel.TimerQ_isrAlarmDue() == TRUE)
 	{
-		if (Kernel.TimerQueue->NextAlarm <= Kernel.msTickCounter)
-		{
-			Kernel.AlarmExpired = TRUE;
-			ForceReschedule = 1;
-		}
+		Kernel.AlarmExpired = TRUE;
+		ForceReschedule = 1;
 	}
 #endif
 
@@ -931,7 +1602,7 @@ unsigned uMTdoTicksWork()
 		{
 			if (Kernel.TimeSlice <= 0)
 			{
-				if (Kernel.ReadyQueue.Head != NULL)
+				if (Kernel.ReadyQueue.IsEmpty() == FALSE)
 					ForceReschedule = 1;
 				else
 					Kernel.TimeSlice = (Kernel.Running == Kernel.IdleTaskPtr ? uMT_IDLE_TIMEOUTVALUE : uMT_TICKS_TIMESHARING); // Reload
@@ -943,7 +1614,7 @@ unsigned uMTdoTicksWork()
 	{
 		// Check for higher priority tasks
 		// NoPreempt & NoResched already checked before...
-		if (Kernel.ReadyQueue.Head != NULL && Kernel.ReadyQueue.Head->Priority > Kernel.Running->Priority)
+		if (Kernel.ReadyQueue.IsEmpty() == FALSE && Kernel.ReadyQueue.HighestPrio() > Kernel.Running->Priority)
 		{
 			ForceReschedule = 1;
 		}
@@ -953,5 +1624,32 @@ unsigned uMTdoTicksWork()
 }
 
 
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMTdoTicksWork
+//
+// Return 1 is a Reschedule is needed
+// The time spent here is ISR time: it is not charged to the interrupted task
+////////////////////////////////////////////////////////////////////////////////////
+unsigned uMTdoTicksWork()
+{
+#if	uMT_USE_TASK_STATISTICS>=2
+	CpuTicks_t CpuIsrEnter = uMT_CpuTicks();
+
+	unsigned ForceReschedule = uMTcheckTicks();
+
+	CpuTicks_t CpuIsrDelta = uMT_CpuTicks() - CpuIsrEnter;
+
+	Kernel.CpuIsrSlice += CpuIsrDelta;
+	Kernel.CpuIsrTime = Kernel.CpuIsrTime + CpuIsrDelta;
+	Kernel.CpuTotalTime = Kernel.CpuTotalTime + CpuIsrDelta;
+
+	return(ForceReschedule);
+#else
+	return(uMTcheckTicks());
+#endif
+}
+
+
 
 ////////////////////// EOF
\ No newline at end of file
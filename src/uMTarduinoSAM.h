@@ -0,0 +1,88 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: uMTarduinoSAM.h
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+// Generate a "pendSVHook" exception
+#define GeneratePendSVHook_int()	SCB->ICSR |= SCB_ICSR_PENDSVSET_Msk
+
+#define EnableInterrupts() asm volatile ("cpsie i")
+#define DisableInterrupts() asm volatile ("cpsid i")
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+// TASK CONTEXT (the registers not stacked by the hardware exception entry)
+//
+// Cortex-M0+ (SAMD21): PUSH/POP only reach r0-r7, high registers go through low ones.
+//
+// Cortex-M4F (SAMD51): lazy FP stacking. The hardware reserves room for s0-s15 only
+// for a task which has used the FPU, and it says so clearing bit 4 of EXC_RETURN (LR).
+// That bit is the per task flag: s16-s31 are saved above the integer frame only when
+// it is clear, every other task keeps the minimal r4-r11 + LR frame.
+// A task using the FPU needs 136 more bytes of stack.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#if defined(__FPU_USED) && (__FPU_USED == 1)
+#define uMT_SAM_FPU		1
+#else
+#define uMT_SAM_FPU		0
+#endif
+
+
+#if defined(__ARM_ARCH_6M__)
+
+#define uMT_SAM_SaveContext()\
+	asm volatile (\
+		"mov   r3, lr;"\
+		"mov   r2, r11;"\
+		"mov   r1, r10;"\
+		"mov   r0, r9;"\
+		"push   {r0-r3};"\
+		"mov   r3, r8;"\
+		"mov   r2, r7;"\
+		"push   {r2-r6};")
+
+#define uMT_SAM_RestoreContext()\
+	asm volatile (\
+		"pop   {r2-r6};"\
+		"mov   r8, r3;"\
+		"mov   r7, r2;"\
+		"pop   {r0-r3};"\
+		"mov   r9, r0;"\
+		"mov   r10, r1;"\
+		"mov   r11, r2;"\
+		"mov   lr, r3;"\
+		"bx    lr;")
+
+#elif uMT_SAM_FPU==1
+
+#define uMT_SAM_SaveContext()\
+	asm volatile (\
+		"tst   lr, #0x10;"\
+		"it    eq;"\
+		"vpusheq {s16-s31};"\
+		"push  {r4-r11, lr};")
+
+#define uMT_SAM_RestoreContext()\
+	asm volatile (\
+		"pop   {r4-r11, lr};"\
+		"tst   lr, #0x10;"\
+		"it    eq;"\
+		"vpopeq {s16-s31};"\
+		"bx    lr;")
+
+#else
+
+#define uMT_SAM_SaveContext()		asm volatile ("push  {r4-r11, lr};")
+#define uMT_SAM_RestoreContext()	asm volatile ("pop   {r4-r11, lr};" "bx    lr;")
+
+#endif
+
+
+
+/////////////////////////// EOF
@@ -31,11 +31,29 @@
 ////////////////////////////////////////////////////////////////////////////////////
 #define uMT_USE_EVENTS				1			// Use Events
 #define uMT_USE_SEMAPHORES			1			// Use Semaphores
+#define uMT_USE_SEM_FASTPATH		1			// Lock free Sm_Claim()/Sm_Release() when uncontended (Cortex-M3/M4 LDREX/STREX only)
+#define uMT_USE_SEM_STATISTICS		1			// Per semaphore claims, contentions and wait time (Sm_GetInfo())
+#define uMT_USE_MUTEX				1			// Use Mutexes (owner, recursion, priority inheritance)
+#define uMT_USE_POOLS				1			// Use fixed size block memory Pools (can be used from ISR)
+#define uMT_USE_MSGQUEUES			1			// Use Message Queues
+#define uMT_USE_EVENTGROUPS			1			// Use Event Groups (shared event flags, broadcast wakeup)
+#define uMT_USE_RWLOCKS				1			// Use Readers-writer locks (writer preference)
+#define uMT_USE_RINGS				1			// Use SPSC ring buffers ISR => task (reader wakeup requires Events)
 #define uMT_USE_TIMERS				1			// Use Timers
 #define uMT_USE_RESTARTTASK			1			// Use tk_Restart()
 #define uMT_USE_PRINT_INTERNALS		1			// Setting to 0 can save 26 bytes...
 #define uMT_USE_MALLOC_REENTRANT	1			// malloc() and free() re-entrant using lock/unlock
 #define uMT_USE_TASK_STATISTICS		2			// 1=count the number of times a task has become S_RUNNING, 2=1+measure execution time 
+#define uMT_CPU_TIMESOURCE			uMT_CPUTIME_CYCLES	// Time source for uMT_USE_TASK_STATISTICS=2 (see uMTcpuTime.h)
+#define uMT_USE_TIMER_WHEEL			1			// 1=hierarchical timing wheel (O(1) insert/cancel), 0=sorted list (less RAM)
+#define uMT_USE_TICKLESS			1			// IDLE task reprograms the System Tick up to the next timer deadline
+#define uMT_USE_ISR_PREEMPTION		1			// isr_ calls switch task on interrupt return instead of at the next System Tick
+#define uMT_USE_TRACE				0			// Binary kernel trace in a RAM ring buffer (Kn_TraceDump())
+#define uMT_USE_PROFILER			0			// PC sampling at the System Tick in a RAM histogram (Kn_ProfilerDump())
+#define uMT_USE_INTOFF_PROFILER		0			// Instrumented isr_Kn_IntLock()/isr_Kn_IntUnlock(): longest INTS off windows (Kn_IntOffDump())
+#define uMT_USE_DPC					0			// Deferred ISR work (Dp_Post()) run by a kernel service task (requires Events, takes one task entry)
+#define uMT_USE_STACK_CHECK			1			// Stack high-water mark and overflow check at every task switch
+#define uMT_USE_MPU_STACK_GUARD		0			// ARDUINO DUE only: MPU fault on any access below the Running task stack
 
 
 ////////////////////////////////////////////////////////////////////////////////////
@@ -86,6 +104,35 @@
 #define uMT_MIN_SEM_NUM		uMT_MIN_TASK_NUM	// MIN number of SEMAPHORES (one for each Task)
 #define uMT_MAX_SEM_NUM		uMT_MAX_TASK_NUM	// MAX number of SEMAPHORES (one for each Task)
 
+#define uMT_MIN_MUTEX_NUM	1					// MIN number of MUTEXES
+#define uMT_MAX_MUTEX_NUM	uMT_MAX_TASK_NUM	// MAX number of MUTEXES
+
+#define uMT_MIN_POOL_NUM	1					// MIN number of memory POOLS
+#define uMT_MAX_POOL_NUM	32					// MAX number of memory POOLS
+
+#define uMT_MIN_MSGQ_NUM	1					// MIN number of MESSAGE QUEUES
+#define uMT_MAX_MSGQ_NUM	32					// MAX number of MESSAGE QUEUES
+
+#define uMT_MIN_EVGRP_NUM	1					// MIN number of EVENT GROUPS
+#define uMT_MAX_EVGRP_NUM	32					// MAX number of EVENT GROUPS
+
+#define uMT_MIN_RWLOCK_NUM	1					// MIN number of RW LOCKS
+#define uMT_MAX_RWLOCK_NUM	32					// MAX number of RW LOCKS
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT HOST BUILD (off-target testing)
+//
+// A Linux host build is selected when the Arduino IDE is NOT used (ARDUINO not defined).
+// Context switching is based on ucontext and the system tick on SIGALRM
+// (see "uMT_POSIX_SysDep.cpp", "uMT_POSIX_SysTick.cpp" and "extras/posix").
+//
+////////////////////////////////////////////////////////////////////////////////////
+#if !defined(ARDUINO) && !defined(WIN32) && defined(__linux__)
+#define uMT_POSIX
+#endif
+
 
 #ifdef WIN32
 
@@ -93,6 +140,15 @@
 
 #define uMT_DEFAULT_TASK_NUM		10		// Max task number (cannot be less than 4!!!)
 #define uMT_DEFAULT_SEM_NUM			16		// Max number of Semaphores
+#define uMT_DEFAULT_MUTEX_NUM		8		// Max number of Mutexes
+#define uMT_DEFAULT_POOL_NUM		4		// Max number of memory Pools
+#define uMT_DEFAULT_MSGQ_NUM		4		// Max number of Message Queues
+#define uMT_DEFAULT_EVGRP_NUM		4		// Max number of Event Groups
+#define uMT_DEFAULT_RWLOCK_NUM		4		// Max number of RW locks
+#define uMT_TRACE_SIZE				64		// Kernel trace records (power of 2)
+#define uMT_PROFILER_SIZE			64		// Profiler histogram slots (power of 2)
+#define uMT_DPC_QUEUE_SIZE			8		// Deferred ISR work entries
+#define uMT_DEFAULT_POOL_AREA_SIZE	1024	// Memory reserved for the Pools' blocks (bytes)
 #define uMT_DEFAULT_EVENTS_NUM		16		// How many Events per task
 
 #define uMT_MIN_STACK_SIZE			64		// MIN new application STACK size
@@ -111,12 +167,55 @@
 #define free(x)				
 #define micros()	0
 
+#elif defined(uMT_POSIX) // LINUX HOST //////////////////////////////////////////////////////////////////////////
+
+#define uMT_ALLOCATION_TYPE	uMT_VARIABLE_DYNAMIC
+
+#define uMT_DEFAULT_TASK_NUM		20		// Max task number (cannot be less than 4!!!)
+#define uMT_DEFAULT_SEM_NUM			32		// Max number of Semaphores
+#define uMT_DEFAULT_MUTEX_NUM		16		// Max number of Mutexes
+#define uMT_DEFAULT_POOL_NUM		8		// Max number of memory Pools
+#define uMT_DEFAULT_MSGQ_NUM		8		// Max number of Message Queues
+#define uMT_DEFAULT_EVGRP_NUM		8		// Max number of Event Groups
+#define uMT_DEFAULT_RWLOCK_NUM		8		// Max number of RW locks
+#define uMT_TRACE_SIZE				4096	// Kernel trace records (power of 2)
+#define uMT_PROFILER_SIZE			1024	// Profiler histogram slots (power of 2)
+#define uMT_DPC_QUEUE_SIZE			64		// Deferred ISR work entries
+#define uMT_DEFAULT_POOL_AREA_SIZE	16384	// Memory reserved for the Pools' blocks (bytes)
+#define uMT_DEFAULT_EVENTS_NUM		32		// How many Events per task
+
+// Stacks must hold a ucontext_t, a signal frame and the libc calls used by Serial
+#define uMT_MIN_STACK_SIZE			8192	// MIN new application STACK size
+#define uMT_MAX_STACK_SIZE			49152	// MAX new application STACK size
+#define uMT_DEFAULT_STACK_SIZE		16384	// DEFAULT new application STACK size
+
+#define uMT_MIN_IDLE_STACK_SIZE		8192	// MIN STACK size
+#define uMT_MAX_IDLE_STACK_SIZE		32768	// MAX IDLE task STACK size
+#define uMT_DEFAULT_IDLE_STACK_SIZE	16384	// DEFAULT IDLE task STACK size
+
+#define uMT_MIN_TID1_STACK_SIZE		uMT_MIN_STACK_SIZE	// MIN STACK size for Arduino loop() task
+#define uMT_MAX_TID1_STACK_SIZE		uMT_MAX_STACK_SIZE	// MAX STACK size for Arduino loop() task
+#define uMT_DEFAULT_TID1_STACK_SIZE	uMT_DEFAULT_STACK_SIZE	// DEFAULT STACK size for Arduino loop() task
+#define uMT_KERNEL_STACK_SIZE		16384	// uMT Kernel STACK size (bytes)
+#define uMT_STACK_SCAN_GAP			4096	// A ucontext_t has large areas never written
+#define uMT_POSIX_TICK_SIGNAL		SIGALRM	// Signal used as System Tick interrupt
+#define uMT_POSIX_SWITCH_SIGNAL		SIGUSR2	// Signal used as deferred task switch interrupt (uMT_USE_ISR_PREEMPTION)
+
 #elif defined(ARDUINO_ARCH_SAM) // ARDUINO DUE  //////////////////////////////////////////////////////////////////////////
 
 #define uMT_ALLOCATION_TYPE	uMT_VARIABLE_DYNAMIC
 
 #define uMT_DEFAULT_TASK_NUM		20		// Max task number (cannot be less than 4!!!)
 #define uMT_DEFAULT_SEM_NUM			32		// Max number of Semaphores
+#define uMT_DEFAULT_MUTEX_NUM		16		// Max number of Mutexes
+#define uMT_DEFAULT_POOL_NUM		8		// Max number of memory Pools
+#define uMT_DEFAULT_MSGQ_NUM		8		// Max number of Message Queues
+#define uMT_DEFAULT_EVGRP_NUM		8		// Max number of Event Groups
+#define uMT_DEFAULT_RWLOCK_NUM		8		// Max number of RW locks
+#define uMT_TRACE_SIZE				512	// Kernel trace records (power of 2)
+#define uMT_PROFILER_SIZE			256		// Profiler histogram slots (power of 2)
+#define uMT_DPC_QUEUE_SIZE			32		// Deferred ISR work entries
+#define uMT_DEFAULT_POOL_AREA_SIZE	4096	// Memory reserved for the Pools' blocks (bytes)
 #define uMT_DEFAULT_EVENTS_NUM		32		// How many Events per task
 
 #define uMT_MIN_STACK_SIZE			256		// MIN new application STACK size
@@ -138,6 +237,15 @@
 
 #define uMT_DEFAULT_TASK_NUM		15		// Max task number (cannot be less than 4!!!)
 #define uMT_DEFAULT_SEM_NUM			32		// Max number of Semaphores
+#define uMT_DEFAULT_MUTEX_NUM		16		// Max number of Mutexes
+#define uMT_DEFAULT_POOL_NUM		8		// Max number of memory Pools
+#define uMT_DEFAULT_MSGQ_NUM		8		// Max number of Message Queues
+#define uMT_DEFAULT_EVGRP_NUM		8		// Max number of Event Groups
+#define uMT_DEFAULT_RWLOCK_NUM		8		// Max number of RW locks
+#define uMT_TRACE_SIZE				256	// Kernel trace records (power of 2)
+#define uMT_PROFILER_SIZE			128		// Profiler histogram slots (power of 2)
+#define uMT_DPC_QUEUE_SIZE			16		// Deferred ISR work entries
+#define uMT_DEFAULT_POOL_AREA_SIZE	2048	// Memory reserved for the Pools' blocks (bytes)
 #define uMT_DEFAULT_EVENTS_NUM		32		// How many Events per task
 
 #define uMT_MIN_STACK_SIZE			256		// MIN new application STACK size
@@ -153,12 +261,24 @@
 #define uMT_DEFAULT_TID1_STACK_SIZE	uMT_DEFAULT_STACK_SIZE	// DEFAULT STACK size for Arduino loop() task
 #define uMT_KERNEL_STACK_SIZE		256		// uMT Kernel STACK size
 
+#undef uMT_USE_TICKLESS
+#define uMT_USE_TICKLESS		0		// Not supported (SysTick handler owned by the Arduino core)
+
 #elif defined(__AVR_ATmega2560__)	// ARDUINO MEGA //////////////////////////////////////////////////////////////////////////
 
 #define uMT_ALLOCATION_TYPE	uMT_VARIABLE_DYNAMIC
 
 #define uMT_DEFAULT_TASK_NUM		10		// Max task number (cannot be less than 4!!!)
 #define uMT_DEFAULT_SEM_NUM			16		// Max number of Semaphores
+#define uMT_DEFAULT_MUTEX_NUM		8		// Max number of Mutexes
+#define uMT_DEFAULT_POOL_NUM		4		// Max number of memory Pools
+#define uMT_DEFAULT_MSGQ_NUM		4		// Max number of Message Queues
+#define uMT_DEFAULT_EVGRP_NUM		4		// Max number of Event Groups
+#define uMT_DEFAULT_RWLOCK_NUM		4		// Max number of RW locks
+#define uMT_TRACE_SIZE				128	// Kernel trace records (power of 2)
+#define uMT_PROFILER_SIZE			64		// Profiler histogram slots (power of 2)
+#define uMT_DPC_QUEUE_SIZE			8		// Deferred ISR work entries
+#define uMT_DEFAULT_POOL_AREA_SIZE	1024	// Memory reserved for the Pools' blocks (bytes)
 #define uMT_DEFAULT_EVENTS_NUM		16		// How many Events per task
 
 #define uMT_MIN_STACK_SIZE			64		// MIN new application STACK size
@@ -174,6 +294,15 @@
 #define uMT_DEFAULT_TID1_STACK_SIZE	uMT_DEFAULT_STACK_SIZE	// DEFAULT STACK size for Arduino loop() task
 #define uMT_KERNEL_STACK_SIZE		64		// uMT Kernel STACK size
 
+#undef uMT_USE_TIMER_WHEEL
+#define uMT_USE_TIMER_WHEEL		0		// Save memory...
+
+#undef uMT_USE_TICKLESS
+#define uMT_USE_TICKLESS		0		// Not supported (TIMER 0 also drives millis() and PWM)
+
+#undef uMT_CPU_TIMESOURCE
+#define uMT_CPU_TIMESOURCE		uMT_CPUTIME_MICROS	// uMT_CPUTIME_CYCLES takes TIMER 1 away from the application
+
 
 #else		// ARDUINO UNO //////////////////////////////////////////////////////////////////////////
 
@@ -182,7 +311,14 @@
 
 #define uMT_DEFAULT_TASK_NUM		5		// Max task number (cannot be less than 4!!!)
 #define uMT_DEFAULT_SEM_NUM			8		// Max number of Semaphores
+#define uMT_DEFAULT_MUTEX_NUM		4		// Max number of Mutexes
+#define uMT_DEFAULT_POOL_NUM		2		// Max number of memory Pools
+#define uMT_DEFAULT_MSGQ_NUM		2		// Max number of Message Queues
+#define uMT_DEFAULT_EVGRP_NUM		2		// Max number of Event Groups
+#define uMT_DEFAULT_RWLOCK_NUM		2		// Max number of RW locks
+#define uMT_DEFAULT_POOL_AREA_SIZE	64		// Memory reserved for the Pools' blocks (bytes)
 #define uMT_DEFAULT_EVENTS_NUM		16		// How many Events per task
+#define uMT_DPC_QUEUE_SIZE			4		// Deferred ISR work entries
 
 #define uMT_MIN_STACK_SIZE			64		// MIN new application STACK size
 #define uMT_MAX_STACK_SIZE			256		// MAX new application STACK size
@@ -203,8 +339,49 @@
 #undef uMT_USE_TASK_STATISTICS
 #define uMT_USE_TASK_STATISTICS	0		// Save memory...
 
+#undef uMT_USE_TIMER_WHEEL
+#define uMT_USE_TIMER_WHEEL		0		// Save memory...
+
+#undef uMT_USE_TICKLESS
+#define uMT_USE_TICKLESS		0		// Not supported (TIMER 0 also drives millis() and PWM)
+
+#undef uMT_USE_TRACE
+#define uMT_USE_TRACE			0		// Save memory...
+
+#undef uMT_USE_PROFILER
+#define uMT_USE_PROFILER		0		// Save memory...
+
+#undef uMT_USE_SEM_STATISTICS
+#define uMT_USE_SEM_STATISTICS	0		// Save memory...
+
 #endif	
 
+#if uMT_USE_INTOFF_PROFILER==1 && uMT_USE_TASK_STATISTICS<2
+#undef uMT_USE_INTOFF_PROFILER
+#define uMT_USE_INTOFF_PROFILER	0		// Windows are measured with the CPU time source (uMTcpuTime.h)
+#endif
+
+#if uMT_USE_DPC==1 && uMT_USE_EVENTS==0
+#undef uMT_USE_DPC
+#define uMT_USE_DPC				0		// The service task sleeps on an Event
+#endif
+
+#if uMT_USE_MPU_STACK_GUARD==1 && !defined(ARDUINO_ARCH_SAM)
+#undef uMT_USE_MPU_STACK_GUARD
+#define uMT_USE_MPU_STACK_GUARD	0		// Only the Cortex-M3 of the ARDUINO DUE has an MPU
+#endif
+
+#if uMT_USE_MPU_STACK_GUARD==1
+#define uMT_MPU_GUARD_SIZE			32		// Guard region size (the smallest MPU region, aligned to its size)
+#define uMT_STACK_GUARD_SKIP		(2 * uMT_MPU_GUARD_SIZE)	// Stack bottom covering the guard region, never used by the kernel
+#else
+#define uMT_STACK_GUARD_SKIP		0
+#endif
+
+#ifndef uMT_STACK_SCAN_GAP
+#define uMT_STACK_SCAN_GAP			256		// MaxUsedStack(): stop after so many untouched stack bytes (uMT_USE_STACK_CHECK)
+#endif
+
 #ifndef uMT_DEFAULT_TIMER_AGENT_NUM
 #define uMT_MIN_TIMER_AGENT_NUM		(uMT_DEFAULT_TASK_NUM / 2)	// MIN number of AGENT Timers
 #define uMT_MAX_TIMER_AGENT_NUM		(uMT_DEFAULT_TASK_NUM * 2)	// MAX number of AGENT Timers
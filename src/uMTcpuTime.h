@@ -0,0 +1,143 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: uMTcpuTime.h
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef uMT_CPUTIME_H
+#define uMT_CPUTIME_H
+
+#if	uMT_USE_TASK_STATISTICS>=2
+
+///////////////////////////////////////////////////////////////////////////////////
+//
+//	CPU TIME SOURCE
+//
+// Free running counter read by Reschedule() at every task switch and by the System
+// Tick to account task, kernel and ISR time. It only needs to be cheap to read and
+// to count up: deltas are taken modulo 2^32, so two samples must be closer than
+// one wrap around (about 51s on SAM, 35min on AVR, 4s on a LINUX host).
+//
+//	uMT_CPUTIME_MICROS	micros(), 1 tick = 1us (4us resolution on AVR)
+//	uMT_CPUTIME_CYCLES	SAM: DWT->CYCCNT, 1 tick = 1 CPU cycle
+//						AVR: TIMER 1 free running at F_CPU/8 (PWM on the TIMER 1 pins is lost,
+//						     not the MEGA default, see uMTconfiguration.h)
+//						LINUX: clock_gettime(CLOCK_MONOTONIC), 1 tick = 1ns
+//						SAMD, WIN32: no cycle counter, same as uMT_CPUTIME_MICROS
+//	uMT_CPUTIME_USER	uMT_UserCpuTicks() and uMT_USER_CPU_TICKS_PER_US supplied by the application
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#define uMT_CPUTIME_MICROS		0
+#define uMT_CPUTIME_CYCLES		1
+#define uMT_CPUTIME_USER		2
+
+typedef uint32_t		CpuTicks_t;			// Raw CPU time source value
+
+
+#if uMT_CPU_TIMESOURCE==uMT_CPUTIME_USER ////////////////////////////////////////////
+
+extern CpuTicks_t uMT_UserCpuTicks();
+
+#define uMT_CPU_TICKS_PER_US	uMT_USER_CPU_TICKS_PER_US
+#define uMT_CpuTimeInit()
+#define uMT_CpuTicks()			uMT_UserCpuTicks()
+
+#elif uMT_CPU_TIMESOURCE==uMT_CPUTIME_CYCLES && defined(ARDUINO_ARCH_SAM) ///////////
+
+#define uMT_CPU_TICKS_PER_US	(F_CPU / 1000000)
+
+inline void uMT_CpuTimeInit()
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;		// Enable the DWT
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+#define uMT_CpuTicks()			((CpuTicks_t)DWT->CYCCNT)
+
+#elif uMT_CPU_TIMESOURCE==uMT_CPUTIME_CYCLES && defined(ARDUINO_ARCH_AVR) ///////////
+
+#if (F_CPU / 8000000) == 0
+#error "uMT_CPUTIME_CYCLES needs F_CPU >= 8MHz on AVR"
+#endif
+
+#define uMT_CPU_TICKS_PER_US	(F_CPU / 8000000)
+
+extern volatile uint16_t uMT_CpuTicksHigh;		// TIMER 1 overflows (uMT_AVR_SysDep.cpp)
+
+extern void uMT_CpuTimeInit();
+
+// Entered with INTS disabled
+inline CpuTicks_t uMT_CpuTicks()
+{
+	uint16_t Low = TCNT1;
+	uint16_t High = uMT_CpuTicksHigh;
+
+	// Overflow not yet served?
+	if ((TIFR1 & _BV(TOV1)) && Low < 0x8000)
+		High++;
+
+	return(((CpuTicks_t)High << 16) | Low);
+}
+
+#elif uMT_CPU_TIMESOURCE==uMT_CPUTIME_CYCLES && defined(uMT_POSIX) /////////////////
+
+#include <time.h>
+
+#define uMT_CPU_TICKS_PER_US	1000
+#define uMT_CpuTimeInit()
+
+inline CpuTicks_t uMT_CpuTicks()
+{
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+
+	return((CpuTicks_t)((uint64_t)Now.tv_sec * 1000000000 + Now.tv_nsec));
+}
+
+#else /////////////////////////////////////////////////////////////////////////////
+
+#define uMT_CPU_TICKS_PER_US	1
+#define uMT_CpuTimeInit()
+#define uMT_CpuTicks()			((CpuTicks_t)micros())
+
+#endif
+
+
+// CPU ticks => uSeconds
+inline uMTextendedTime uMT_CpuTicks2us(uMTextendedTime Ticks)
+{
+#if uMT_CPU_TICKS_PER_US > 1
+	return(Ticks.DivideBy(uMT_CPU_TICKS_PER_US));
+#else
+	return(Ticks);
+#endif
+}
+
+#endif
+
+#endif
+
+
+/////////////////////////////////////// EOF
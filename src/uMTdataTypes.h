@@ -81,6 +81,19 @@ typedef uint32_t		RunValue_t;			// 32 bits
 #define uMT_ALL_EVENT_MASK	(0xffffffff)	// 32 bits value
 
 
+#elif defined(uMT_POSIX) // Linux host code
+
+typedef	uintptr_t		StackPtr_t;			// Stack (64 bits on x86-64)
+typedef uint32_t		StackSize_t;		// 32 bits
+typedef uint32_t		CpuStatusReg_t;		// Set if SIGALRM was blocked - Lock/Unlock
+typedef uint32_t		Param_t;			// 32 bits
+typedef uint32_t		SemValue_t;			// 32 bits
+typedef uint32_t		RunValue_t;			// 32 bits
+
+#define uMT_MAX_SEM_VALUE	(0xffffffff)	// 32 bits value
+#define uMT_ALL_EVENT_MASK	(0xffffffff)	// 32 bits value
+
+
 #else
   #error This library only supports boards with AVR or SAM processor.
 #endif
@@ -173,6 +186,13 @@ typedef uMTobject_id	TimerId_t;			// Timer ID type
 typedef uint8_t			Bool_t;				// 8 bits
 typedef uint32_t		Timer_t;			// 32 bits
 typedef uint8_t			SemId_t;			// 8 bits, max 255
+typedef uint8_t			MutexId_t;			// 8 bits, max 255
+typedef uint8_t			PoolId_t;			// 8 bits, max 255
+typedef uint16_t		PoolSize_t;			// Pool block size and number of blocks
+typedef uint8_t			MsgQueueId_t;		// 8 bits, max 255
+typedef uint16_t		MsgSize_t;			// Message size and number of messages
+typedef uint8_t			EventGroupId_t;		// 8 bits, max 255
+typedef uint8_t			RwLockId_t;			// 8 bits, max 255
 typedef uint16_t		Cfg_data_t;			// Used in uMTcfg class
 
 
@@ -0,0 +1,192 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: uMTdpc.cpp
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include "uMT.h"
+
+#define uMT_DEBUG 0
+#include "uMTdebug.h"
+
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+//				CLASS uMT
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+
+
+
+#if uMT_USE_DPC==1
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::DpcStart
+//
+// Called at the end of Kn_Start(): it takes one task entry.
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::DpcStart()
+{
+	DpcIn = 0;
+	DpcOut = 0;
+	DpcCount = 0;
+	DpcMaxCount = 0;
+	DpcPosted = 0;
+	DpcLost = 0;
+
+	TaskPrio_t	OldPrio;
+	Errno_t		error = Tk_CreateTask(DpcLoop, DpcTid);
+
+	if (error != E_SUCCESS)
+		return(error);
+
+	error = Tk_SetPriority(DpcTid, PRIO_HIGHEST, OldPrio);
+
+	if (error != E_SUCCESS)
+		return(error);
+
+	return(Tk_StartTask(DpcTid));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::DpcLoop
+//
+// Service task: run the queued entries, then sleep until the queue is not EMPTY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+void	uMT::DpcLoop()
+{
+	Event_t	eventout;
+
+	for (;;)
+	{
+		Kernel.Ev_Receive(uMT_DPC_EVENT, uMT_ANY, &eventout);
+
+		for (;;)
+		{
+			CpuStatusReg_t	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+			if (Kernel.DpcCount == 0)
+			{
+				isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+				break;
+			}
+
+			uMTdpcEntry Entry = Kernel.DpcQueue[Kernel.DpcOut];
+
+			if (++Kernel.DpcOut == uMT_DPC_QUEUE_SIZE)
+				Kernel.DpcOut = 0;
+
+			Kernel.DpcCount--;
+
+			isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+			Entry.Func(Entry.Arg);
+		}
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::doDp_Post
+//
+// It never blocks: it can be called from ISR
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::doDp_Post(DpcFunc_t Func, void *Arg, Bool_t AllowPreemption)
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	if (Func == NULL)
+		return(E_INVALID_OPTION);
+
+	CpuStatusReg_t	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+	if (DpcCount == uMT_DPC_QUEUE_SIZE)
+	{
+		DpcLost++;
+
+		isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+		return(E_DPC_QUEUE_FULL);
+	}
+
+	uMTdpcEntry *pEntry = &DpcQueue[DpcIn];
+
+	pEntry->Func = Func;
+	pEntry->Arg = Arg;
+
+	if (++DpcIn == uMT_DPC_QUEUE_SIZE)
+		DpcIn = 0;
+
+	if (++DpcCount > DpcMaxCount)
+		DpcMaxCount = DpcCount;
+
+	DpcPosted++;
+
+	// The service task drains the queue before sleeping again: wake it up only once
+	Bool_t WakeUp = (DpcCount == 1 ? TRUE : FALSE);
+
+	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+	if (WakeUp)
+		return(doEv_Send(DpcTid, uMT_DPC_EVENT, AllowPreemption));
+
+	return(E_SUCCESS);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::Dp_GetInfo
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::Dp_GetInfo(uMTdpcInfo &Info)
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	CpuStatusReg_t	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+	Info.ServiceTid = DpcTid;
+	Info.QueueSize = uMT_DPC_QUEUE_SIZE;
+	Info.Count = DpcCount;
+	Info.MaxCount = DpcMaxCount;
+	Info.Posted = DpcPosted;
+	Info.Lost = DpcLost;
+
+	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+	return(E_SUCCESS);
+}
+
+#endif
+
+
+
+/////////////////////// EOF
@@ -0,0 +1,83 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: uMTdpc.h
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef uMT_DPC_H
+#define uMT_DPC_H
+
+#if uMT_USE_DPC==1
+
+///////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT DEFERRED PROCEDURE CALLS
+//
+// An ISR keeps only the urgent part of its work and posts the rest, a function and
+// its argument, with isr_Dp_Post(). The entries are run in FIFO order by one kernel
+// service task at PRIO_HIGHEST, created by Kn_Start(): all the interrupt sources
+// share its stack instead of having a task each. The service task is woken up with
+// uMT_DPC_EVENT only when the queue goes from EMPTY to not EMPTY.
+//
+// Functions run with INTS enabled and they can call any non blocking kernel
+// primitive; a function which blocks delays all the entries queued after it.
+// On a full queue (uMT_DPC_QUEUE_SIZE entries) the entry is dropped and counted.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#if uMT_DPC_QUEUE_SIZE > 255
+#error "uMT_DPC_QUEUE_SIZE must be less than 256"
+#endif
+
+#define uMT_DPC_EVENT		0x0001		// Service task wakeup
+
+typedef void	(*DpcFunc_t)(void *Arg);	// Deferred function
+
+class uMTdpcEntry
+{
+public:
+	DpcFunc_t	Func;
+	void		*Arg;
+};
+
+
+////////////////////////////////////////////////////
+// Returned in Dp_GetInfo()
+////////////////////////////////////////////////////
+
+class uMTdpcInfo
+{
+public:
+	TaskId_t	ServiceTid;		// Service task
+	uint8_t		QueueSize;		// Entries
+	uint8_t		Count;			// Entries queued now
+	uint8_t		MaxCount;		// Highest Count (high-water mark)
+	uint32_t	Posted;			// Entries queued since Kn_Start()
+	uint32_t	Lost;			// Entries dropped on a full queue
+};
+
+#endif
+
+#endif
+
+
+/////////////////////////////////////// EOF
@@ -57,7 +57,31 @@ enum Errno_t
 /* 18 */ E_NO_MORE_MEMORY,			// No more memory available [Tk_CreateTask()]
 /* 19 */ E_INVALID_STACK_SIZE,		// Invalid STACK size [Tk_CreateTask()]
 /* 20 */ E_INVALID_MAX_TIMER_NUM,	// Invalid max Timer number [Kn_start()]
-/* 21 */ E_INVALID_MAX_SEM_NUM		// Invalid max Semaphore number [Kn_start()]
+/* 21 */ E_INVALID_MAX_SEM_NUM,		// Invalid max Semaphore number [Kn_start()]
+/* 22 */ E_INVALID_PRIORITY,		// Invalid priority (0-15) [Tk_SetPriority()]
+/* 23 */ E_INVALID_MUTEXID,			// Invalid MUTEX Id
+/* 24 */ E_NOT_OWNED_MUTEX,			// MUTEX is not owned by this task [Mx_Unlock()]
+/* 25 */ E_OVERFLOW_MUTEX,			// MUTEX recursion counter overflow [Mx_Lock()]
+/* 26 */ E_INVALID_MAX_MUTEX_NUM,	// Invalid max Mutex number [Kn_start()]
+/* 27 */ E_INVALID_POOLID,			// Invalid POOL Id
+/* 28 */ E_NOMORE_POOLS,			// No more POOL entries available [Pl_Create()]
+/* 29 */ E_POOL_EMPTY,				// No more free blocks in the POOL [Pl_Alloc()]
+/* 30 */ E_INVALID_POOL_BLOCK,		// Block not belonging to the POOL [Pl_Free()]
+/* 31 */ E_INVALID_POOL_SIZE,		// Invalid block size or number of blocks [Pl_Create()]
+/* 32 */ E_INVALID_MAX_POOL_NUM,	// Invalid max Pool number [Kn_start()]
+/* 33 */ E_INVALID_MSGQID,			// Invalid MESSAGE QUEUE Id
+/* 34 */ E_NOMORE_MSGQS,			// No more MESSAGE QUEUE entries available [Mq_Create()]
+/* 35 */ E_INVALID_MSG_SIZE,		// Invalid message size or number of messages [Mq_Create(), Mq_SendPtr()]
+/* 36 */ E_INVALID_MAX_MSGQ_NUM,	// Invalid max Message Queue number [Kn_start()]
+/* 37 */ E_INVALID_RING_SIZE,		// Invalid ring size or item size [uMTring::Init()]
+/* 38 */ E_INVALID_EVGRPID,			// Invalid EVENT GROUP Id
+/* 39 */ E_NOMORE_EVGRPS,			// No more EVENT GROUP entries available [Eg_Create()]
+/* 40 */ E_INVALID_MAX_EVGRP_NUM,	// Invalid max Event Group number [Kn_start()]
+/* 41 */ E_INVALID_RWLOCKID,		// Invalid RW LOCK Id
+/* 42 */ E_NOMORE_RWLOCKS,			// No more RW LOCK entries available [Rw_Create()]
+/* 43 */ E_NOT_OWNED_RWLOCK,		// RW LOCK is not held [Rw_Unlock()]
+/* 44 */ E_INVALID_MAX_RWLOCK_NUM,	// Invalid max RW lock number [Kn_start()]
+/* 45 */ E_DPC_QUEUE_FULL			// Deferred procedure call queue FULL, entry dropped [Dp_Post()]
 };
 
 
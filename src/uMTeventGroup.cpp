@@ -0,0 +1,333 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: uMTeventGroup.cpp
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include "uMT.h"
+
+#define uMT_DEBUG 0
+#include "uMTdebug.h"
+
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+//				CLASS uMT
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+
+
+
+#if uMT_USE_EVENTGROUPS==1
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::Eg_Create
+//
+// Event Groups are never deleted.
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::Eg_Create(EventGroupId_t &Egid)
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	CpuStatusReg_t	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+	// Look for a free entry
+	unsigned int idx;
+
+	for (idx = 0; idx < kernelCfg.EventGroups_Num; idx++)
+	{
+		if (EgList[idx].Created == FALSE)
+			break;
+	}
+
+	if (idx >= kernelCfg.EventGroups_Num)
+	{
+		isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+		return(E_NOMORE_EVGRPS);
+	}
+
+	EgList[idx].Created = TRUE;
+	EgList[idx].Flags = uMT_NULL_EVENT;
+
+	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+	Egid = (EventGroupId_t)idx;
+
+	return(E_SUCCESS);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::EgVerified
+//
+// Entered with INTS disabled
+//
+////////////////////////////////////////////////////////////////////////////////////
+Bool_t uMT::EgVerified(Event_t Flags, uTask *pTask)
+{
+	Event_t result = pTask->EgRequested & Flags;
+
+	if (((pTask->EgCondition & uMT_ANY) && (result != 0)) /* OR condition */
+			|| (result == pTask->EgRequested) ) /* AND condition */
+	{
+		return(TRUE);
+	}
+	else
+	{
+		return(FALSE);
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::doEg_Set
+//
+// All the waiters satisfied by the new flags are made READY in this single
+// critical region. The flags requested by waiters using uMT_CLEAR are cleared
+// only after the whole queue has been scanned, so every waiter sees the same flags.
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::doEg_Set(EventGroupId_t Egid, Event_t Event, Bool_t AllowPreemption)
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	if (EgId_Check(Egid) == FALSE)
+		return(E_INVALID_EVGRPID);
+
+	uMTeventGroup *pEg = &EgList[Egid];
+
+	CpuStatusReg_t	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+	pEg->Flags |= Event;
+
+	Event_t	ClearMask = uMT_NULL_EVENT;
+	uTask	*pNext;
+
+	for (uTask *pTask = pEg->WaitQueue.Head; pTask != NULL; pTask = pNext)
+	{
+		pNext = pTask->Next;		// ReadyTask() changes it
+
+		if (EgVerified(pEg->Flags, pTask) == FALSE)
+			continue;
+
+		pTask->EgReceived = pEg->Flags;
+
+		if (pTask->EgCondition & uMT_CLEAR)
+			ClearMask |= pTask->EgRequested;
+
+		/* Now remove it from the wait queue */
+		pEg->WaitQueue.Remove(pTask);
+
+		pTask->pEgWait = NULL;		// Done, NOT any longer in the wait queue...
+
+		/* Make this task READY... */
+		ReadyTask(pTask);
+	}
+
+	pEg->Flags &= ~ClearMask;
+
+	/* ... and check for preemption, once */
+	Check4Preemption();
+
+	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+	if (AllowPreemption)
+		Check4NeedReschedule();		// Call Suspend() if NeedResched==TRUE
+	else
+		Check4IsrReschedule();		// Switch on return from interrupt if NeedResched==TRUE
+
+	return(E_SUCCESS);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::Eg_Clear
+//
+// It never blocks: it can be called from ISR
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::Eg_Clear(EventGroupId_t Egid, Event_t Event)
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	if (EgId_Check(Egid) == FALSE)
+		return(E_INVALID_EVGRPID);
+
+	CpuStatusReg_t	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+	EgList[Egid].Flags &= ~Event;
+
+	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+	return(E_SUCCESS);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::Eg_Wait
+//
+// 'flags' is uMT_ANY or uMT_ALL, plus uMT_NOWAIT not to wait and uMT_CLEAR to
+// clear the requested flags when the wait is satisfied.
+// eventin == 0 simply returns the current flags.
+// 'eventout' gets the flags which satisfied the wait (current flags on error).
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::Eg_Wait(
+	EventGroupId_t	Egid,
+	Event_t	eventin,
+	uMToptions_t	flags,
+	Event_t	*eventout
+#if uMT_USE_TIMERS==1
+	, Timer_t timeout
+#endif
+	)
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	if (EgId_Check(Egid) == FALSE)
+		return(E_INVALID_EVGRPID);
+
+	uMTeventGroup *pEg = &EgList[Egid];
+
+	CpuStatusReg_t	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+	Running->EgRequested = eventin;
+	Running->EgCondition = flags;
+
+	if (eventin == 0 || EgVerified(pEg->Flags, Running) == TRUE)
+	{
+		/* Already set, return current flags */
+		if (eventout != NULL)
+			*eventout = pEg->Flags;
+
+		if (flags & uMT_CLEAR)
+			pEg->Flags &= ~eventin;
+
+		isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+		return(E_SUCCESS);
+	}
+
+	if (flags & uMT_NOWAIT)
+	{
+		/* Task has choosen NOT to wait */
+		if (eventout != NULL)
+			*eventout = pEg->Flags;
+
+		isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+		return(E_WOULD_BLOCK);
+	}
+
+	// Insert in the wait queue
+	pEg->WaitQueue.Insert(Running);
+
+	Running->pEgWait = pEg;
+
+	Running->TaskStatus = S_SBLOCKED;
+
+
+#if uMT_USE_TIMERS==1
+	uTimer *pTimer = &Running->TaskTimer;
+
+	if (timeout != (Timer_t)0)
+	{
+		/////////////////////////////////////////////////
+		// Create a TASK TIMER to manage the timeout
+		////////////////////////////////////////////////
+		pTimer->Timeout = timeout;
+
+		pTimer->NextAlarm = msTickCounter + timeout;
+		pTimer->Flags = uMT_TM_IAM_TASK;	// To reset other flags
+
+		Running->TaskStatus = S_TBLOCKED;	// TIMER BLOCKED
+
+		TimerQ_Insert(pTimer);
+	}
+#endif
+
+
+	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+	//////////////////////////////////////////////////////////
+	// Suspend task and generate a rescheduling.
+	// It will "return" only when this task is S_RUNNING again
+	///////////////////////////////////////////////////////////
+	Suspend();
+
+	// Note: When control comes back, EgReceived is already set
+	// unless the timeout is expired.
+
+#if uMT_USE_TIMERS==1
+	if (timeout != (Timer_t)0)		// A timer was set?
+	{
+		CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+		// Timeout expired?
+		if (pTimer->Flags & uMT_TM_EXPIRED)
+		{
+			// Flags set in time?
+			if (Running->pEgWait != NULL)
+			{
+				// No chance... (already removed from the wait queue in Reschedule())
+				Running->pEgWait = NULL;
+
+				if (eventout != NULL)
+					*eventout = pEg->Flags;
+
+				isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+				return(E_TIMEOUT);	/* Return error if any */
+			}
+		}
+		else
+		{
+			// Flags set, cancel the timer
+			if (TimerQ_CancelTimer(pTimer) != E_SUCCESS)
+				isr_Kn_FatalError(F("TimerQ_CancelTimer: Timer not found!"));
+		}
+
+		isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+	}
+#endif
+
+	if (eventout != NULL)
+		*eventout = Running->EgReceived;
+
+	return(E_SUCCESS);
+}
+
+#endif
+
+
+
+/////////////////////// EOF
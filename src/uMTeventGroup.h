@@ -0,0 +1,63 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: uMTeventGroup.h
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef uMT_EVENTGROUP_H
+#define uMT_EVENTGROUP_H
+
+#if uMT_USE_EVENTGROUPS==1
+
+///////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT EVENT GROUP
+//
+// A set of event flags not owned by any task. Any number of tasks can wait on it
+// with ANY/ALL logic: a single Eg_Set() makes READY all the waiters it satisfies
+// inside one critical region. Flags stay set until cleared by Eg_Clear() or by a
+// waiter using uMT_CLEAR.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+class uMTeventGroup
+{
+	friend class uMT;
+
+	Bool_t			Created;	// TRUE if created by Eg_Create()
+	Event_t			Flags;		// Event flags currently set
+	uMTtaskQueue	WaitQueue;	// Tasks waiting for some flags
+
+	void Init()
+	{
+		Created = FALSE;		// Not created
+		Flags = uMT_NULL_EVENT;
+		WaitQueue.Init();
+	};
+};
+
+
+#endif
+
+#endif
+
+
+/////////////////////////////////////// EOF
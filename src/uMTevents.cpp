@@ -111,6 +111,8 @@ Errno_t uMT::doEv_Send(TaskId_t Tid, Event_t Event, Bool_t AllowPreemption)
 
 	CpuStatusReg_t CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
 
+	uMT_TRACE(TR_EV_SEND, pTask->myTid.GetID(), Event);
+
 	// Check for pending events
 	EventSend(pTask, Event);
 
@@ -118,6 +120,8 @@ Errno_t uMT::doEv_Send(TaskId_t Tid, Event_t Event, Bool_t AllowPreemption)
 
 	if (AllowPreemption)
 		Check4NeedReschedule();		// Call Suspend() if NeedResched==TRUE
+	else
+		Check4IsrReschedule();		// Switch on return from interrupt if NeedResched==TRUE
 
    return(E_SUCCESS);
 }
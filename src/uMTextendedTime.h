@@ -63,7 +63,7 @@ public:
 		uMTextendedTime tmp;
 
 		tmp.Low = Low + Value;
-		tmp.High = 0;
+		tmp.High = High;
 
 		if (tmp.Low < Value)
 			tmp.High++;
@@ -0,0 +1,190 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: uMTintOff.cpp
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include "uMT.h"
+
+#define uMT_DEBUG 0
+#include "uMTdebug.h"
+
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+//				CLASS uMT
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+
+
+
+
+#if uMT_USE_INTOFF_PROFILER==1
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::isr_Kn_IntLock - INSTRUMENTED
+//
+// A window opens only if INTS were enabled. Not inlined: the return address is
+// the call site.
+//
+////////////////////////////////////////////////////////////////////////////////////
+CpuStatusReg_t __attribute__((noinline)) uMT::isr_Kn_IntLock()
+{
+	CpuStatusReg_t CpuFlags = IntLockRaw();
+
+	if (Kernel.IntOffOn == TRUE && uMT_INTS_WERE_ENABLED(CpuFlags))
+	{
+		Kernel.IntOffSite = (IntOffSite_t)__builtin_return_address(0);
+		Kernel.IntOffStart = uMT_CpuTicks();
+	}
+
+	return(CpuFlags);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::isr_Kn_IntUnlock - INSTRUMENTED
+//
+////////////////////////////////////////////////////////////////////////////////////
+void __attribute__((noinline)) uMT::isr_Kn_IntUnlock(CpuStatusReg_t Flags)
+{
+	if (uMT_INTS_WERE_ENABLED(Flags))
+		Kernel.IntOffClose(uMT_CpuTicks());
+
+	IntUnlockRaw(Flags);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::IntOffClose
+//
+// Count the open window in the histogram and keep it if it is one of the longest:
+// the entry of its call site is updated, otherwise it replaces the shortest entry.
+//
+// Entered with INTS disabled
+//
+////////////////////////////////////////////////////////////////////////////////////
+void	uMT::IntOffClose(CpuTicks_t Now)
+{
+	if (IntOffSite == 0)
+		return;
+
+	IntOffSite_t Site = IntOffSite;
+	CpuTicks_t Ticks = Now - IntOffStart;
+
+	IntOffSite = 0;
+
+	if (IntOffOn == FALSE)
+		return;
+
+	IntOffWindows++;
+
+	uint8_t Bucket = 0;
+
+	while (Bucket < uMT_INTOFF_BUCKETS - 1 && (Ticks >> (Bucket + 1)) != 0)
+		Bucket++;
+
+	IntOffHist[Bucket]++;
+
+	uMTintOffSite *pShortest = &IntOffTop[0];
+
+	for (uint8_t Idx = 0; Idx < uMT_INTOFF_TOP; Idx++)
+	{
+		uMTintOffSite *pTop = &IntOffTop[Idx];
+
+		if (pTop->Site == Site)
+		{
+			pTop->Count++;
+
+			if (Ticks > pTop->MaxTicks)
+				pTop->MaxTicks = Ticks;
+
+			return;
+		}
+
+		if (pTop->MaxTicks < pShortest->MaxTicks)
+			pShortest = pTop;
+	}
+
+	if (pShortest->Site == 0 || Ticks > pShortest->MaxTicks)
+	{
+		pShortest->Site = Site;
+		pShortest->MaxTicks = Ticks;
+		pShortest->Count = 1;
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::Kn_IntOffStart
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::Kn_IntOffStart()
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	CpuStatusReg_t	CpuFlags = IntLockRaw();	/* Enter critical region (not measured) */
+
+	for (uint8_t Idx = 0; Idx < uMT_INTOFF_TOP; Idx++)
+	{
+		IntOffTop[Idx].Site = 0;
+		IntOffTop[Idx].MaxTicks = 0;
+		IntOffTop[Idx].Count = 0;
+	}
+
+	for (uint8_t Bucket = 0; Bucket < uMT_INTOFF_BUCKETS; Bucket++)
+		IntOffHist[Bucket] = 0;
+
+	IntOffWindows = 0;
+	IntOffSite = 0;
+	IntOffOn = TRUE;
+
+	IntUnlockRaw(CpuFlags);	/* End of critical region */
+
+	return(E_SUCCESS);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::Kn_IntOffStop
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::Kn_IntOffStop()
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	IntOffOn = FALSE;
+
+	return(E_SUCCESS);
+}
+
+#endif
+
+
+
+/////////////////////// EOF
@@ -0,0 +1,81 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: uMTintOff.h
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef uMT_INTOFF_H
+#define uMT_INTOFF_H
+
+#if uMT_USE_INTOFF_PROFILER==1
+
+///////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT INTERRUPTS OFF PROFILER
+//
+// Instrumented build: isr_Kn_IntLock() opens a window when it disables INTS which
+// were enabled and isr_Kn_IntUnlock() closes it when it enables them again. Nested
+// pairs (and ISRs, entered with INTS already disabled) are part of the outer window.
+// A window ended by a task switch instead (e.g., Tk_DeleteTask() of itself) is
+// closed in Reschedule().
+//
+// Every window is counted in a log2 histogram of CPU ticks (see uMTcpuTime.h) and
+// the longest ones are kept, one per call site (the return address of
+// isr_Kn_IntLock()). Kn_IntOffDump() prints them to Serial and
+// extras/profile/uMTintoff.py maps the call sites to functions.
+//
+// The bookkeeping runs with INTS disabled: it makes the real windows a little
+// longer than the measured ones.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#define uMT_INTOFF_TOP			8		// Call sites with the longest windows
+#define uMT_INTOFF_BUCKETS		24		// Histogram: bucket N counts windows of 2^N..2^(N+1)-1 CPU ticks
+
+#if defined(uMT_POSIX)
+typedef uintptr_t	IntOffSite_t;		// Call site
+#else
+typedef uint32_t	IntOffSite_t;		// Call site (word address on AVR)
+#endif
+
+// Flags returned by isr_Kn_IntLock(): were INTS enabled?
+#if defined(ARDUINO_ARCH_AVR)
+#define uMT_INTS_WERE_ENABLED(Flags)	(((Flags) & _BV(SREG_I)) != 0)
+#elif defined(ARDUINO_ARCH_SAM) || defined(ARDUINO_ARCH_SAMD)
+#define uMT_INTS_WERE_ENABLED(Flags)	(((Flags) & 1) == 0)		// PRIMASK
+#else
+#define uMT_INTS_WERE_ENABLED(Flags)	((Flags) == 0)
+#endif
+
+class uMTintOffSite
+{
+public:
+	IntOffSite_t	Site;			// isr_Kn_IntLock() return address, 0 if the entry is free
+	CpuTicks_t		MaxTicks;		// Longest window
+	uint32_t		Count;			// Windows since the entry was taken
+};
+
+#endif
+
+#endif
+
+
+/////////////////////////////////////// EOF
@@ -40,6 +40,16 @@ class roCfg
 public:
 	Bool_t		Use_Events;				// Readonly
 	Bool_t		Use_Semaphores;			// Readonly
+	Bool_t		Use_Mutexes;			// Readonly
+	Bool_t		Use_Pools;				// Readonly
+	Bool_t		Use_MsgQueues;			// Readonly
+	Bool_t		Use_EventGroups;		// Readonly
+	Bool_t		Use_RwLocks;			// Readonly
+	Bool_t		Use_Rings;				// Readonly
+	Bool_t		Use_Trace;				// Readonly
+	Bool_t		Use_Profiler;			// Readonly
+	Bool_t		Use_IntOffProfiler;		// Readonly
+	Bool_t		Use_Dpc;				// Readonly
 	Bool_t		Use_Timers;				// Readonly
 	Bool_t		Use_RestartTask;		// Readonly
 	Bool_t		Use_PrintInternals;		// Readonly
@@ -58,6 +68,16 @@ public:
 	{
 		Use_Events			= uMT_USE_EVENTS;
 		Use_Semaphores		= uMT_USE_SEMAPHORES;
+		Use_Mutexes			= uMT_USE_MUTEX;
+		Use_Pools			= uMT_USE_POOLS;
+		Use_MsgQueues		= uMT_USE_MSGQUEUES;
+		Use_EventGroups		= uMT_USE_EVENTGROUPS;
+		Use_RwLocks			= uMT_USE_RWLOCKS;
+		Use_Rings			= uMT_USE_RINGS;
+		Use_Trace			= uMT_USE_TRACE;
+		Use_Profiler		= uMT_USE_PROFILER;
+		Use_IntOffProfiler	= uMT_USE_INTOFF_PROFILER;
+		Use_Dpc				= uMT_USE_DPC;
 		Use_Timers			= uMT_USE_TIMERS;
 		Use_RestartTask		= uMT_USE_RESTARTTASK;
 		Use_PrintInternals	= uMT_USE_PRINT_INTERNALS;
@@ -81,6 +101,12 @@ class rwCfg
 public:
 	Cfg_data_t	Tasks_Num;				// Max task number (cannot be less than 3!!!)
 	Cfg_data_t	Semaphores_Num;			// Max number of Semaphores
+	Cfg_data_t	Mutexes_Num;			// Max number of Mutexes
+	Cfg_data_t	Pools_Num;				// Max number of memory Pools
+	Cfg_data_t	PoolArea_Size;			// Memory reserved at Kn_Start() for the Pools' blocks
+	Cfg_data_t	MsgQueues_Num;			// Max number of Message Queues
+	Cfg_data_t	EventGroups_Num;		// Max number of Event Groups
+	Cfg_data_t	RwLocks_Num;			// Max number of RW locks
 	Cfg_data_t	AgentTimers_Num;		// Max number of AGENT Timers
 	Cfg_data_t	AppTasks_Stack_Size;	// STACK size for all the newly created tasks
 	Cfg_data_t	Task1_Stack_Size;		// STACK size for Arduino loop() task
@@ -95,6 +121,12 @@ volatile Bool_t	TimeSharingEnabled;		// It controls TimeSharing
 	{
 		Tasks_Num			= uMT_DEFAULT_TASK_NUM;
 		Semaphores_Num		= uMT_DEFAULT_SEM_NUM;
+		Mutexes_Num			= uMT_DEFAULT_MUTEX_NUM;
+		Pools_Num			= uMT_DEFAULT_POOL_NUM;
+		PoolArea_Size		= uMT_DEFAULT_POOL_AREA_SIZE;
+		MsgQueues_Num		= uMT_DEFAULT_MSGQ_NUM;
+		EventGroups_Num		= uMT_DEFAULT_EVGRP_NUM;
+		RwLocks_Num			= uMT_DEFAULT_RWLOCK_NUM;
 		AgentTimers_Num		= uMT_DEFAULT_TIMER_AGENT_NUM;
 		AppTasks_Stack_Size	= uMT_DEFAULT_STACK_SIZE;
 		Task1_Stack_Size	= uMT_DEFAULT_TID1_STACK_SIZE;
@@ -81,11 +81,15 @@ void 	uMT::SetupStackGuard(uTask *	pTask)
 
 	StackGuardPtr = (StackGuard_t *)StackPtr;
 
-	while (StackGuardPtr >= (StackGuard_t *)pTask->StackBaseAddr)
+	// With uMT_USE_MPU_STACK_GUARD the bottom of the stack is the MPU guard region
+	while (StackGuardPtr >= (StackGuard_t *)(pTask->StackBaseAddr + uMT_STACK_GUARD_SKIP))
 	{
 		*StackGuardPtr-- = uMT_STACK_GUARD_MARK;
 	}
-	
+
+#if uMT_USE_STACK_CHECK==1
+	pTask->StackHighWater = 0;
+#endif
 }
 
 #if uMT_ALLOCATION_TYPE==uMT_FIXED_STATIC
@@ -335,6 +339,36 @@ Errno_t	uMT::doStart()
 		return(E_INVALID_MAX_SEM_NUM);
 #endif
 
+#if uMT_USE_MUTEX==1
+	if (kernelCfg.Mutexes_Num < uMT_MIN_MUTEX_NUM ||
+		kernelCfg.Mutexes_Num > uMT_MAX_MUTEX_NUM)
+		return(E_INVALID_MAX_MUTEX_NUM);
+#endif
+
+#if uMT_USE_POOLS==1
+	if (kernelCfg.Pools_Num < uMT_MIN_POOL_NUM ||
+		kernelCfg.Pools_Num > uMT_MAX_POOL_NUM)
+		return(E_INVALID_MAX_POOL_NUM);
+#endif
+
+#if uMT_USE_MSGQUEUES==1
+	if (kernelCfg.MsgQueues_Num < uMT_MIN_MSGQ_NUM ||
+		kernelCfg.MsgQueues_Num > uMT_MAX_MSGQ_NUM)
+		return(E_INVALID_MAX_MSGQ_NUM);
+#endif
+
+#if uMT_USE_EVENTGROUPS==1
+	if (kernelCfg.EventGroups_Num < uMT_MIN_EVGRP_NUM ||
+		kernelCfg.EventGroups_Num > uMT_MAX_EVGRP_NUM)
+		return(E_INVALID_MAX_EVGRP_NUM);
+#endif
+
+#if uMT_USE_RWLOCKS==1
+	if (kernelCfg.RwLocks_Num < uMT_MIN_RWLOCK_NUM ||
+		kernelCfg.RwLocks_Num > uMT_MAX_RWLOCK_NUM)
+		return(E_INVALID_MAX_RWLOCK_NUM);
+#endif
+
 
 #if uMT_ALLOCATION_TYPE==uMT_VARIABLE_DYNAMIC
 
@@ -381,7 +415,18 @@ Errno_t	uMT::doStart()
 #endif
 
 	AlarmExpired = FALSE;
+#if uMT_USE_TIMER_WHEEL==1
+	for (unsigned int idx = 0; idx < uMT_WHEEL_SLOTS; idx++)
+		WheelHead[idx] = NULL;
+
+	for (unsigned int idx = 0; idx < uMT_WHEEL_LEVELS; idx++)
+		WheelMap[idx] = 0;
+
+	WheelTime = msTickCounter;
+	WheelDeadline = WheelTime + uMT_TM_NO_DEADLINE;
+#else
 	TimerQueue = NULL;
+#endif
 	TotTimerQueued = 0;
 
 	//
@@ -401,6 +446,11 @@ Errno_t	uMT::doStart()
 #endif
 
 	msTickCounter.Clear();			// Kernel tick counter
+	TickInterrupts = 0;
+
+#if uMT_USE_TICKLESS==1
+	TicksSkipped = 0;
+#endif
 
 
 	// Init Task List (all tasks)
@@ -429,6 +479,9 @@ Errno_t	uMT::doStart()
 	// Setup Idle task
 	IdleTaskPtr->TaskStatus = S_READY;		// Always ready!
 	IdleTaskPtr->Priority = PRIO_LOWEST;
+#if uMT_USE_MUTEX==1
+	IdleTaskPtr->BasePriority = PRIO_LOWEST;
+#endif
 	IdleTaskPtr->SavedSP = NewTask(IdleTaskPtr->StackBaseAddr, IdleTaskPtr->StackSize, IdleLoop, BadExit);
 #if uMT_USE_RESTARTTASK==1
 	// Store start address
@@ -448,6 +501,9 @@ Errno_t	uMT::doStart()
 	Running->SavedSP = Kn_GetSP();
 	Running->TaskStatus = S_RUNNING;
 	Running->Priority = PRIO_NORMAL;
+#if uMT_USE_MUTEX==1
+	Running->BasePriority = PRIO_NORMAL;
+#endif
 	TimeSlice = uMT_TICKS_TIMESHARING; // Load
 #if uMT_USE_RESTARTTASK==1
 	// Store start address
@@ -475,6 +531,104 @@ Errno_t	uMT::doStart()
 
 	SemList[CLIB_SEM].SemValue = 1;		// CLIB semaphore is initialized to FREE...
 
+#endif
+
+#if uMT_USE_MUTEX==1
+
+#if uMT_ALLOCATION_TYPE==uMT_VARIABLE_DYNAMIC
+	// Allocate space for Mutex
+	MxList = new uMTmutex[kernelCfg.Mutexes_Num];
+
+	if (MxList == NULL)
+		return(E_NO_MORE_MEMORY);
+
+#endif
+
+	// Init Mutex List (all FREE)
+	for (unsigned int idx = 0; idx < kernelCfg.Mutexes_Num; idx++)
+	{
+		MxList[idx].Init();	// Init
+	}
+
+#endif
+
+#if uMT_USE_POOLS==1
+
+#if uMT_ALLOCATION_TYPE==uMT_VARIABLE_DYNAMIC
+	// Allocate space for Pools and reserve the area for their blocks (carved out by Pl_Create())
+	PlList = new uMTpool[kernelCfg.Pools_Num];
+
+	if (PlList == NULL)
+		return(E_NO_MORE_MEMORY);
+
+	PlArea = (kernelCfg.PoolArea_Size == 0 ? NULL : (uint8_t *)uMTmalloc(kernelCfg.PoolArea_Size));
+
+	if (PlArea == NULL && kernelCfg.PoolArea_Size != 0)
+		return(E_NO_MORE_MEMORY);
+#endif
+
+	// Init Pool List (all not created)
+	for (unsigned int idx = 0; idx < kernelCfg.Pools_Num; idx++)
+	{
+		PlList[idx].Init();	// Init
+	}
+
+	PlAreaUsed = 0;
+
+#endif
+
+#if uMT_USE_MSGQUEUES==1
+
+#if uMT_ALLOCATION_TYPE==uMT_VARIABLE_DYNAMIC
+	// Allocate space for Message Queues (slots are allocated by Mq_Create())
+	MqList = new uMTmsgQueue[kernelCfg.MsgQueues_Num];
+
+	if (MqList == NULL)
+		return(E_NO_MORE_MEMORY);
+#endif
+
+	// Init Message Queue List (all not created)
+	for (unsigned int idx = 0; idx < kernelCfg.MsgQueues_Num; idx++)
+	{
+		MqList[idx].Init();	// Init
+	}
+
+#endif
+
+#if uMT_USE_EVENTGROUPS==1
+
+#if uMT_ALLOCATION_TYPE==uMT_VARIABLE_DYNAMIC
+	// Allocate space for Event Groups
+	EgList = new uMTeventGroup[kernelCfg.EventGroups_Num];
+
+	if (EgList == NULL)
+		return(E_NO_MORE_MEMORY);
+#endif
+
+	// Init Event Group List (all not created)
+	for (unsigned int idx = 0; idx < kernelCfg.EventGroups_Num; idx++)
+	{
+		EgList[idx].Init();	// Init
+	}
+
+#endif
+
+#if uMT_USE_RWLOCKS==1
+
+#if uMT_ALLOCATION_TYPE==uMT_VARIABLE_DYNAMIC
+	// Allocate space for RW locks
+	RwList = new uMTrwLock[kernelCfg.RwLocks_Num];
+
+	if (RwList == NULL)
+		return(E_NO_MORE_MEMORY);
+#endif
+
+	// Init RW lock List (all not created)
+	for (unsigned int idx = 0; idx < kernelCfg.RwLocks_Num; idx++)
+	{
+		RwList[idx].Init();	// Init
+	}
+
 #endif
 
 	// Now KERNEL inited....
@@ -483,21 +637,44 @@ Errno_t	uMT::doStart()
 	// Not in Kernel mode
 	KernelStackMode = FALSE;
 
-	// Setup SYSTEM TICK
-	SetupSysTicks();
+#if uMT_USE_TRACE==1
+	TraceIn = 0;
+	TraceCount = 0;
+	TraceOn = FALSE;		// Kn_TraceStart()
+#endif
+
+#if uMT_USE_INTOFF_PROFILER==1
+	IntOffOn = FALSE;		// Kn_IntOffStart()
+#endif
+
+#if uMT_USE_PROFILER==1
+	ProfOn = FALSE;			// Kn_ProfilerStart()
+#if defined(ARDUINO_ARCH_SAM) || defined(ARDUINO_ARCH_SAMD)
+	ProfPending = FALSE;
+#endif
+#endif
 
 #if	uMT_USE_TASK_STATISTICS>=2
-	usKernelRunningTime.Clear();
+	uMT_CpuTimeInit();
 
-	Running->usRunningTime.Low = micros();
+	CpuKernelTime.Clear();
+	CpuIsrTime.Clear();
+	CpuTotalTime.Clear();
+	CpuIsrSlice = 0;
 
 	// Remember startime
-	usUserStartTime = micros();
-
+	CpuUserStartTime = uMT_CpuTicks();
 #endif
 
+	// Setup SYSTEM TICK
+	SetupSysTicks();
 
+#if uMT_USE_DPC==1
+	// Deferred procedure calls service task
+	return(DpcStart());
+#else
 	return(E_SUCCESS);
+#endif
 }
 
 
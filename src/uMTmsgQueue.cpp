@@ -0,0 +1,350 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: uMTmsgQueue.cpp
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <string.h>
+
+#include "uMT.h"
+
+#define uMT_DEBUG 0
+#include "uMTdebug.h"
+
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+//				CLASS uMT
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+
+
+
+#if uMT_USE_MSGQUEUES==1
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::Mq_Create
+//
+// The slots are allocated with uMTmalloc() before entering the critical region.
+// Queues are permanent: there is no Mq_Delete(), the slots are never released.
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::Mq_Create(MsgSize_t MsgSize, MsgSize_t MsgNum, MsgQueueId_t &Mqid)
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	if (MsgSize == 0 || MsgNum == 0)
+		return(E_INVALID_MSG_SIZE);
+
+	uint8_t *Buffer = (uint8_t *)uMTmalloc((size_t)MsgSize * MsgNum);
+
+	if (Buffer == NULL)
+		return(E_NO_MORE_MEMORY);
+
+	CpuStatusReg_t	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+	// Look for a free entry
+	unsigned int idx;
+
+	for (idx = 0; idx < kernelCfg.MsgQueues_Num; idx++)
+	{
+		if (MqList[idx].Buffer == NULL)
+			break;
+	}
+
+	if (idx >= kernelCfg.MsgQueues_Num)
+	{
+		isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+		uMTfree(Buffer);
+
+		return(E_NOMORE_MSGQS);
+	}
+
+	uMTmsgQueue *pMq = &MqList[idx];
+
+	pMq->Buffer = Buffer;
+	pMq->MsgSize = MsgSize;
+	pMq->MsgNum = MsgNum;
+
+	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+	Mqid = (MsgQueueId_t)idx;
+
+	return(E_SUCCESS);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::MqWakeup
+//
+// The first waiting task has already got its message (or slot): make it READY.
+//
+// Entered with INTS disabled
+//
+////////////////////////////////////////////////////////////////////////////////////
+void	uMT::MqWakeup(uMTtaskQueue *pWaitq)
+{
+	/* Now remove it from the Send/Recv queue */
+	uTask	*pTask = pWaitq->GetFirst();
+
+	pTask->pMqWaitq = NULL;		// Done, NOT any longer in the Send/Recv queue...
+
+	/* Make this task READY... */
+	ReadyTask(pTask);
+
+	/* ... and check for preemption */
+	Check4Preemption();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::MqWait
+//
+// Block the Running task in the Send or Recv queue, pMsg is the message to send
+// or the buffer where to receive. The message is transferred by the task
+// which makes this task READY again.
+//
+// Entered with INTS disabled, it returns with INTS enabled
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::MqWait(uMTtaskQueue *pWaitq, void *pMsg, Timer_t timeout, CpuStatusReg_t CpuFlags)
+{
+	// Insert in the Send/Recv queue
+	pWaitq->Insert(Running);
+
+	// Remember the Queue and the message
+	Running->pMqWaitq = pWaitq;
+	Running->pMqMsg = pMsg;
+
+	Running->TaskStatus = S_SBLOCKED;
+
+
+#if uMT_USE_TIMERS==1
+	uTimer *pTimer = &Running->TaskTimer;
+
+	if (timeout != (Timer_t)0)
+	{
+		/////////////////////////////////////////////////
+		// Create a TASK TIMER to manage the timeout
+		////////////////////////////////////////////////
+		pTimer->Timeout = timeout;
+
+		pTimer->NextAlarm = msTickCounter + timeout;
+		pTimer->Flags = uMT_TM_IAM_TASK;	// To reset other flags
+
+		Running->TaskStatus = S_TBLOCKED;	// TIMER BLOCKED
+
+		TimerQ_Insert(pTimer);
+	}
+#endif
+
+
+	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+	//////////////////////////////////////////////////////////
+	// Suspend task and generate a rescheduling.
+	// It will "return" only when this task is S_RUNNING again
+	///////////////////////////////////////////////////////////
+	Suspend();
+
+	// Note: When control comes back, the message is already transferred
+	// unless the timeout is expired.
+
+#if uMT_USE_TIMERS==1
+	if (timeout != (Timer_t)0)		// A timer was set?
+	{
+		CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+		// Timeout expired?
+		if (pTimer->Flags & uMT_TM_EXPIRED)
+		{
+			// Message transferred?
+			if (Running->pMqWaitq != NULL)
+			{
+				// No chance... (already removed from the Send/Recv queue in Reschedule())
+				Running->pMqWaitq = NULL;
+
+				isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+				return(E_TIMEOUT);	/* Return error if any */
+			}
+		}
+		else
+		{
+			// Message transferred, cancel the timer
+			if (TimerQ_CancelTimer(pTimer) != E_SUCCESS)
+				isr_Kn_FatalError(F("TimerQ_CancelTimer: Timer not found!"));
+		}
+
+		isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+	}
+#endif
+
+	return(E_SUCCESS);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::doMq_Send
+//
+// Size is 0 or it must match the queue message size
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::doMq_Send(MsgQueueId_t Mqid, const void *pMsg, MsgSize_t Size, uMToptions_t Options, Timer_t timeout, Bool_t AllowPreemption)
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	if (MqId_Check(Mqid) == FALSE)
+		return(E_INVALID_MSGQID);
+
+	uMTmsgQueue *pMq = &MqList[Mqid];
+
+	if (Size != 0 && Size != pMq->MsgSize)
+		return(E_INVALID_MSG_SIZE);
+
+	CpuStatusReg_t	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+	// Any task waiting for a message? (queue EMPTY)
+	if (pMq->RecvQueue.Head != NULL)
+	{
+		// Straight to its buffer
+		memcpy(pMq->RecvQueue.Head->pMqMsg, pMsg, pMq->MsgSize);
+
+		MqWakeup(&pMq->RecvQueue);
+	}
+	else if (pMq->Count < pMq->MsgNum)
+	{
+		memcpy(&pMq->Buffer[(size_t)pMq->In * pMq->MsgSize], pMsg, pMq->MsgSize);
+
+		if (++pMq->In == pMq->MsgNum)
+			pMq->In = 0;
+
+		if (++pMq->Count > pMq->MaxCount)
+			pMq->MaxCount = pMq->Count;
+	}
+	else
+	{
+		////////////////////////////////////////////
+		// Queue is FULL
+		////////////////////////////////////////////
+		if (Options == uMT_NOWAIT)
+		{
+			isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+			return(E_WOULD_BLOCK);
+		}
+
+		// The message is copied in the queue by Mq_Receive()
+		return(MqWait(&pMq->SendQueue, (void *)pMsg, timeout, CpuFlags));
+	}
+
+	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+	if (AllowPreemption)
+		Check4NeedReschedule();		// Call Suspend() if NeedResched==TRUE
+	else
+		Check4IsrReschedule();		// Switch on return from interrupt if NeedResched==TRUE
+
+	return(E_SUCCESS);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::doMq_Receive
+//
+// Size is 0 or it must match the queue message size
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::doMq_Receive(MsgQueueId_t Mqid, void *pMsg, MsgSize_t Size, uMToptions_t Options, Timer_t timeout, Bool_t AllowPreemption)
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	if (MqId_Check(Mqid) == FALSE)
+		return(E_INVALID_MSGQID);
+
+	uMTmsgQueue *pMq = &MqList[Mqid];
+
+	if (Size != 0 && Size != pMq->MsgSize)
+		return(E_INVALID_MSG_SIZE);
+
+	CpuStatusReg_t	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+	if (pMq->Count == 0)
+	{
+		////////////////////////////////////////////
+		// Queue is EMPTY
+		////////////////////////////////////////////
+		if (Options == uMT_NOWAIT)
+		{
+			isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+			return(E_WOULD_BLOCK);
+		}
+
+		// The message is copied in pMsg by Mq_Send()
+		return(MqWait(&pMq->RecvQueue, pMsg, timeout, CpuFlags));
+	}
+
+	memcpy(pMsg, &pMq->Buffer[(size_t)pMq->Out * pMq->MsgSize], pMq->MsgSize);
+
+	if (++pMq->Out == pMq->MsgNum)
+		pMq->Out = 0;
+
+	// Any task waiting for a free slot? (queue was FULL)
+	if (pMq->SendQueue.Head != NULL)
+	{
+		// Its message takes the slot just freed (FIFO order is kept)
+		memcpy(&pMq->Buffer[(size_t)pMq->In * pMq->MsgSize], pMq->SendQueue.Head->pMqMsg, pMq->MsgSize);
+
+		if (++pMq->In == pMq->MsgNum)
+			pMq->In = 0;
+
+		MqWakeup(&pMq->SendQueue);
+	}
+	else
+	{
+		pMq->Count--;
+	}
+
+	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+	if (AllowPreemption)
+		Check4NeedReschedule();		// Call Suspend() if NeedResched==TRUE
+	else
+		Check4IsrReschedule();		// Switch on return from interrupt if NeedResched==TRUE
+
+	return(E_SUCCESS);
+}
+
+#endif
+
+
+
+/////////////////////// EOF
@@ -0,0 +1,77 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: uMTmsgQueue.h
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef uMT_MSGQUEUE_H
+#define uMT_MSGQUEUE_H
+
+#if uMT_USE_MSGQUEUES==1
+
+///////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT MESSAGE QUEUE
+//
+// A ring of MsgNum slots of MsgSize bytes. Messages are copied in and out of the
+// slots; when a task is already waiting, the message is copied straight to its
+// buffer. To pass buffers without copying them (e.g., blocks of a memory Pool)
+// create the queue with MsgSize = sizeof(void *) and use Mq_SendPtr()/Mq_ReceivePtr().
+// Queues cannot be deleted: plan kernelCfg.MsgQueues_Num for all of them.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+class uMTmsgQueue
+{
+	friend class uTask;
+	friend class uMT;
+
+	uint8_t			*Buffer;	// Message slots, NULL if the queue is not created
+	MsgSize_t		MsgSize;	// Slot size
+	MsgSize_t		MsgNum;		// Number of slots
+	MsgSize_t		Count;		// Messages in the queue
+	MsgSize_t		MaxCount;	// Highest Count (high-water mark)
+	MsgSize_t		In;			// Next slot to write
+	MsgSize_t		Out;		// Next slot to read
+	uMTtaskQueue	RecvQueue;	// Tasks waiting for a message (queue EMPTY)
+	uMTtaskQueue	SendQueue;	// Tasks waiting for a free slot (queue FULL)
+
+	void Init()
+	{
+		Buffer = NULL;			// Not created
+		MsgSize = 0;
+		MsgNum = 0;
+		Count = 0;
+		MaxCount = 0;
+		In = 0;
+		Out = 0;
+		RecvQueue.Init();
+		SendQueue.Init();
+	};
+};
+
+
+#endif
+
+#endif
+
+
+/////////////////////////////////////// EOF
@@ -0,0 +1,367 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: uMTmutex.cpp
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include "uMT.h"
+
+#define uMT_DEBUG 0
+#include "uMTdebug.h"
+
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+//				CLASS uMT
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+
+
+
+#if uMT_USE_MUTEX==1
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::MxGiveTo
+//
+// Entered with INTS disabled
+//
+////////////////////////////////////////////////////////////////////////////////////
+void	uMT::MxGiveTo(uMTmutex *pMx, uTask *pTask)
+{
+	pMx->Owner = pTask;
+	pMx->MxLocks = 1;
+
+	// Add to the owned list
+	pMx->NextOwned = pTask->MxOwned;
+	pTask->MxOwned = pMx;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::MxRelease
+//
+// The first waiting task (highest priority) becomes the owner, otherwise the Mutex is FREE.
+// The old owner priority is NOT updated.
+//
+// Entered with INTS disabled
+//
+////////////////////////////////////////////////////////////////////////////////////
+void	uMT::MxRelease(uMTmutex *pMx)
+{
+	// Remove from the owned list
+	uMTmutex **ppMx = &pMx->Owner->MxOwned;
+
+	while (*ppMx != pMx)
+		ppMx = &(*ppMx)->NextOwned;
+
+	*ppMx = pMx->NextOwned;
+
+	pMx->NextOwned = NULL;
+
+	// Any task waiting?
+	if (pMx->MxQueue.Head != NULL)
+	{
+		/* Now remove it from the Mutex queue */
+		uTask	*pTask = pMx->MxQueue.GetFirst();
+
+		pTask->pMxq = NULL;		// This task OWNS the Mutex and it is NOT any longer in the Mutex queue...
+
+		MxGiveTo(pMx, pTask);
+
+		// It inherits from the tasks still waiting
+		MxUpdatePrio(pTask);
+
+		/* Make this task READY... */
+		ReadyTask(pTask);
+
+		/* ... and check for preemption */
+		Check4Preemption();
+	}
+	else
+	{
+		pMx->Owner = NULL;
+		pMx->MxLocks = 0;
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::MxReleaseAll
+//
+// Used when a task is deleted or restarted.
+//
+// Entered with INTS disabled
+//
+////////////////////////////////////////////////////////////////////////////////////
+void	uMT::MxReleaseAll(uTask *pTask)
+{
+	while (pTask->MxOwned != NULL)
+		MxRelease(pTask->MxOwned);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::MxInheritedPrio
+//
+// Highest priority among BasePriority and the tasks waiting for the owned Mutexes.
+// Mutex queues are ordered by priority: only the first task of each queue is checked.
+//
+// Entered with INTS disabled
+//
+////////////////////////////////////////////////////////////////////////////////////
+TaskPrio_t	uMT::MxInheritedPrio(uTask *pTask)
+{
+	TaskPrio_t	Prio = pTask->BasePriority;
+
+	for (uMTmutex *pMx = pTask->MxOwned; pMx != NULL; pMx = pMx->NextOwned)
+	{
+		if (pMx->MxQueue.Head != NULL && pMx->MxQueue.Head->Priority > Prio)
+			Prio = pMx->MxQueue.Head->Priority;
+	}
+
+	return(Prio);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::MxUpdatePrio
+//
+// Recompute the priority of pTask and, if it is waiting for a Mutex, of its owner
+// and so on (transitive inheritance). pTask can be NULL.
+// A task waits for one Mutex at a time, so the chain is bounded by the number of tasks.
+//
+// Entered with INTS disabled
+//
+////////////////////////////////////////////////////////////////////////////////////
+void	uMT::MxUpdatePrio(uTask *pTask)
+{
+	for (unsigned int idx = 0; pTask != NULL && idx < kernelCfg.Tasks_Num; idx++)
+	{
+		TaskPrio_t Prio = MxInheritedPrio(pTask);
+
+		if (Prio == pTask->Priority)
+			break;
+
+		DgbStringPrint("uMT: MxUpdatePrio(): Tid=");
+		DgbValuePrint(pTask->myTid);
+		DgbStringPrint(" Priority=");
+		DgbValuePrintLN(Prio);
+
+		Tk_ChangePriority(pTask, Prio);
+
+		if ((pTask->TaskStatus != S_SBLOCKED && pTask->TaskStatus != S_TBLOCKED) || pTask->pMxq == NULL)
+			break;
+
+		// Waiting for another Mutex: propagate to its owner
+		pTask = pTask->pMxq->Owner;
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::Mx_Lock
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::Mx_Lock(MutexId_t Mxid, uMToptions_t Options
+#if uMT_USE_TIMERS==1
+	, Timer_t timeout
+#endif
+	)
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	if (MxId_Check(Mxid) == FALSE)
+		return(E_INVALID_MUTEXID);
+
+	CpuStatusReg_t	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+	uMTmutex *pMx = &MxList[Mxid];
+
+	if (pMx->Owner == NULL)		// Mutex is free
+	{
+		MxGiveTo(pMx, Running);
+
+		isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+		return(E_SUCCESS);
+	}
+
+	if (pMx->Owner == Running)	// Recursion
+	{
+		Errno_t error = E_SUCCESS;
+
+		if (pMx->MxLocks == uMT_MAX_MUTEX_LOCKS)
+			error = E_OVERFLOW_MUTEX;
+		else
+			pMx->MxLocks++;
+
+		isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+		return(error);
+	}
+
+	////////////////////////////////////////////
+	// Mutex is BUSY
+	////////////////////////////////////////////
+
+	if (Options == uMT_NOWAIT)
+	{
+		isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+		return(E_WOULD_BLOCK);
+	}
+
+	// Insert in the Mutex queue
+	pMx->MxQueue.Insert(Running);
+
+	// Remember the Queue
+	Running->pMxq = pMx;
+
+	Running->TaskStatus = S_SBLOCKED;
+
+	// Priority inheritance: the owner runs at least at our priority
+	MxUpdatePrio(pMx->Owner);
+
+
+#if uMT_USE_TIMERS==1
+	uTimer *pTimer = &Running->TaskTimer;
+
+	if (timeout != (Timer_t)0)
+	{
+		/////////////////////////////////////////////////
+		// Create a TASK TIMER to manage the timeout
+		////////////////////////////////////////////////
+		pTimer->Timeout = timeout;
+
+		pTimer->NextAlarm = msTickCounter + timeout;
+		pTimer->Flags = uMT_TM_IAM_TASK;	// To reset other flags
+
+		Running->TaskStatus = S_TBLOCKED;	// TIMER BLOCKED
+
+		TimerQ_Insert(pTimer);
+	}
+#endif
+
+
+	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+	//////////////////////////////////////////////////////////
+	// Suspend task and generate a rescheduling.
+	// It will "return" only when this task is S_RUNNING again
+	///////////////////////////////////////////////////////////
+	Suspend();
+
+	// Note: When control comes back, the Mutex is already owned (handed off by Mx_Unlock())
+	// unless the timeout is expired.
+
+#if uMT_USE_TIMERS==1
+	if (timeout != (Timer_t)0)		// A timer was set?
+	{
+		CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+		// Timeout expired?
+		if (pTimer->Flags & uMT_TM_EXPIRED)
+		{
+			// Did we get the Mutex?
+			if (Running->pMxq != NULL)
+			{
+				// No chance... (already removed from the Mutex queue in Reschedule(),
+				// the owner priority already updated)
+				Running->pMxq = NULL;
+
+				isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+				return(E_TIMEOUT);	/* Return error if any */
+			}
+		}
+		else
+		{
+			// We now OWN the Mutex, cancel the timer
+			if (TimerQ_CancelTimer(pTimer) != E_SUCCESS)
+				isr_Kn_FatalError(F("TimerQ_CancelTimer: Timer not found!"));
+		}
+
+		isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+	}
+#endif
+
+	return(E_SUCCESS);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::Mx_Unlock
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::Mx_Unlock(MutexId_t Mxid)
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	if (MxId_Check(Mxid) == FALSE)
+		return(E_INVALID_MUTEXID);
+
+	CpuStatusReg_t	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+	uMTmutex *pMx = &MxList[Mxid];
+
+	if (pMx->Owner != Running)
+	{
+		isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+		return(E_NOT_OWNED_MUTEX);
+	}
+
+	if (--pMx->MxLocks > 0)		// Still locked (recursion)
+	{
+		isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+		return(E_SUCCESS);
+	}
+
+	MxRelease(pMx);
+
+	// Give back the priority inherited through this Mutex
+	Tk_ChangePriority(Running, MxInheritedPrio(Running));
+
+	/* ... and check for preemption */
+	Check4Preemption();
+
+	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+	Check4NeedReschedule();		// Call Suspend() if NeedResched==TRUE
+
+	return(E_SUCCESS);
+}
+
+#endif
+
+
+
+/////////////////////// EOF
@@ -0,0 +1,67 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: uMTmutex.h
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef uMT_MUTEX_H
+#define uMT_MUTEX_H
+
+#if uMT_USE_MUTEX==1
+
+///////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT MUTEX
+//
+// Unlike a semaphore a mutex has an owner: it can be locked again by the owner
+// (recursion) and only the owner can unlock it. While tasks are waiting, the owner
+// runs at the highest priority among them (priority inheritance).
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#define uMT_MAX_MUTEX_LOCKS		0xFF		// Max recursion (MxLocks is 8 bits)
+
+class uMTmutex
+{
+	friend class uTask;
+	friend class uMT;
+
+	uTask			*Owner;		// Owner task, NULL if FREE
+	uint8_t			MxLocks;	// Recursion counter
+	uMTtaskQueue	MxQueue;	// Tasks waiting for this Mutex (priority order)
+	uMTmutex		*NextOwned;	// Next Mutex owned by the same task
+
+	void Init()
+	{
+		Owner = NULL;			// Set it FREE
+		MxLocks = 0;
+		MxQueue.Init();
+		NextOwned = NULL;
+	};
+};
+
+
+#endif
+
+#endif
+
+
+/////////////////////////////////////// EOF
@@ -0,0 +1,281 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: uMTpool.cpp
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <string.h>
+
+#include "uMT.h"
+
+#define uMT_DEBUG 0
+#include "uMTdebug.h"
+
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+//				CLASS uMT
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+
+
+
+#if uMT_USE_POOLS==1
+
+// Blocks are linked through their first bytes: keep them pointer aligned
+#define PL_ALIGN(x)		(((x) + sizeof(void *) - 1) & ~(sizeof(void *) - 1))
+
+#if uMT_SAFERUN==1
+// Bytes of the allocated blocks bitmap
+#define PL_BITMAP_SIZE(Num)	(((uint32_t)(Num) + 7) / 8)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::Pl_Create
+//
+// The blocks are carved out of the Pool area reserved at Kn_Start() and never returned.
+// With uMT_SAFERUN the allocated blocks bitmap follows them in the same area.
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::Pl_Create(PoolSize_t BlockSize, PoolSize_t BlockNum, PoolId_t &Plid)
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	if (BlockSize == 0 || BlockNum == 0)
+		return(E_INVALID_POOL_SIZE);
+
+	uint32_t Size = PL_ALIGN((uint32_t)BlockSize);
+	uint32_t TotSize = Size * BlockNum;
+
+#if uMT_SAFERUN==1
+	TotSize += PL_ALIGN(PL_BITMAP_SIZE(BlockNum));
+#endif
+
+	if (Size > 0xFFFF)
+		return(E_INVALID_POOL_SIZE);
+
+	CpuStatusReg_t	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+	// Look for a free entry
+	unsigned int idx;
+
+	for (idx = 0; idx < kernelCfg.Pools_Num; idx++)
+	{
+		if (PlList[idx].Area == NULL)
+			break;
+	}
+
+	if (idx >= kernelCfg.Pools_Num)
+	{
+		isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+		return(E_NOMORE_POOLS);
+	}
+
+	if (TotSize > (uint32_t)(kernelCfg.PoolArea_Size - PlAreaUsed))
+	{
+		isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+		return(E_NO_MORE_MEMORY);
+	}
+
+	uMTpool *pPool = &PlList[idx];
+
+	pPool->Area = &PlArea[PlAreaUsed];
+	pPool->BlockSize = (PoolSize_t)Size;
+	pPool->BlockNum = BlockNum;
+	pPool->FreeNum = BlockNum;
+	pPool->MinFreeNum = BlockNum;
+
+	PlAreaUsed += (Cfg_data_t)TotSize;
+
+	// Link all the blocks in the free list
+	uint8_t *pBlock = pPool->Area;
+
+	for (PoolSize_t Num = 1; Num < BlockNum; Num++, pBlock += Size)
+	{
+		*(void **)pBlock = pBlock + Size;
+	}
+
+	*(void **)pBlock = NULL;
+
+	pPool->FreeList = pPool->Area;
+
+#if uMT_SAFERUN==1
+	pPool->Allocated = pPool->Area + Size * BlockNum;
+	memset(pPool->Allocated, 0, PL_BITMAP_SIZE(BlockNum));
+#endif
+
+	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+	Plid = (PoolId_t)idx;
+
+	DgbStringPrint("uMT: Pl_Create(): Plid=");
+	DgbValuePrint(idx);
+	DgbStringPrint(" BlockSize=");
+	DgbValuePrintLN((unsigned int)Size);
+
+	return(E_SUCCESS);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::Pl_Alloc
+//
+// It never blocks: it can be called from ISR
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::Pl_Alloc(PoolId_t Plid, void *&pBlock)
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	if (PlId_Check(Plid) == FALSE)
+		return(E_INVALID_POOLID);
+
+	uMTpool *pPool = &PlList[Plid];
+
+	CpuStatusReg_t	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+	pBlock = pPool->FreeList;
+
+	if (pBlock == NULL)
+	{
+		isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+		return(E_POOL_EMPTY);
+	}
+
+	pPool->FreeList = *(void **)pBlock;
+
+#if uMT_SAFERUN==1
+	PoolSize_t Idx = (PoolSize_t)(((uint8_t *)pBlock - pPool->Area) / pPool->BlockSize);
+
+	pPool->Allocated[Idx / 8] |= (uint8_t)(1 << (Idx % 8));
+#endif
+
+	if (--pPool->FreeNum < pPool->MinFreeNum)
+		pPool->MinFreeNum = pPool->FreeNum;
+
+	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+	return(E_SUCCESS);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::Pl_Free
+//
+// It never blocks: it can be called from ISR.
+// With uMT_SAFERUN a block already free is rejected (allocated blocks bitmap).
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::Pl_Free(PoolId_t Plid, void *pBlock)
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	if (PlId_Check(Plid) == FALSE)
+		return(E_INVALID_POOLID);
+
+	uMTpool *pPool = &PlList[Plid];
+
+	// The block must be the beginning of one of the Pool's blocks
+	if ((uint8_t *)pBlock < pPool->Area)
+		return(E_INVALID_POOL_BLOCK);
+
+	uint32_t Offset = (uint32_t)((uint8_t *)pBlock - pPool->Area);
+	PoolSize_t Idx = (PoolSize_t)(Offset / pPool->BlockSize);
+
+	if (Idx >= pPool->BlockNum || Offset != (uint32_t)Idx * pPool->BlockSize)
+		return(E_INVALID_POOL_BLOCK);
+
+	CpuStatusReg_t	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+	if (pPool->FreeNum == pPool->BlockNum)		// Nothing allocated: freed twice
+	{
+		isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+		return(E_INVALID_POOL_BLOCK);
+	}
+
+#if uMT_SAFERUN==1
+	// Freed twice? Linking it again would hand it out to two owners
+	uint8_t Mask = (uint8_t)(1 << (Idx % 8));
+
+	if ((pPool->Allocated[Idx / 8] & Mask) == 0)
+	{
+		isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+		return(E_INVALID_POOL_BLOCK);
+	}
+
+	pPool->Allocated[Idx / 8] &= (uint8_t)~Mask;
+#endif
+
+	*(void **)pBlock = pPool->FreeList;
+	pPool->FreeList = pBlock;
+	pPool->FreeNum++;
+
+	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+	return(E_SUCCESS);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::Pl_GetInfo
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::Pl_GetInfo(PoolId_t Plid, uMTpoolInfo &Info)
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	if (PlId_Check(Plid) == FALSE)
+		return(E_INVALID_POOLID);
+
+	uMTpool *pPool = &PlList[Plid];
+
+	CpuStatusReg_t	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+	Info.BlockSize = pPool->BlockSize;
+	Info.BlockNum = pPool->BlockNum;
+	Info.FreeBlocks = pPool->FreeNum;
+	Info.MaxUsedBlocks = pPool->BlockNum - pPool->MinFreeNum;
+
+	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+	return(E_SUCCESS);
+}
+
+#endif
+
+
+
+/////////////////////// EOF
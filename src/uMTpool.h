@@ -0,0 +1,90 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: uMTpool.h
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef uMT_POOL_H
+#define uMT_POOL_H
+
+#if uMT_USE_POOLS==1
+
+///////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT memory POOL
+//
+// A Pool is a set of blocks of the same size carved out of the Pool area reserved
+// at Kn_Start(). Free blocks are linked through their first bytes, so Pl_Alloc()
+// and Pl_Free() are O(1) and never fragment memory. With uMT_SAFERUN a bitmap of
+// the allocated blocks, carved out of the Pool area after the blocks, lets
+// Pl_Free() reject a block freed twice in constant time.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+class uMTpool
+{
+	friend class uMT;
+
+	void			*FreeList;		// First free block, NULL if EMPTY
+	uint8_t			*Area;			// First block, NULL if the Pool is not created
+	PoolSize_t		BlockSize;		// Block size (rounded up to a pointer size)
+	PoolSize_t		BlockNum;		// Number of blocks
+	PoolSize_t		FreeNum;		// Number of free blocks
+	PoolSize_t		MinFreeNum;		// Lowest FreeNum (high-water mark)
+#if uMT_SAFERUN==1
+	uint8_t			*Allocated;		// One bit per block, set while the block is allocated
+#endif
+
+	void Init()
+	{
+		FreeList = NULL;
+		Area = NULL;			// Not created
+		BlockSize = 0;
+		BlockNum = 0;
+		FreeNum = 0;
+		MinFreeNum = 0;
+#if uMT_SAFERUN==1
+		Allocated = NULL;
+#endif
+	};
+};
+
+
+////////////////////////////////////////////////////
+// Returned in Pl_GetInfo()
+////////////////////////////////////////////////////
+
+class uMTpoolInfo
+{
+public:
+	PoolSize_t		BlockSize;		// Block size in bytes
+	PoolSize_t		BlockNum;		// Number of blocks
+	PoolSize_t		FreeBlocks;		// Free blocks now
+	PoolSize_t		MaxUsedBlocks;	// Maximum number of blocks allocated at the same time
+};
+
+
+#endif
+
+#endif
+
+
+/////////////////////////////////////// EOF
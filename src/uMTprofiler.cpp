@@ -0,0 +1,139 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: uMTprofiler.cpp
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+
+
+#include "uMT.h"
+
+#define uMT_DEBUG 0
+#include "uMTdebug.h"
+
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+//				CLASS uMT
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+
+
+
+
+#if uMT_USE_PROFILER==1
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::isr_Kn_ProfileSample
+//
+// Called by the System Tick with the interrupted PC (see uMTprofiler.h).
+// Open addressing: the same PC sampled in another task takes another slot.
+//
+// Entered with INTS disabled
+//
+////////////////////////////////////////////////////////////////////////////////////
+void	uMT::isr_Kn_ProfileSample(ProfPC_t PC)
+{
+	if (ProfOn == FALSE)
+		return;
+
+	if (++ProfTicks < ProfDivider)
+		return;
+
+	ProfTicks = 0;
+	ProfSamples++;
+
+	uint8_t Tid = (uint8_t)Running->myTid.GetID();
+	unsigned int Idx = (unsigned int)((PC >> 1) ^ (PC >> 9) ^ Tid);
+
+	for (uint8_t Probe = 0; Probe < uMT_PROFILER_PROBES; Probe++, Idx++)
+	{
+		uMTprofSlot *pSlot = &ProfTable[Idx & (uMT_PROFILER_SIZE - 1)];
+
+		if (pSlot->Count == 0)
+		{
+			pSlot->PC = PC;
+			pSlot->Tid = Tid;
+			pSlot->Count = 1;
+
+			return;
+		}
+
+		if (pSlot->PC == PC && pSlot->Tid == Tid)
+		{
+			if (pSlot->Count != 0xFFFF)
+				pSlot->Count++;
+
+			return;
+		}
+	}
+
+	ProfLost++;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::Kn_ProfilerStart
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::Kn_ProfilerStart(uint16_t Divider)
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	CpuStatusReg_t	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+	for (uint16_t Idx = 0; Idx < uMT_PROFILER_SIZE; Idx++)
+		ProfTable[Idx].Count = 0;
+
+	ProfSamples = 0;
+	ProfLost = 0;
+	ProfDivider = (Divider == 0 ? 1 : Divider);
+	ProfTicks = 0;
+	ProfOn = TRUE;
+
+	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+	return(E_SUCCESS);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::Kn_ProfilerStop
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::Kn_ProfilerStop()
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	ProfOn = FALSE;
+
+	return(E_SUCCESS);
+}
+
+#endif
+
+
+
+/////////////////////// EOF
@@ -0,0 +1,75 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: uMTprofiler.h
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef uMT_PROFILER_H
+#define uMT_PROFILER_H
+
+#if uMT_USE_PROFILER==1
+
+///////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT PC SAMPLING PROFILER
+//
+// Every Divider System Ticks the PC interrupted by the tick and the Running task
+// are counted in a small hash table (uMT_PROFILER_SIZE slots, uMT_PROFILER_PROBES
+// probes, samples which do not find a slot are only counted as Lost).
+// Kn_ProfilerDump() prints it to Serial, extras/profile/uMTprofile.py maps the
+// addresses to functions with the firmware ELF and prints a per-task flat profile.
+//
+// The PC is taken from the frame stacked by the tick interrupt:
+//	ARDUINO DUE/ZERO	by the PendSV pended in sysTickHook(), tail-chained to the tick
+//	ARDUINO UNO/MEGA	at the top of the naked System Tick ISR
+//	LINUX				from the signal ucontext
+// With uMT_USE_TICKLESS the IDLE task sleeps without ticks: its samples are fewer.
+// isr_Kn_ProfileSample() can also be called by a faster user timer ISR.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#if (uMT_PROFILER_SIZE & (uMT_PROFILER_SIZE - 1)) != 0
+#error "uMT_PROFILER_SIZE must be a power of 2"
+#endif
+
+#define uMT_PROFILER_PROBES		8		// Slots tried before a sample is lost
+
+#if defined(uMT_POSIX)
+typedef uintptr_t	ProfPC_t;			// Program Counter
+#else
+typedef uint32_t	ProfPC_t;			// Program Counter (byte address)
+#endif
+
+class uMTprofSlot
+{
+public:
+	ProfPC_t	PC;				// Sampled Program Counter
+	uint16_t	Count;			// Samples (saturated), 0 if the slot is free
+	uint8_t		Tid;			// Running task
+};
+
+#endif
+
+#endif
+
+
+/////////////////////////////////////// EOF
@@ -56,6 +56,7 @@ void uMTtaskQueue::Insert(uTask *pTask)
 	{
 		Head = pTask;
 		pTask->Next = NULL;
+		pTask->Prev = NULL;
 
 		return;
 	}
@@ -75,6 +76,8 @@ void uMTtaskQueue::Insert(uTask *pTask)
 				DgbValuePrintLN(pTask->myTid);
 
 				pTask->Next = Head;
+				pTask->Prev = NULL;
+				Head->Prev = pTask;
 				Head = pTask;
 			}
 			else
@@ -88,6 +91,8 @@ void uMTtaskQueue::Insert(uTask *pTask)
 
 				// pLast garanteed NOT to be NULL
 				pTask->Next = pScan;
+				pTask->Prev = pLast;
+				pScan->Prev = pTask;
 				pLast->Next = pTask;
 			}
 
@@ -102,6 +107,7 @@ void uMTtaskQueue::Insert(uTask *pTask)
 	
 	// Add at the end
 	pLast->Next = pTask;
+	pTask->Prev = pLast;
 	pTask->Next = NULL;
 }
 
@@ -111,6 +117,8 @@ void uMTtaskQueue::Insert(uTask *pTask)
 //
 //	uMTtaskQueue::Remove
 //
+// The task MUST be queued in this queue
+//
 // Entered with INTS disabled
 //
 ////////////////////////////////////////////////////////////////////////////////////
@@ -118,29 +126,22 @@ void uMTtaskQueue::Remove(uTask *pTask)
 {
 	CHECK_INTS("TaskQ_Remove");		// Verify if INTS are disabled...
 
-	uTask *pScan = Head;
-	uTask *pPrev = NULL;
-
-	while (pScan != NULL)
+	if (pTask->Prev != NULL)
 	{
-		if (pScan == pTask)
-		{
-			// Found!
-
-			if (pPrev != NULL)		// pQueue was NOT NULL!
-			{
-				pPrev->Next = pScan->Next;
-			}
-			else	// pQueueHead was NULL!
-			{
-				Head = pScan->Next;		// It must be the first element...
-			}
+		pTask->Prev->Next = pTask->Next;
+	}
+	else
+	{
+		Head = pTask->Next;		// It must be the first element...
+	}
 
-			return;
-		}
-		pScan = pScan->Next;		// Pick up next
+	if (pTask->Next != NULL)
+	{
+		pTask->Next->Prev = pTask->Prev;
 	}
 
+	pTask->Next = NULL;
+	pTask->Prev = NULL;
 }
 
 
@@ -166,6 +167,11 @@ uTask * uMTtaskQueue::GetFirst()
 
 	Head = pTask->Next;	// if ->Next is NULL, Queue is then empty
 
+	if (Head != NULL)
+		Head->Prev = NULL;
+
+	pTask->Next = NULL;
+
 	CHECK_TASK_MAGIC(pTask, "uMTtaskQueue::GetFirst");
 
 	return(pTask);
@@ -174,4 +180,122 @@ uTask * uMTtaskQueue::GetFirst()
 
 
 
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+//				CLASS uMTreadyQueue
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMTreadyQueue::Insert
+//
+// Append to the list of the task's priority (FIFO among same priority tasks)
+//
+// Entered with INTS disabled
+//
+////////////////////////////////////////////////////////////////////////////////////
+void uMTreadyQueue::Insert(uTask *pTask)
+{
+	CHECK_INTS("uMTreadyQueue::Insert");		// Verify if INTS are disabled...
+
+	TaskPrio_t Prio = pTask->Priority;
+
+	pTask->Next = NULL;
+	pTask->Prev = Tail[Prio];
+
+	if (Head[Prio] == NULL)
+	{
+		Head[Prio] = pTask;
+		Bitmap |= (ReadyBitmap_t)(1 << Prio);
+	}
+	else
+	{
+		Tail[Prio]->Next = pTask;
+	}
+
+	Tail[Prio] = pTask;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMTreadyQueue::Remove
+//
+// The task's Priority MUST be the one used in Insert() - O(1), no scan
+//
+// Entered with INTS disabled
+//
+////////////////////////////////////////////////////////////////////////////////////
+void uMTreadyQueue::Remove(uTask *pTask)
+{
+	CHECK_INTS("uMTreadyQueue::Remove");		// Verify if INTS are disabled...
+
+	TaskPrio_t Prio = pTask->Priority;
+
+	if (pTask->Prev != NULL)
+		pTask->Prev->Next = pTask->Next;
+	else
+		Head[Prio] = pTask->Next;		// It was the first element...
+
+	if (pTask->Next != NULL)
+		pTask->Next->Prev = pTask->Prev;
+	else
+		Tail[Prio] = pTask->Prev;		// It was the last element...
+
+	if (Head[Prio] == NULL)
+		Bitmap &= (ReadyBitmap_t)~(1 << Prio);
+
+	pTask->Next = NULL;
+	pTask->Prev = NULL;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMTreadyQueue::GetFirst
+//
+// Return the first task of the highest priority list
+//
+// Entered with INTS disabled
+//
+////////////////////////////////////////////////////////////////////////////////////
+uTask * uMTreadyQueue::GetFirst()
+{
+	CHECK_INTS("uMTreadyQueue::GetFirst");		// Verify if INTS are disabled...
+
+	if (Bitmap == 0)		// No tasks in the READY queue
+	{
+		return(NULL);
+	}
+
+	TaskPrio_t Prio = HighestPrio();
+
+	uTask *pTask = Head[Prio];
+
+	// Now pTask CANNOT be NULL
+
+	Head[Prio] = pTask->Next;
+
+	if (Head[Prio] == NULL)		// List is now empty
+	{
+		Tail[Prio] = NULL;
+		Bitmap &= (ReadyBitmap_t)~(1 << Prio);
+	}
+	else
+	{
+		Head[Prio]->Prev = NULL;
+	}
+
+	pTask->Next = NULL;
+
+	CHECK_TASK_MAGIC(pTask, "uMTreadyQueue::GetFirst");
+
+	return(pTask);
+}
+
+
+
+
 ///////////////////// EOF
\ No newline at end of file
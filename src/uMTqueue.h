@@ -56,6 +56,50 @@ inline	void	SetQueueMode(QueueMode_t _Mode) { Mode = _Mode; };
 };
 
 
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	READY queue
+//
+// One FIFO list per priority plus a bitmap of the non empty lists, so Insert(),
+// GetFirst() and the highest priority lookup do not depend on the number of READY tasks.
+//
+////////////////////////////////////////////////////////////////////////////////////
+#define uMT_PRIO_LEVELS		(PRIO_MAXPRIO_MASK + 1)		// 16 priorities
+
+typedef uint16_t	ReadyBitmap_t;		// One bit per priority
+
+class uMTreadyQueue
+{
+
+public:
+	ReadyBitmap_t	Bitmap;						// Bit N set if Head[N] is not empty
+	uTask		*Head[uMT_PRIO_LEVELS];			// Head of the queue, one per priority
+	uTask		*Tail[uMT_PRIO_LEVELS];			// Tail of the queue, one per priority
+
+
+	void		Insert(uTask *pTask);
+	void		Remove(uTask *pTask);
+	uTask		*GetFirst();
+
+inline	Bool_t	IsEmpty() { return(Bitmap == 0 ? TRUE : FALSE); };
+
+	// Highest priority in the queue (the queue MUST NOT be empty)
+inline	TaskPrio_t	HighestPrio() { return((TaskPrio_t)(sizeof(unsigned int) * 8 - 1 - __builtin_clz((unsigned int)Bitmap))); };
+
+	// First task to run, NULL if empty
+inline	uTask	*GetHead() { return(Bitmap == 0 ? NULL : Head[HighestPrio()]); };
+
+	void Init() {
+		Bitmap = 0;
+		for (int idx = 0; idx < uMT_PRIO_LEVELS; idx++)
+		{
+			Head[idx] = NULL;
+			Tail[idx] = NULL;
+		}
+	};
+};
+
+
 #endif
 
 /////////////////////////////////////// EOF
@@ -53,6 +53,32 @@ void uMT::Reschedule()
 #else
 void __attribute__ ((noinline)) uMT::Reschedule()
 #endif
+{
+	doReschedule();
+
+#if uMT_USE_MPU_STACK_GUARD==1
+	MpuStackGuard(Running);
+#endif
+
+	/* Now run task */
+	ResumeTask(Running->SavedSP);	// INTS enabled in ResumeTask(), if needed
+
+	/* ... NEVER RETURNS!! */
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::doReschedule
+//
+// The scheduling decision: on return Running is the task to resume.
+// The back ends switching in a single exception (SAM PendSV) call it directly
+// on the stack of the outgoing task and then load Running->SavedSP themselves.
+//
+// Entered with INTS disabled
+//
+////////////////////////////////////////////////////////////////////////////////////
+void uMT::doReschedule()
 {
 	// On entry:
 	// 1) Running still set to current task, even if ZOMBIE
@@ -61,6 +87,11 @@ void __attribute__ ((noinline)) uMT::Reschedule()
 	// Sanity Ceck.... There is ALWAYS a RUNNING task
 	CHECK_TASK_MAGIC(Running, "Reschedule(entry)");
 
+#if uMT_USE_STACK_CHECK==1
+	if (Running->TaskStatus != S_ZOMBIE)
+		StackCheck(Running);
+#endif
+
 
 	CHECK_INTS("Reschedule");		// Verify if INTS are disabled...
 
@@ -71,11 +102,17 @@ void __attribute__ ((noinline)) uMT::Reschedule()
 	LastRunning = Running;		// Remember last task...
 
 #if	uMT_USE_TASK_STATISTICS>=2
-	// Update Running time
-	Timer_t usEnterTime = micros();
+	// Update Running time, the System Tick ISR time is not charged to the task
+	CpuTicks_t CpuEnterTime = uMT_CpuTicks();
+
+	Running->CpuLastRun = CpuEnterTime - CpuUserStartTime - CpuIsrSlice;
+	Running->CpuRunningTime = Running->CpuRunningTime + Running->CpuLastRun;
+	CpuTotalTime = CpuTotalTime + Running->CpuLastRun;
+#endif
 
-	Running->usLastRun = usEnterTime - usUserStartTime;
-	Running->usRunningTime = Running->usRunningTime + Running->usLastRun;
+#if uMT_USE_INTOFF_PROFILER==1
+	// A critical region ended by this task switch, not by isr_Kn_IntUnlock()
+	IntOffClose(CpuEnterTime);
 #endif
 
 	if (Running->TaskStatus == S_RUNNING)
@@ -91,6 +128,10 @@ void __attribute__ ((noinline)) uMT::Reschedule()
 		// Add in the Ready Queue
 		ReadyTask(Running);
 	}
+	else if (Running->TaskStatus != S_READY)
+	{
+		uMT_TRACE(TR_BLOCK, Running->myTid.GetID(), Running->TaskStatus);
+	}
 
 
 	if (Running->TaskStatus == S_ZOMBIE)
@@ -122,11 +163,62 @@ void __attribute__ ((noinline)) uMT::Reschedule()
 			break;
 		}
 
+		uMT_TRACE(TR_TIMER, pTimer->pTask->myTid.GetID(), pTimer->Flags);
+
 		if (pTimer->Flags & uMT_TM_IAM_TASK)
 		{
 			DgbStringPrint("uMT: Reschedule(AlarmExpired): TASK: Tid=");
 			DgbValuePrintLN(pTimer->pTask->myTid);
 
+#if uMT_USE_SEMAPHORES==1
+			// Timeout while waiting for a semaphore: leave the SEM queue in O(1).
+			// pSemq is kept so Sm_Claim() can detect the timeout.
+			if (pTimer->pTask->pSemq != NULL && pTimer->pTask->TaskStatus == S_TBLOCKED)
+				pTimer->pTask->pSemq->SemQueue.Remove(pTimer->pTask);
+#endif
+
+#if uMT_USE_MUTEX==1
+			// Timeout while waiting for a Mutex: leave the Mutex queue and give back the
+			// inherited priority now. pMxq is kept so Mx_Lock() can detect the timeout.
+			if (pTimer->pTask->pMxq != NULL && pTimer->pTask->TaskStatus == S_TBLOCKED)
+			{
+				pTimer->pTask->pMxq->MxQueue.Remove(pTimer->pTask);
+
+				MxUpdatePrio(pTimer->pTask->pMxq->Owner);
+			}
+#endif
+
+#if uMT_USE_MSGQUEUES==1
+			// Timeout in Mq_Send()/Mq_Receive(): leave the Send/Recv queue.
+			// pMqWaitq is kept so MqWait() can detect the timeout.
+			if (pTimer->pTask->pMqWaitq != NULL && pTimer->pTask->TaskStatus == S_TBLOCKED)
+				pTimer->pTask->pMqWaitq->Remove(pTimer->pTask);
+#endif
+
+#if uMT_USE_EVENTGROUPS==1
+			// Timeout in Eg_Wait(): leave the wait queue.
+			// pEgWait is kept so Eg_Wait() can detect the timeout.
+			if (pTimer->pTask->pEgWait != NULL && pTimer->pTask->TaskStatus == S_TBLOCKED)
+				pTimer->pTask->pEgWait->WaitQueue.Remove(pTimer->pTask);
+#endif
+
+#if uMT_USE_RWLOCKS==1
+			// Timeout in Rw_ReadLock()/Rw_WriteLock(): leave the Read/Write queue.
+			// pRwWait is kept so doRw_Lock() can detect the timeout.
+			if (pTimer->pTask->pRwWait != NULL && pTimer->pTask->TaskStatus == S_TBLOCKED)
+			{
+				if (pTimer->pTask->RwWrite)
+				{
+					pTimer->pTask->pRwWait->WriteQueue.Remove(pTimer->pTask);
+
+					// A writer no longer waiting may let the readers in
+					RwWakeup(pTimer->pTask->pRwWait);
+				}
+				else
+					pTimer->pTask->pRwWait->ReadQueue.Remove(pTimer->pTask);
+			}
+#endif
+
 			// TASK: make it ready
 			ReadyTask(pTimer->pTask);
 
@@ -146,19 +238,18 @@ void __attribute__ ((noinline)) uMT::Reschedule()
 		}
 
 		// Next Timer?
-		if (TimerQueue == NULL)
-		{
-			// No more timers
-			break;
-		}
-
-		if (TimerQueue->NextAlarm > msTickCounter)
+		if (TimerQ_AlarmDue() == FALSE)
 		{
-			// Not yet expired
+			// No more expired timers
 			break;
 		}
 	
 	}
+
+#if uMT_USE_TIMER_WHEEL==1
+	if (AlarmExpired == TRUE)
+		TimerW_SetDeadline();		// Next tick the System Tick has to check
+#endif
 #endif
 
 
@@ -176,7 +267,7 @@ void __attribute__ ((noinline)) uMT::Reschedule()
 	///////////////////////////////////////////////////
 	// Choose a task to RUN
 	///////////////////////////////////////////////////
-	Running = (ReadyQueue.Head != NULL ? ReadyQueue.GetFirst() : IdleTaskPtr);
+	Running = (ReadyQueue.IsEmpty() == FALSE ? ReadyQueue.GetFirst() : IdleTaskPtr);
 	Running->TaskStatus = S_RUNNING;	/* Put it running */
 
 	
@@ -189,6 +280,8 @@ void __attribute__ ((noinline)) uMT::Reschedule()
 	// Clear Timesharing, but only if we have done a task switch...
 	if (Running != LastRunning)
 	{
+		uMT_TRACE(TR_SWITCH, Running->myTid.GetID(), LastRunning->myTid.GetID());
+
 		TimeSlice = (Running == IdleTaskPtr ? uMT_IDLE_TIMEOUTVALUE : uMT_TICKS_TIMESHARING);
 	}
 
@@ -203,17 +296,12 @@ void __attribute__ ((noinline)) uMT::Reschedule()
 
 #if	uMT_USE_TASK_STATISTICS>=2
 	// Remember startime
-//	StartTime = msTickCounter.Low;
-	usUserStartTime = micros();
+	CpuUserStartTime = uMT_CpuTicks();
+	CpuIsrSlice = 0;
 
-	usKernelRunningTime = usKernelRunningTime + (usUserStartTime - usEnterTime);
+	CpuKernelTime = CpuKernelTime + (CpuUserStartTime - CpuEnterTime);
+	CpuTotalTime = CpuTotalTime + (CpuUserStartTime - CpuEnterTime);
 #endif
-
-	/* Now run task */
-	ResumeTask(Running->SavedSP);	// INTS enabled in ResumeTask(), if needed
-
-	/* ... NEVER RETURNS!! */
-
 }
 
 
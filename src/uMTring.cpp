@@ -0,0 +1,205 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: uMTring.cpp
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+
+
+#include <string.h>
+
+#include "uMT.h"
+
+#define uMT_DEBUG 0
+#include "uMTdebug.h"
+
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+//				CLASS uMTring
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+
+
+
+#if uMT_USE_RINGS==1 && uMT_USE_EVENTS==1
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMTring::Init
+//
+// To be called before the producer is started
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMTring::Init(void *pBuffer, RingIdx_t _Size, uint8_t _ItemSize, TaskId_t _ReaderTid, Event_t Event)
+{
+	if (pBuffer == NULL || _Size < 2 || _ItemSize == 0)
+		return(E_INVALID_RING_SIZE);
+
+	if (Event == (Event_t)0)
+		return(E_INVALID_OPTION);
+
+	Size = _Size;
+	ItemSize = _ItemSize;
+	Head = 0;
+	Tail = 0;
+	ReaderWaiting = FALSE;
+	Overruns = 0;
+	ReaderTid = _ReaderTid;
+	ReaderEvent = Event;
+
+	Buffer = (uint8_t *)pBuffer;
+
+	return(E_SUCCESS);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMTring::doPut
+//
+// Producer side, no kernel lock
+//
+////////////////////////////////////////////////////////////////////////////////////
+Bool_t	uMTring::doPut(const void *pItem, Bool_t AllowPreemption)
+{
+	if (Buffer == NULL)
+		return(FALSE);
+
+	RingIdx_t H = Head;
+	RingIdx_t Next = H + 1;
+
+	if (Next == Size)
+		Next = 0;
+
+	if (Next == Tail)				// FULL
+	{
+		if (Overruns != (RingIdx_t)~0)
+			Overruns++;
+
+		return(FALSE);
+	}
+
+	memcpy(&Buffer[(size_t)H * ItemSize], pItem, ItemSize);
+
+	uMT_RING_BARRIER();				// Item written before it is published
+
+	Head = Next;
+
+	uMT_RING_BARRIER();				// Head published before ReaderWaiting is checked
+
+	if (ReaderWaiting)
+	{
+		if (AllowPreemption)
+			Kernel.Ev_Send(ReaderTid, ReaderEvent);
+		else
+			Kernel.isr_Ev_Send(ReaderTid, ReaderEvent);
+	}
+
+	return(TRUE);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMTring::Get
+//
+// Reader side, no kernel lock
+//
+////////////////////////////////////////////////////////////////////////////////////
+Bool_t	uMTring::Get(void *pItem)
+{
+	if (Buffer == NULL)
+		return(FALSE);
+
+	RingIdx_t T = Tail;
+
+	if (T == Head)					// EMPTY
+		return(FALSE);
+
+	uMT_RING_BARRIER();				// Head read before the item
+
+	memcpy(pItem, &Buffer[(size_t)T * ItemSize], ItemSize);
+
+	uMT_RING_BARRIER();				// Item read before the slot is released
+
+	if (++T == Size)
+		T = 0;
+
+	Tail = T;
+
+	return(TRUE);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMTring::Read
+//
+// ReaderWaiting is raised and the ring checked again before sleeping, so an item
+// published in between is never missed: either the reader sees it or the producer
+// sees the flag and sends the event, which stays pending until Ev_Receive().
+// A stale event only costs one more loop.
+//
+////////////////////////////////////////////////////////////////////////////////////
+#if uMT_USE_TIMERS==1
+Errno_t	uMTring::Read(void *pItem, Timer_t timeout)
+#else
+Errno_t	uMTring::Read(void *pItem)
+#endif
+{
+	if (Buffer == NULL)
+		return(E_NOT_INITED);
+
+	Event_t	eventout;
+	Errno_t	error;
+
+	while (Get(pItem) == FALSE)
+	{
+		ReaderWaiting = TRUE;
+
+		uMT_RING_BARRIER();			// Flag raised before Head is checked again
+
+		if (Get(pItem))
+			break;
+
+#if uMT_USE_TIMERS==1
+		error = Kernel.Ev_Receive(ReaderEvent, uMT_ANY, &eventout, timeout);
+#else
+		error = Kernel.Ev_Receive(ReaderEvent, uMT_ANY, &eventout);
+#endif
+
+		if (error != E_SUCCESS)
+		{
+			ReaderWaiting = FALSE;
+			return(error);
+		}
+	}
+
+	ReaderWaiting = FALSE;
+
+	return(E_SUCCESS);
+}
+
+#endif
+
+
+
+/////////////////////// EOF
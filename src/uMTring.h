@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: uMTring.h
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef uMT_RING_H
+#define uMT_RING_H
+
+#if uMT_USE_RINGS==1 && uMT_USE_EVENTS==1
+
+///////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT SPSC RING BUFFER
+//
+// A Single Producer / Single Consumer ring of fixed size items, to stream data
+// from an ISR (or a task) to one reader task. The buffer is supplied by the caller.
+//
+// Head is written only by the producer and Tail only by the reader, so neither
+// side takes the kernel lock: Put() is wait-free and it never blocks. On a full ring
+// the item is dropped and counted in Overruns. The reader sleeps in Read() on
+// ReaderEvent, which the producer sends only when the reader has flagged it is waiting.
+//
+// On a single core the only reordering to prevent is the compiler's, which is
+// what uMT_RING_BARRIER() does. Indexes are one byte wide on AVR so that loading
+// them is atomic.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#if defined(ARDUINO_ARCH_AVR)
+typedef uint8_t			RingIdx_t;			// Max 255 items
+#else
+typedef uint16_t		RingIdx_t;			// Max 65535 items
+#endif
+
+#if defined(WIN32)
+#define uMT_RING_BARRIER()
+#else
+#define uMT_RING_BARRIER()	__asm__ __volatile__("" ::: "memory")
+#endif
+
+
+class uMTring
+{
+	uint8_t				*Buffer;		// Items, NULL if not initialized
+	RingIdx_t			Size;			// Number of slots (one is always left free)
+	uint8_t				ItemSize;		// Item size in bytes
+	volatile RingIdx_t	Head;			// Next slot to write (producer only)
+	volatile RingIdx_t	Tail;			// Next slot to read (reader only)
+	volatile Bool_t		ReaderWaiting;	// Reader sleeping in Read() (reader only)
+	RingIdx_t			Overruns;		// Items dropped on a full ring (producer only)
+	TaskId_t			ReaderTid;		// Task woken up by the producer
+	Event_t				ReaderEvent;	// Event used to wake it up
+
+	Bool_t	doPut(const void *pItem, Bool_t AllowPreemption);
+
+public:
+	uMTring() {Buffer = NULL;};
+
+	// Buffer must be Size * ItemSize bytes, Size >= 2
+	Errno_t	Init(void *pBuffer, RingIdx_t Size, uint8_t ItemSize, TaskId_t ReaderTid, Event_t Event);
+
+	// Producer side: FALSE if the ring is FULL (item dropped)
+inline	Bool_t	Put(const void *pItem) {return(doPut(pItem, TRUE));};
+inline	Bool_t	isr_Put(const void *pItem) {return(doPut(pItem, FALSE));};
+
+	// Reader side
+	Bool_t	Get(void *pItem);						// FALSE if EMPTY, never blocks
+#if uMT_USE_TIMERS==1
+	Errno_t	Read(void *pItem, Timer_t timeout = (Timer_t)0);	// Wait for an item
+#else
+	Errno_t	Read(void *pItem);						// Wait for an item
+#endif
+
+	RingIdx_t	Count() const
+	{
+		RingIdx_t H = Head;
+		RingIdx_t T = Tail;
+
+		return((H >= T) ? (RingIdx_t)(H - T) : (RingIdx_t)(Size - T + H));
+	};
+
+	RingIdx_t	GetOverruns() const {return(Overruns);};
+};
+
+
+#endif
+
+#endif
+
+
+/////////////////////////////////////// EOF
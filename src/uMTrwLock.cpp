@@ -0,0 +1,349 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: uMTrwLock.cpp
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include "uMT.h"
+
+#define uMT_DEBUG 0
+#include "uMTdebug.h"
+
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+//				CLASS uMT
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+
+
+
+
+
+
+#if uMT_USE_RWLOCKS==1
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::Rw_Create
+//
+// RW locks are never deleted.
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::Rw_Create(RwLockId_t &Rwid)
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	CpuStatusReg_t	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+	// Look for a free entry
+	unsigned int idx;
+
+	for (idx = 0; idx < kernelCfg.RwLocks_Num; idx++)
+	{
+		if (RwList[idx].Created == FALSE)
+			break;
+	}
+
+	if (idx >= kernelCfg.RwLocks_Num)
+	{
+		isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+		return(E_NOMORE_RWLOCKS);
+	}
+
+	RwList[idx].Created = TRUE;
+
+	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+	Rwid = (RwLockId_t)idx;
+
+	return(E_SUCCESS);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::RwWakeup
+//
+// Called when the lock may have become available (unlock, a waiting writer gone):
+// the first waiting writer gets it when there are no readers, otherwise, if no
+// writer is waiting, all the waiting readers get it.
+//
+// Entered with INTS disabled
+//
+////////////////////////////////////////////////////////////////////////////////////
+void	uMT::RwWakeup(uMTrwLock *pRw)
+{
+	uTask	*pTask;
+
+	if (pRw->Writer != NULL)
+		return;
+
+	if (pRw->WriteQueue.Head != NULL)
+	{
+		if (pRw->Readers != 0)
+			return;		// The last reader will hand it off
+
+		/* Now remove it from the write queue */
+		pTask = pRw->WriteQueue.GetFirst();
+
+		pTask->pRwWait = NULL;		// This task OWNS the lock and it is NOT any longer in the queue...
+
+		pRw->Writer = pTask;
+
+		/* Make this task READY... */
+		ReadyTask(pTask);
+	}
+	else if (pRw->ReadQueue.Head != NULL)
+	{
+		while ((pTask = pRw->ReadQueue.GetFirst()) != NULL)
+		{
+			pTask->pRwWait = NULL;
+
+			pRw->Readers++;
+
+			ReadyTask(pTask);
+		}
+	}
+	else
+	{
+		return;
+	}
+
+	/* ... and check for preemption, once */
+	Check4Preemption();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::RwReleaseAll
+//
+// Release the write locks owned by pTask. Used when a task is deleted or restarted
+// (read locks are not tracked per task).
+//
+// Entered with INTS disabled
+//
+////////////////////////////////////////////////////////////////////////////////////
+void	uMT::RwReleaseAll(uTask *pTask)
+{
+	for (unsigned int idx = 0; idx < kernelCfg.RwLocks_Num; idx++)
+	{
+		if (RwList[idx].Writer == pTask)
+		{
+			RwList[idx].Writer = NULL;
+
+			RwWakeup(&RwList[idx]);
+		}
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::doRw_Lock
+//
+// Write = FALSE for a read lock, TRUE for the write lock.
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::doRw_Lock(RwLockId_t Rwid, Bool_t Write, uMToptions_t Options, Timer_t timeout)
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	if (RwId_Check(Rwid) == FALSE)
+		return(E_INVALID_RWLOCKID);
+
+	uMTrwLock *pRw = &RwList[Rwid];
+
+	CpuStatusReg_t	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+	if (Write)
+	{
+		if (pRw->Writer == NULL && pRw->Readers == 0)
+		{
+			pRw->Writer = Running;
+
+			isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+			return(E_SUCCESS);
+		}
+
+		if (pRw->Writer == Running)		// No recursion: it would wait forever
+		{
+			isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+			return(E_NOT_ALLOWED);
+		}
+	}
+	else if (pRw->Writer == NULL && pRw->WriteQueue.Head == NULL)	// No writer, not even waiting
+	{
+		pRw->Readers++;
+
+		isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+		return(E_SUCCESS);
+	}
+
+	////////////////////////////////////////////
+	// Lock is BUSY
+	////////////////////////////////////////////
+
+	if (Options == uMT_NOWAIT)
+	{
+		isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+		return(E_WOULD_BLOCK);
+	}
+
+	// Insert in the Read/Write queue
+	if (Write)
+		pRw->WriteQueue.Insert(Running);
+	else
+		pRw->ReadQueue.Insert(Running);
+
+	// Remember the lock
+	Running->pRwWait = pRw;
+	Running->RwWrite = Write;
+
+	Running->TaskStatus = S_SBLOCKED;
+
+
+#if uMT_USE_TIMERS==1
+	uTimer *pTimer = &Running->TaskTimer;
+
+	if (timeout != (Timer_t)0)
+	{
+		/////////////////////////////////////////////////
+		// Create a TASK TIMER to manage the timeout
+		////////////////////////////////////////////////
+		pTimer->Timeout = timeout;
+
+		pTimer->NextAlarm = msTickCounter + timeout;
+		pTimer->Flags = uMT_TM_IAM_TASK;	// To reset other flags
+
+		Running->TaskStatus = S_TBLOCKED;	// TIMER BLOCKED
+
+		TimerQ_Insert(pTimer);
+	}
+#endif
+
+
+	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+	//////////////////////////////////////////////////////////
+	// Suspend task and generate a rescheduling.
+	// It will "return" only when this task is S_RUNNING again
+	///////////////////////////////////////////////////////////
+	Suspend();
+
+	// Note: When control comes back, the lock is already held (granted by RwWakeup())
+	// unless the timeout is expired.
+
+#if uMT_USE_TIMERS==1
+	if (timeout != (Timer_t)0)		// A timer was set?
+	{
+		CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+		// Timeout expired?
+		if (pTimer->Flags & uMT_TM_EXPIRED)
+		{
+			// Did we get the lock?
+			if (Running->pRwWait != NULL)
+			{
+				// No chance... (already removed from the Read/Write queue and the
+				// waiting readers woken up in Reschedule())
+				Running->pRwWait = NULL;
+
+				isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+				return(E_TIMEOUT);	/* Return error if any */
+			}
+		}
+		else
+		{
+			// We now hold the lock, cancel the timer
+			if (TimerQ_CancelTimer(pTimer) != E_SUCCESS)
+				isr_Kn_FatalError(F("TimerQ_CancelTimer: Timer not found!"));
+		}
+
+		isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+	}
+#endif
+
+	return(E_SUCCESS);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::doRw_Unlock
+//
+// The write lock is released if the Running task owns it, otherwise a read lock.
+// From ISR (AllowPreemption == FALSE) only a read lock can be released.
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::doRw_Unlock(RwLockId_t Rwid, Bool_t AllowPreemption)
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	if (RwId_Check(Rwid) == FALSE)
+		return(E_INVALID_RWLOCKID);
+
+	uMTrwLock *pRw = &RwList[Rwid];
+
+	CpuStatusReg_t	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+	if (AllowPreemption && pRw->Writer == Running)
+	{
+		pRw->Writer = NULL;
+	}
+	else if (pRw->Readers > 0)
+	{
+		pRw->Readers--;
+	}
+	else
+	{
+		isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+		return(E_NOT_OWNED_RWLOCK);
+	}
+
+	RwWakeup(pRw);
+
+	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+	if (AllowPreemption)
+		Check4NeedReschedule();		// Call Suspend() if NeedResched==TRUE
+	else
+		Check4IsrReschedule();		// Switch on return from interrupt if NeedResched==TRUE
+
+	return(E_SUCCESS);
+}
+
+#endif
+
+
+
+/////////////////////// EOF
@@ -0,0 +1,69 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: uMTrwLock.h
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef uMT_RWLOCK_H
+#define uMT_RWLOCK_H
+
+#if uMT_USE_RWLOCKS==1
+
+///////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT READERS-WRITER LOCK
+//
+// Any number of readers or a single writer. Writers have the preference: once a
+// writer is waiting, new readers wait as well and, when the lock is released,
+// the next writer is served before the waiting readers (which are all admitted
+// together). The writer is an owner like a Mutex, readers are just counted.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+class uMTrwLock
+{
+	friend class uTask;
+	friend class uMT;
+
+	Bool_t			Created;	// TRUE after Rw_Create()
+	uint16_t		Readers;	// Readers holding the lock
+	uTask			*Writer;	// Writer holding the lock, NULL if none
+	uMTtaskQueue	ReadQueue;	// Readers waiting (priority order)
+	uMTtaskQueue	WriteQueue;	// Writers waiting (priority order)
+
+	void Init()
+	{
+		Created = FALSE;		// Not created
+		Readers = 0;
+		Writer = NULL;
+		ReadQueue.Init();
+		WriteQueue.Init();
+	};
+};
+
+
+#endif
+
+#endif
+
+
+/////////////////////////////////////// EOF
@@ -40,10 +40,41 @@
 
 
 #if uMT_USE_SEMAPHORES==1
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	SemStatistics
+//
+// Account a Sm_Claim() which had to wait
+//
+// Entered with INTS disabled
+//
+////////////////////////////////////////////////////////////////////////////////////
+#if uMT_USE_SEM_STATISTICS==1
+static void SemStatistics(uMTsemStats &Stats, uint32_t usWaitStart, Bool_t TimedOut)
+{
+	uint32_t usWait = (uint32_t)micros() - usWaitStart;
+
+	Stats.usWaitTotal += usWait;
+
+	if (usWait > Stats.usWaitMax)
+		Stats.usWaitMax = usWait;
+
+	if (TimedOut)
+		Stats.Timeouts++;
+	else
+		Stats.Claims++;
+}
+#endif
+
+
 ////////////////////////////////////////////////////////////////////////////////////
 //
 //	uMT::iSm_Claim
 //
+// In handoff mode (default) the semaphore is already ours when the task is woken
+// up by Sm_Release(). Otherwise Sm_Release() only wakes up the first waiter, which
+// has to take the semaphore again: if somebody else was quicker, it waits again.
+//
 ////////////////////////////////////////////////////////////////////////////////////
 Errno_t	uMT::Sm_Claim(SemId_t Sid, uMToptions_t Options
 #if uMT_USE_TIMERS==1
@@ -57,15 +88,37 @@ Errno_t	uMT::Sm_Claim(SemId_t Sid, uMToptions_t Options
 	if (SemId_Check(Sid) == FALSE)
 		return(E_INVALID_SEMID);
 
+	uMTsem *pSem = &SemList[Sid];
+
+#if uMT_USE_SEM_FASTPATH==1
+	// Semaphore is free: take it without disabling INTS
+	if (uMT_SemTryClaim(&pSem->SemValue) == TRUE)
+	{
+		uMT_TRACE(TR_SM_CLAIM, Sid, pSem->SemValue & uMT_SEM_COUNT_MASK);
+
+#if uMT_USE_SEM_STATISTICS==1
+		__atomic_fetch_add(&pSem->Stats.Claims, 1, __ATOMIC_RELAXED);
+#endif
+
+		Running->pSemq = NULL;	// We OWN the semaphore, not in any SEM queue
+
+		return(E_SUCCESS);
+	}
+#endif
+
 	CpuStatusReg_t	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
 
-	uMTsem *pSem = &SemList[Sid];
+	uMT_TRACE(TR_SM_CLAIM, Sid, pSem->SemValue & uMT_SEM_COUNT_MASK);
 
-	if (pSem->SemValue > 0) // Semaphore is free
+	if ((pSem->SemValue & uMT_SEM_COUNT_MASK) > 0) // Semaphore is free
 	{
 		pSem->SemValue--;		// Take the semaphore
 
-		Running->pSemq = pSem;	// Remember the Queue
+#if uMT_USE_SEM_STATISTICS==1
+		pSem->Stats.Claims++;
+#endif
+
+		Running->pSemq = NULL;	// We OWN the semaphore, not in any SEM queue
 
 		isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
 
@@ -83,11 +136,11 @@ Errno_t	uMT::Sm_Claim(SemId_t Sid, uMToptions_t Options
 		return(E_WOULD_BLOCK);
 	}
 
-	// Insert in the SEM queue
-	pSem->SemQueue.Insert(Running);
+#if uMT_USE_SEM_STATISTICS==1
+	pSem->Stats.Contentions++;
 
-	// Remember the Queue
-	Running->pSemq = pSem;
+	uint32_t usWaitStart = (uint32_t)micros();
+#endif
 
 	Running->TaskStatus = S_SBLOCKED;
 
@@ -119,34 +172,78 @@ Errno_t	uMT::Sm_Claim(SemId_t Sid, uMToptions_t Options
 	}
 #endif
 
+	for (;;)
+	{
+		// Insert in the SEM queue
+		pSem->SemQueue.Insert(Running);
 
-	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+		// Remember the Queue
+		Running->pSemq = pSem;
 
-	//////////////////////////////////////////////////////////
-	// Suspend task and generate a rescheduling.
-	// It will "return" only when this task is S_RUNNING again
-	///////////////////////////////////////////////////////////
-	Suspend();
-
-	/*************************************************************
-	* Some notes:
-	*** Suspend() ALWAYS returns!
-	*** uMT assures that a task is restarted when the proper
-	* conditions are satisfied, i.e. some event is arrived.
-	* When the control is BACK again, the task is already
-	* the RUNNING task.
-	* INTERRUPTS are ENABLED!
-	*******************************************************************/
-
-	/* Note: When control comes back, sem is already taken. This
-		is done to avoid a lucky task to enter sem in the time
-		the previous user has released it and this task will
-		be running */
-	
+#if uMT_USE_SEM_FASTPATH==1
+		pSem->SemValue |= uMT_SEM_WAITERS;	// Next Sm_Release() must take the slow path
+#endif
+
+		isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+		//////////////////////////////////////////////////////////
+		// Suspend task and generate a rescheduling.
+		// It will "return" only when this task is S_RUNNING again
+		///////////////////////////////////////////////////////////
+		Suspend();
+
+		/*************************************************************
+		* Some notes:
+		*** Suspend() ALWAYS returns!
+		*** uMT assures that a task is restarted when the proper
+		* conditions are satisfied, i.e. some event is arrived.
+		* When the control is BACK again, the task is already
+		* the RUNNING task.
+		* INTERRUPTS are ENABLED!
+		*******************************************************************/
+
+		/* Note: In handoff mode, when control comes back, sem is already
+			taken. This is done to avoid a lucky task to enter sem in the
+			time the previous user has released it and this task will
+			be running */
+
+		CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+		if (Running->pSemq == NULL && pSem->Handoff == FALSE)
+		{
+			// Woken up by Sm_Release(): try to take it
+			if ((pSem->SemValue & uMT_SEM_COUNT_MASK) > 0)
+			{
+				pSem->SemValue--;		// Take the semaphore
+
+				break;
+			}
 
 #if uMT_USE_TIMERS==1
-	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+			// Taken by somebody else: wait again, unless the timeout is expired
+			if (timeout != (Timer_t)0 && (pTimer->Flags & uMT_TM_EXPIRED))
+			{
+				Running->pSemq = pSem;		// Not taken: report the timeout below
 
+				break;
+			}
+#endif
+
+			Running->TaskStatus = S_SBLOCKED;
+
+#if uMT_USE_TIMERS==1
+			if (timeout != (Timer_t)0)
+				Running->TaskStatus = S_TBLOCKED;	// TIMER still running
+#endif
+
+			continue;
+		}
+
+		break;
+	}
+
+
+#if uMT_USE_TIMERS==1
 	if (timeout != (Timer_t)0)		// A timer was set?
 	{
 		DgbStringPrint("uMT(");
@@ -162,10 +259,15 @@ Errno_t	uMT::Sm_Claim(SemId_t Sid, uMToptions_t Options
 			// Did we get the SEMAPHORE?
 			if (Running->pSemq != NULL)
 			{
-				// No chance...
+				// No chance... (already removed from the SEM queue in Reschedule())
+				Running->pSemq = NULL;
 
 				DgbStringPrintLN("E_TIMEOUT");
 
+#if uMT_USE_SEM_STATISTICS==1
+				SemStatistics(pSem->Stats, usWaitStart, TRUE);
+#endif
+
 				isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
 
 				return(E_TIMEOUT);	/* Return error if any */
@@ -194,10 +296,13 @@ Errno_t	uMT::Sm_Claim(SemId_t Sid, uMToptions_t Options
 			}
 		}
 	}
+#endif
 
-	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
-
+#if uMT_USE_SEM_STATISTICS==1
+	SemStatistics(pSem->Stats, usWaitStart, FALSE);
 #endif
+
+	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
 		
 	Running->pSemq = NULL;	// Not waiting in any SEM queue
 
@@ -219,15 +324,26 @@ Errno_t	uMT::doSm_Release(SemId_t Sid, Bool_t AllowPreemption)
 	if (SemId_Check(Sid) == FALSE)
 		return(E_INVALID_SEMID);
 
-	if (SemList[Sid].SemValue == uMT_MAX_SEM_VALUE)
+	uMTsem *pSem = &SemList[Sid];
+
+#if uMT_USE_SEM_FASTPATH==1
+	// Nobody waiting: release it without disabling INTS
+	if (uMT_SemTryRelease(&pSem->SemValue) == TRUE)
+	{
+		uMT_TRACE(TR_SM_RELEASE, Sid, pSem->SemValue & uMT_SEM_COUNT_MASK);
+
+		return(E_SUCCESS);
+	}
+#endif
+
+	if ((pSem->SemValue & uMT_SEM_COUNT_MASK) == uMT_SEM_COUNT_MASK)
 	{
 		return(E_OVERFLOW_SEM);
 	}
 
 	CpuStatusReg_t	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
 
-	// Do finally the sem release
-	uMTsem *pSem = &SemList[Sid];
+	uMT_TRACE(TR_SM_RELEASE, Sid, pSem->SemValue & uMT_SEM_COUNT_MASK);
 
 	// Any task waiting?
 	if (pSem->SemQueue.Head != NULL)
@@ -235,7 +351,18 @@ Errno_t	uMT::doSm_Release(SemId_t Sid, Bool_t AllowPreemption)
 		/* Now remove it from sem queue */
 		uTask	*pTask = pSem->SemQueue.GetFirst();
 
-		pTask->pSemq = NULL;		// This task OWNS the semaphore and it is NOT any longer in the semaphore queue...
+		pTask->pSemq = NULL;		// This task OWNS the semaphore (handoff) and it is NOT any longer in the semaphore queue...
+
+		if (pSem->Handoff == FALSE)
+		{
+			// Not handed off: the first task claiming it wins (it can be the running task)
+			pSem->SemValue++;
+		}
+
+#if uMT_USE_SEM_FASTPATH==1
+		if (pSem->SemQueue.Head == NULL)
+			pSem->SemValue &= ~uMT_SEM_WAITERS;		// Last waiter: back to the fast path
+#endif
 
 		/* Make this task READY... */
 		ReadyTask(pTask);
@@ -245,14 +372,91 @@ Errno_t	uMT::doSm_Release(SemId_t Sid, Bool_t AllowPreemption)
 	}
 	else
 	{
-		// Release Sem
-		pSem->SemValue++;
+		// Release Sem (a stale uMT_SEM_WAITERS left by a timeout is cleared)
+		pSem->SemValue = (pSem->SemValue & uMT_SEM_COUNT_MASK) + 1;
 	}
 
 	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
 
 	if (AllowPreemption)
 		Check4NeedReschedule();		// Call Suspend() if NeedResched==TRUE
+	else
+		Check4IsrReschedule();		// Switch on return from interrupt if NeedResched==TRUE
+
+	return(E_SUCCESS);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::Sm_SetHandoff
+//
+// Handoff=TRUE (default): Sm_Release() gives the semaphore to the first waiter,
+// FIFO fairness but the releasing task blocks if it claims it again soon (convoy).
+// Handoff=FALSE: Sm_Release() only wakes up the first waiter, the running task
+// can claim the semaphore again without a task switch.
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::Sm_SetHandoff(SemId_t Sid, Bool_t Handoff)
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	if (SemId_Check(Sid) == FALSE)
+		return(E_INVALID_SEMID);
+
+	CpuStatusReg_t	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+	// This can only be done if queue is empty
+	if (SemList[Sid].SemQueue.Head != NULL)
+	{
+		isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+		return(E_NOT_ALLOWED);
+	}
+
+	SemList[Sid].Handoff = Handoff;
+
+	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+	return(E_SUCCESS);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::Sm_GetInfo
+//
+// Reset=TRUE clears the statistics after reading them
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::Sm_GetInfo(SemId_t Sid, uMTsemInfo &Info, Bool_t Reset)
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	if (SemId_Check(Sid) == FALSE)
+		return(E_INVALID_SEMID);
+
+	uMTsem *pSem = &SemList[Sid];
+
+	CpuStatusReg_t	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+	Info.Value = pSem->SemValue & uMT_SEM_COUNT_MASK;
+	Info.Handoff = pSem->Handoff;
+	Info.Waiting = 0;
+
+	for (uTask *pTask = pSem->SemQueue.Head; pTask != NULL; pTask = pTask->Next)
+		Info.Waiting++;
+
+#if uMT_USE_SEM_STATISTICS==1
+	Info.Stats = pSem->Stats;
+
+	if (Reset)
+		pSem->Stats.Init();
+#endif
+
+	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
 
 	return(E_SUCCESS);
 }
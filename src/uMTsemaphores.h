@@ -29,12 +29,101 @@
 
 #if uMT_USE_SEMAPHORES==1
 
+// The fast path needs exclusive load/store: not available on AVR and Cortex-M0+
+#if uMT_USE_SEM_FASTPATH==1 && !defined(__ARM_ARCH_7M__) && !defined(__ARM_ARCH_7EM__) && !defined(uMT_POSIX)
+#undef uMT_USE_SEM_FASTPATH
+#define uMT_USE_SEM_FASTPATH		0
+#endif
+
+
 ///////////////////////////////////////////////////////////////////////////////////
 //
 //	uMT SEMAPHORE
 //
+// With uMT_USE_SEM_FASTPATH the top bit of SemValue is set while tasks are (or
+// might be) waiting in SemQueue, so an uncontended Sm_Claim()/Sm_Release() only
+// needs a compare and swap of SemValue, without disabling INTS.
+// The blocking and the waking up of tasks are still done with INTS disabled.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#if uMT_USE_SEM_FASTPATH==1
+#define uMT_SEM_COUNT_MASK		(uMT_MAX_SEM_VALUE >> 1)			// Semaphore count
+#define uMT_SEM_WAITERS			(uMT_MAX_SEM_VALUE & ~uMT_SEM_COUNT_MASK)	// Tasks in SemQueue: take the slow path
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+// Compare and swap of SemValue: LDREX/STREX on Cortex-M3/M4. The STREX fails if an
+// exception occurred in between, so ISRs using the semaphore are safe too.
+// Single core: a compiler barrier is enough, no DMB.
+//
 ////////////////////////////////////////////////////////////////////////////////////
 
+// Take the semaphore if free, FALSE if the slow path is needed
+inline Bool_t uMT_SemTryClaim(SemValue_t *pValue)
+{
+	SemValue_t Value = __atomic_load_n(pValue, __ATOMIC_RELAXED);
+
+	while ((Value & uMT_SEM_COUNT_MASK) != 0)
+	{
+		if (__atomic_compare_exchange_n(pValue, &Value, Value - 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		{
+			__atomic_signal_fence(__ATOMIC_ACQUIRE);
+
+			return(TRUE);
+		}
+	}
+
+	return(FALSE);
+}
+
+// Release the semaphore if nobody is waiting, FALSE if the slow path is needed
+inline Bool_t uMT_SemTryRelease(SemValue_t *pValue)
+{
+	__atomic_signal_fence(__ATOMIC_RELEASE);
+
+	SemValue_t Value = __atomic_load_n(pValue, __ATOMIC_RELAXED);
+
+	while ((Value & uMT_SEM_WAITERS) == 0 && Value != uMT_SEM_COUNT_MASK)
+	{
+		if (__atomic_compare_exchange_n(pValue, &Value, Value + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			return(TRUE);
+	}
+
+	return(FALSE);
+}
+
+#else
+#define uMT_SEM_COUNT_MASK		uMT_MAX_SEM_VALUE
+#define uMT_SEM_WAITERS			0
+#endif
+
+
+#if uMT_USE_SEM_STATISTICS==1
+////////////////////////////////////////////////////
+// Contention statistics, to spot lock convoys
+////////////////////////////////////////////////////
+class uMTsemStats
+{
+public:
+	uint32_t		Claims;			// Successful Sm_Claim()
+	uint32_t		Contentions;	// Sm_Claim() which had to wait
+	uint32_t		Timeouts;		// Sm_Claim() which waited and timed out
+	uint32_t		usWaitTotal;	// Time spent waiting (uSeconds)
+	uint32_t		usWaitMax;		// Longest wait (uSeconds)
+
+	void Init()
+	{
+		Claims = 0;
+		Contentions = 0;
+		Timeouts = 0;
+		usWaitTotal = 0;
+		usWaitMax = 0;
+	};
+};
+#endif
+
 
 class uMTsem
 {
@@ -43,15 +132,42 @@ class uMTsem
 
 	SemValue_t		SemValue;	// Semaphore value
 	uMTtaskQueue	SemQueue;	// Pointer to the task list waiting for this Semaphore
+	Bool_t			Handoff;	// Sm_Release() gives the semaphore to the first waiter
+
+#if uMT_USE_SEM_STATISTICS==1
+	uMTsemStats		Stats;
+#endif
 
 	void Init()
 	{
 		SemValue = 0;			// Set it LOCKED
 		SemQueue.Init();
+		Handoff = TRUE;
+
+#if uMT_USE_SEM_STATISTICS==1
+		Stats.Init();
+#endif
 	};
 };
 
 
+////////////////////////////////////////////////////
+// Returned in Sm_GetInfo()
+////////////////////////////////////////////////////
+
+class uMTsemInfo
+{
+public:
+	SemValue_t		Value;			// Semaphore value
+	Bool_t			Handoff;		// Handoff mode (Sm_SetHandoff())
+	uint8_t			Waiting;		// Tasks waiting now
+
+#if uMT_USE_SEM_STATISTICS==1
+	uMTsemStats		Stats;
+#endif
+};
+
+
 #endif
 
 #endif
@@ -0,0 +1,100 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: uMTsnapshot.h
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef uMT_SNAPSHOT_H
+#define uMT_SNAPSHOT_H
+
+///////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT STATISTICS SNAPSHOT
+//
+// Kn_GetSnapshot() copies the kernel and task counters in a single short critical
+// region: formatting and printing are done afterwards, with preemption enabled.
+// Tasks are copied in TaskList order starting from Snap.NextIdx, so a small array
+// can be filled again and again until Snap.NextIdx reaches Tasks_Num.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+class uMTtaskSnapshot
+{
+public:
+	TaskId_t		Tid;			// Task ID
+	Status_t		TaskStatus;		// Task's status
+	TaskPrio_t		Priority;		// Task priority
+#if uMT_USE_MUTEX==1
+	TaskPrio_t		BasePriority;	// Priority set by Tk_SetPriority()
+#endif
+	StackSize_t		StackSize;		// Stack's size in bytes
+	StackSize_t		FreeStack;		// Free stack now for the Running task, at the last task switch otherwise (bytes)
+#if uMT_USE_STACK_CHECK==1
+	StackSize_t		StackHighWater;	// Highest stack usage found so far (bytes)
+#endif
+
+#if	uMT_USE_EVENTS==1
+	Event_t			EV_received;	// Bit mask of received events
+	Event_t			EV_requested;	// Bit mask of requested events
+#endif
+
+#if	uMT_USE_TASK_STATISTICS>=1
+	RunValue_t		Run;			// How many run
+#endif
+
+#if	uMT_USE_TASK_STATISTICS>=2
+	uMTextendedTime	CpuRunningTime;	// Elapsed time in RUNNING mode (CPU ticks)
+	CpuTicks_t		CpuLastRun;		// CPU ticks of the last run
+#endif
+};
+
+
+class uMTsnapshot
+{
+public:
+	uMTextendedTime	msTickCounter;	// Ticks counter in milliSeconds
+	uint32_t		TickInterrupts;	// Number of System Tick interrupts
+#if uMT_USE_TICKLESS==1
+	uint32_t		TicksSkipped;	// System Ticks not signalled while sleeping in IDLE
+#endif
+
+#if	uMT_USE_TASK_STATISTICS>=2
+	uMTextendedTime	CpuTotalTime;	// Tasks + Kernel + ISR Time in CPU ticks
+	uMTextendedTime	CpuKernelTime;	// Kernel Running Time in CPU ticks
+	uMTextendedTime	CpuIsrTime;		// System Tick ISR Time in CPU ticks
+#endif
+
+	uint8_t			ActiveTaskNo;	// Number of Active tasks, excluding IDLE
+	Bool_t			NeedResched;
+	Bool_t			NoPreempt;
+
+	uint8_t			TaskNum;		// uMTtaskSnapshot entries filled by the last call
+	uint8_t			NextIdx;		// TaskList index to continue from (IN/OUT)
+
+	void Init() { NextIdx = 0; };
+};
+
+
+#endif
+
+
+/////////////////////////////////////// EOF
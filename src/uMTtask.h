@@ -66,7 +66,11 @@ typedef uMTobject_id	TaskId_t;		// TASK ID
 //
 // To allow a run-time verification of the used stack area, uMT fills the stack 
 // with uMT_STACK_GUARD_MARK value [in SetupStackGuard()]
-// In Tk_GetTaskInfo(), the stack area is scanned to find which part has been modified
+// In Tk_GetTaskInfo(), the stack area is scanned to find which part has been modified.
+// With uMT_USE_STACK_CHECK the SP is sampled at every task switch and the scan
+// starts from the last high-water mark instead of the stack base.
+// With uMT_USE_MPU_STACK_GUARD (ARDUINO DUE) the lowest uMT_STACK_GUARD_SKIP bytes
+// hold the MPU guard region of the Running task and are never filled or scanned.
 ////////////////////////////////////////////////////////////////////////////////////////
 
 #define uMT_STACK_GUARD_MARK	0xADDE	// 2 bytes
@@ -98,6 +102,10 @@ enum Status_t
 //	S_DORMANT,		// Task is dormant
 
 class uMTsem;		// Forward declaration
+class uMTmutex;		// Forward declaration
+class uMTtaskQueue;	// Forward declaration
+class uMTeventGroup;	// Forward declaration
+class uMTrwLock;		// Forward declaration
 
 class uTask
 {
@@ -107,14 +115,18 @@ class uTask
 	friend class uMT;
 	friend class uTimer;
 	friend	class uMTtaskQueue;
+	friend	class uMTreadyQueue;
 
 	friend void KLL_TaskLoop();			// Test0_KernelLowLevel.cpp
 	friend void KLL_MainLoop();			// Test0_KernelLowLevel.cpp
 
 	friend unsigned uMTdoTicksWork();	// uMTarduinoCommon.cpp
+	friend unsigned uMTcheckTicks();	// uMTarduinoCommon.cpp
 
 	friend void uMT_SystemTicks();		// uMT_AVR_SysTick.cpp
+	friend void uMT_IsrSwitch();		// uMT_AVR_SysTick.cpp, uMT_POSIX_SysTick.cpp
 	friend void pendSVHook();			// uMT_SAM_SysTick.cpp
+	friend StackPtr_t uMT_SwitchContext(StackPtr_t SP);	// uMT_SAM_SysTick.cpp
 
 private:
 
@@ -127,10 +139,13 @@ private:
 	StackPtr_t	SavedSP;		// Saved STACK pointer
 	StackPtr_t	StackBaseAddr;	// Pointer to the STACK memory area (down in Arduino UNO)
 	StackSize_t	StackSize;		// Stack's size
+#if uMT_USE_STACK_CHECK==1
+	StackSize_t	StackHighWater;	// Highest stack usage found so far (bytes)
+#endif
 	Status_t	TaskStatus;		// Task's status
 
 	uTask	*Next;				// Next in the queue
-//	uTask	*Prev;				// Prev in the queue
+	uTask	*Prev;				// Prev in the queue (O(1) removal)
 
 	TaskId_t	myTid;			// My TID, helper
 
@@ -145,8 +160,8 @@ private:
 #endif
 
 #if	uMT_USE_TASK_STATISTICS>=2
-	uMTextendedTime	usRunningTime;	// Total Running Time in uSeconds
-	Timer_t			usLastRun;		// uSeconds of the last run
+	uMTextendedTime	CpuRunningTime;	// Total Running Time in CPU ticks (ISR time excluded)
+	CpuTicks_t		CpuLastRun;		// CPU ticks of the last run
 #endif
 
 	Param_t			Parameter;	// Here can be stored specifc task's parameter for Tk_Start()
@@ -164,6 +179,29 @@ private:
 	uMTsem	*pSemq;		
 #endif
 
+#if uMT_USE_MUTEX==1
+	TaskPrio_t	BasePriority;	// Priority set by Tk_SetPriority(), Priority can be raised by inheritance
+	uMTmutex	*pMxq;			// Mutex this task is waiting for, NULL if none
+	uMTmutex	*MxOwned;		// List of the Mutexes owned by this task
+#endif
+
+#if uMT_USE_EVENTGROUPS==1
+	uMTeventGroup	*pEgWait;		// Event Group this task is waiting on, NULL if none
+	Event_t			EgRequested;	// Flags waited for
+	Event_t			EgReceived;		// Flags which satisfied the wait
+	uMToptions_t	EgCondition;	// uMT_ANY/uMT_ALL, uMT_CLEAR
+#endif
+
+#if uMT_USE_RWLOCKS==1
+	uMTrwLock	*pRwWait;		// RW lock this task is waiting for, NULL if none
+	Bool_t		RwWrite;		// Waiting for the write lock (otherwise a read lock)
+#endif
+
+#if uMT_USE_MSGQUEUES==1
+	uMTtaskQueue	*pMqWaitq;	// Message Queue's Send/Recv queue this task is waiting in, NULL if none
+	void			*pMqMsg;	// Message to send or buffer to receive while waiting
+#endif
+
 #if uMT_USE_RESTARTTASK==1
 	FuncAddress_t	StartAddress;	// Task's starting address, used by restart()
 	FuncAddress_t	BadExit;		// BadExit address, used by restart()
@@ -197,7 +235,11 @@ public:
 #endif
 
 #if	uMT_USE_TASK_STATISTICS>=2
-	uMTextendedTime	usRunningTime;	// Elapsed time in RUNNING mode
+	uMTextendedTime	usRunningTime;	// Elapsed time in RUNNING mode (uSeconds)
+	uMTextendedTime	CpuRunningTime;	// Elapsed time in RUNNING mode (CPU ticks, uMT_CPU_TICKS_PER_US per uSecond)
+	uint8_t			CpuPercent;		// Share of the CPU time accounted so far (0-100)
+	uMTextendedTime	usKernelTime;	// Kernel time spent in Reschedule() (uSeconds, all tasks)
+	uMTextendedTime	usIsrTime;		// Time spent in the System Tick ISR (uSeconds, all tasks)
 #endif
 
 	StackSize_t		StackSize;		// Stack's size in bytes
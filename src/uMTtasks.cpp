@@ -54,10 +54,31 @@ void	uTask::CleanUp()
 #endif
 
 #if	uMT_USE_TASK_STATISTICS>=2
-	usRunningTime.Clear();
-	usLastRun = 0;
+	CpuRunningTime.Clear();
+	CpuLastRun = 0;
 #endif
 
+#if uMT_USE_SEMAPHORES==1
+	pSemq = NULL;			// Not in any SEM queue
+#endif
+
+#if uMT_USE_MUTEX==1
+	pMxq = NULL;			// Not in any MUTEX queue
+	MxOwned = NULL;			// No Mutex owned
+#endif
+
+#if uMT_USE_EVENTGROUPS==1
+	pEgWait = NULL;			// Not waiting on any EVENT GROUP
+#endif
+
+#if uMT_USE_RWLOCKS==1
+	pRwWait = NULL;			// Not waiting on any RW LOCK
+#endif
+
+#if uMT_USE_MSGQUEUES==1
+	pMqWaitq = NULL;		// Not in any MESSAGE QUEUE
+	pMqMsg = NULL;
+#endif
 }
 
 
@@ -82,6 +103,7 @@ void	uTask::Init(unsigned int myIndex)
 #endif
 
 	Next = (uTask *)NULL;
+	Prev = (uTask *)NULL;
 
 	myTid.Init(myIndex);
 
@@ -175,6 +197,9 @@ Errno_t	uMT::Tk_CreateTask(FuncAddress_t StartAddress, TaskId_t &Tid, FuncAddres
 
 	pTask->TaskStatus = S_CREATED;
 	pTask->Priority = PRIO_NORMAL;
+#if uMT_USE_MUTEX==1
+	pTask->BasePriority = PRIO_NORMAL;
+#endif
 
 	pTask->SavedSP = NewTask(pTask->StackBaseAddr, pTask->StackSize, StartAddress, _BadExit);
 
@@ -255,10 +280,15 @@ Errno_t	uMT::Tk_DeleteTask(TaskId_t Tid)
 	else
 	{
 		doDeleteTask(pTask);
+
+		/* A task waiting for a released Mutex may preempt us */
+		Check4Preemption();
 	}
 
 	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
 
+	Check4NeedReschedule();		// Call Suspend() if NeedResched==TRUE
+
 	return(E_SUCCESS);
 
 }
@@ -347,7 +377,7 @@ void uMT::Reborn()
 		;
 	// It never returns!!!
 
-#elif defined(ARDUINO_ARCH_AVR)
+#elif defined(ARDUINO_ARCH_AVR) || defined(uMT_POSIX)
 
 	NoPreempt = TRUE;		// Prevent further rescheduling.... until next 
 
@@ -529,40 +559,23 @@ Errno_t	uMT::Tk_SetPriority(TaskId_t Tid, TaskPrio_t npriority, TaskPrio_t &ppri
 	if (npriority == 0)	/* Return current priority */
 		return(E_SUCCESS);
 
+	if (npriority > PRIO_MAXPRIO_MASK)
+		return(E_INVALID_PRIORITY);
+
 	CpuStatusReg_t CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
 
-	if (pTask == Running) 	/* Running task */
-	{
-		Running->Priority = npriority;
-	} 
-	else	/* Any other task */
-	{
-		pTask->Priority = npriority;
+#if uMT_USE_MUTEX==1
+	pTask->BasePriority = npriority;
 
-		/* Task blocked in some queue */
+	// Owning Mutexes, it cannot go below the priority of the waiting tasks
+	Tk_ChangePriority(pTask, MxInheritedPrio(pTask));
 
-		
-#if uMT_USE_SEMAPHORES==1
-		if (pTask->TaskStatus == S_SBLOCKED)		// Semaphore queue
-		{
-			/* In a priorized queue: remove and insert again */
-			pTask->pSemq->SemQueue.Remove(pTask);
-			pTask->pSemq->SemQueue.Insert(pTask);	
-		}
-		else 
+	// Waiting for a Mutex: the owner may inherit the new priority
+	if ((pTask->TaskStatus == S_SBLOCKED || pTask->TaskStatus == S_TBLOCKED) && pTask->pMxq != NULL)
+		MxUpdatePrio(pTask->pMxq->Owner);
+#else
+	Tk_ChangePriority(pTask, npriority);
 #endif
-		{
-			/* Task in the ready list */
-			if (pTask->TaskStatus == S_READY)
-			{
-				ReadyQueue.Remove(pTask);
-
-				/* Make this task READY again ... */
-				ReadyTask(pTask);
-			}
-		}
-
-	}
 
 	/* ... and check for preemption */
 	Check4Preemption();
@@ -610,29 +623,128 @@ Errno_t	uMT::Tk_GetPriority(TaskPrio_t &ppriority)
 	return(E_SUCCESS);
 }
 
+#if uMT_USE_STACK_CHECK==1
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::StackCheck
+//
+// Called at every task switch, the SP of the outgoing task just saved. No scan:
+// the used stack at the switch raises the high-water mark and the lowest guard
+// mark must still be there, otherwise the stack has overflowed.
+//
+// Entered with INTS disabled
+//
+////////////////////////////////////////////////////////////////////////////////////
+void	uMT::StackCheck(uTask *pTask)
+{
+	if (pTask->SavedSP < pTask->StackBaseAddr + uMT_STACK_GUARD_SKIP ||
+		*(StackGuard_t *)(pTask->StackBaseAddr + uMT_STACK_GUARD_SKIP) != uMT_STACK_GUARD_MARK)
+	{
+		isr_Kn_FatalError(F("uMT: Stack overflow!"));
+	}
+
+	StackSize_t Used = (StackSize_t)(pTask->StackBaseAddr + pTask->StackSize - pTask->SavedSP);
+
+	if (Used > pTask->StackHighWater)
+		pTask->StackHighWater = Used;
+}
+#endif
+
+
 ////////////////////////////////////////////////////////////////////////////////////
 //
 //	uMT::MaxUsedStack
 //
+// With uMT_USE_STACK_CHECK only the area below the last high-water mark is scanned,
+// down to uMT_STACK_SCAN_GAP bytes still holding the guard mark: a deeper hole (e.g.,
+// a large local array never written) is not seen, the stack overflow check is not
+// affected.
+//
 ////////////////////////////////////////////////////////////////////////////////////
 StackSize_t	uMT::MaxUsedStack(uTask *pTask)
 {
 	if (pTask->TaskStatus == S_UNUSED)
 		return(0);
 
+	StackGuard_t *StackPtr = (StackGuard_t *)pTask->StackBaseAddr;
+
+#if uMT_USE_STACK_CHECK==1
+	// The stack is surely used down to the current SP
+	StackPtr_t SP = (pTask == Running ? Kn_GetSP() : pTask->SavedSP);
+	StackSize_t Used = (StackSize_t)(pTask->StackBaseAddr + pTask->StackSize - SP);
+
+	if (Used < pTask->StackHighWater)
+		Used = pTask->StackHighWater;
+
+	int idx = (pTask->StackSize - Used) / sizeof(StackGuard_t);
+	int lowest = idx;
+	int gap = 0;
+
+	while (--idx >= (int)(uMT_STACK_GUARD_SKIP / sizeof(StackGuard_t)) && gap < (int)(uMT_STACK_SCAN_GAP / sizeof(StackGuard_t)))
+	{
+		if (StackPtr[idx] != uMT_STACK_GUARD_MARK)
+		{
+			lowest = idx;		// Used
+			gap = 0;
+		}
+		else
+		{
+			gap++;
+		}
+	}
+
+	Used = pTask->StackSize - (lowest * sizeof(StackGuard_t));
+
+	CpuStatusReg_t	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+	if (Used > pTask->StackHighWater)
+		pTask->StackHighWater = Used;
+	else
+		Used = pTask->StackHighWater;
+
+	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+	return(Used);
+#else
 	int limit = pTask->StackSize / sizeof(StackGuard_t);
 	int idx;
 
-	StackGuard_t *StackPtr = (StackGuard_t *)pTask->StackBaseAddr;
-
-	for (idx = 0; idx < limit; idx++)
+	for (idx = uMT_STACK_GUARD_SKIP / sizeof(StackGuard_t); idx < limit; idx++)
 	{
 		if (StackPtr[idx] != uMT_STACK_GUARD_MARK)
 			break;
 	}
 
 	return(pTask->StackSize - (idx * sizeof(StackGuard_t)));
+#endif
+}
+
+#if	uMT_USE_TASK_STATISTICS>=2
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	CpuPercent
+//
+// Part <= Total: both are scaled down until Part * 100 fits in 32 bits
+//
+////////////////////////////////////////////////////////////////////////////////////
+static uint8_t CpuPercent(uMTextendedTime Part, uMTextendedTime Total)
+{
+	while (Total.High != 0 || Total.Low > 0x01000000)
+	{
+		Part.Low = (Part.Low >> 1) | ((Timer_t)(Part.High & 1) << 31);
+		Part.High >>= 1;
+
+		Total.Low = (Total.Low >> 1) | ((Timer_t)(Total.High & 1) << 31);
+		Total.High >>= 1;
+	}
+
+	if (Total.Low == 0)
+		return(0);
+
+	return((uint8_t)((Part.Low * 100) / Total.Low));
 }
+#endif
+
 
 ////////////////////////////////////////////////////////////////////////////////////
 //
@@ -652,7 +764,20 @@ Errno_t	uMT::doGetTaskInfo(uTask *pTask, uMTtaskInfo &Info)
 #endif
 
 #if	uMT_USE_TASK_STATISTICS>=2
-	Info.usRunningTime = pTask->usRunningTime;
+	CpuStatusReg_t	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+	uMTextendedTime	CpuTotal = CpuTotalTime;
+	uMTextendedTime	CpuKernel = CpuKernelTime;
+	uMTextendedTime	CpuIsr = CpuIsrTime;
+
+	Info.CpuRunningTime = pTask->CpuRunningTime;
+
+	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+	Info.usRunningTime = uMT_CpuTicks2us(Info.CpuRunningTime);
+	Info.CpuPercent = CpuPercent(Info.CpuRunningTime, CpuTotal);
+	Info.usKernelTime = uMT_CpuTicks2us(CpuKernel);
+	Info.usIsrTime = uMT_CpuTicks2us(CpuIsr);
 #endif
 
 	if (pTask == Running)
@@ -687,4 +812,86 @@ Errno_t	uMT::Tk_GetTaskInfo(TaskId_t Tid, uMTtaskInfo &Info)
 	return(doGetTaskInfo(pTask, Info));
 }
 
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::Kn_GetSnapshot
+//
+// Up to MaxTasks used tasks are copied, starting from Snap.NextIdx (see uMTsnapshot.h).
+// Nothing is computed inside the critical region: no stack scan, no conversion.
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::Kn_GetSnapshot(uMTsnapshot &Snap, uMTtaskSnapshot *pTasks, unsigned int MaxTasks)
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	unsigned int idx = Snap.NextIdx;
+	unsigned int Num = 0;
+
+	CpuStatusReg_t	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+	Snap.msTickCounter = msTickCounter;
+	Snap.TickInterrupts = TickInterrupts;
+#if uMT_USE_TICKLESS==1
+	Snap.TicksSkipped = TicksSkipped;
+#endif
+
+#if	uMT_USE_TASK_STATISTICS>=2
+	Snap.CpuTotalTime = CpuTotalTime;
+	Snap.CpuKernelTime = CpuKernelTime;
+	Snap.CpuIsrTime = CpuIsrTime;
+#endif
+
+	Snap.ActiveTaskNo = ActiveTaskNo;
+	Snap.NeedResched = NeedResched;
+	Snap.NoPreempt = NoPreempt;
+
+	for (; idx < kernelCfg.Tasks_Num && Num < MaxTasks; idx++)
+	{
+		uTask *pTask = &TaskList[idx];
+
+		if (pTask->TaskStatus == S_UNUSED)
+			continue;
+
+		uMTtaskSnapshot *pSnap = &pTasks[Num++];
+
+		pSnap->Tid = pTask->myTid;
+		pSnap->TaskStatus = pTask->TaskStatus;
+		pSnap->Priority = pTask->Priority;
+#if uMT_USE_MUTEX==1
+		pSnap->BasePriority = pTask->BasePriority;
+#endif
+		pSnap->StackSize = pTask->StackSize;
+		if (pTask == Running)
+			pSnap->FreeStack = (StackSize_t)(Kn_GetSP() - Running->StackBaseAddr);
+		else
+			pSnap->FreeStack = (StackSize_t)(pTask->SavedSP - pTask->StackBaseAddr);
+#if uMT_USE_STACK_CHECK==1
+		pSnap->StackHighWater = pTask->StackHighWater;
+#endif
+
+#if	uMT_USE_EVENTS==1
+		pSnap->EV_received = pTask->EV_received;
+		pSnap->EV_requested = pTask->EV_requested;
+#endif
+
+#if	uMT_USE_TASK_STATISTICS>=1
+		pSnap->Run = pTask->Run;
+#endif
+
+#if	uMT_USE_TASK_STATISTICS>=2
+		pSnap->CpuRunningTime = pTask->CpuRunningTime;
+		pSnap->CpuLastRun = pTask->CpuLastRun;
+#endif
+	}
+
+	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+	Snap.TaskNum = (uint8_t)Num;
+	Snap.NextIdx = (uint8_t)idx;
+
+	return(E_SUCCESS);
+}
+
 ///////////////////// EOF
\ No newline at end of file
@@ -49,6 +49,9 @@ void	uMT::ReadyTask(uTask *pTask)
 	DgbStringPrint("uMT: ReadyTask(): TID => ");
 	DgbValuePrintLN(pTask->myTid);
 
+	if (pTask->TaskStatus != S_READY)
+		uMT_TRACE(TR_READY, pTask->myTid.GetID(), pTask->TaskStatus);
+
 	if (pTask == IdleTaskPtr)		// IDLE task SHALL NOT BE in any queue...
 	{
 		pTask->TaskStatus = S_READY;		/* Now ready to run */
@@ -82,8 +85,8 @@ void	uMT::Check4Preemption()
 {
 	CHECK_INTS("Check4Preemption");		// Verify if INTS are disabled...
 
-	if (ReadyQueue.Head != NULL &&
-		ReadyQueue.Head->Priority > Running->Priority &&
+	if (ReadyQueue.IsEmpty() == FALSE &&
+		ReadyQueue.HighestPrio() > Running->Priority &&
 		!(NoPreempt))
 	{
 		/* If running task has lower priority than this
@@ -128,11 +131,66 @@ void  uMT::Tk_RemoveFromAnyQueue(uTask *pTask)
 #endif
 
 #if uMT_USE_SEMAPHORES==1
-	if (pTask->TaskStatus == S_SBLOCKED)
+	if ((pTask->TaskStatus == S_SBLOCKED || pTask->TaskStatus == S_TBLOCKED) && pTask->pSemq != NULL)
 	{
-		// Remove from the Sem queue
+		// Remove from the Sem queue (S_TBLOCKED: waiting with timeout)
 		pTask->pSemq->SemQueue.Remove(pTask);
-		pTask->pSemq = NULL;
+	}
+
+	pTask->pSemq = NULL;
+#endif
+
+#if uMT_USE_MUTEX==1
+	if (pTask->pMxq != NULL)
+	{
+		uTask *pOwner = pTask->pMxq->Owner;
+
+		// Remove from the Mutex queue (S_TBLOCKED: waiting with timeout)
+		if (pTask->TaskStatus == S_SBLOCKED || pTask->TaskStatus == S_TBLOCKED)
+			pTask->pMxq->MxQueue.Remove(pTask);
+
+		pTask->pMxq = NULL;
+
+		// The owner may not need the inherited priority any longer
+		MxUpdatePrio(pOwner);
+	}
+#endif
+
+#if uMT_USE_MSGQUEUES==1
+	if ((pTask->TaskStatus == S_SBLOCKED || pTask->TaskStatus == S_TBLOCKED) && pTask->pMqWaitq != NULL)
+	{
+		// Remove from the Message Queue's Send/Recv queue (S_TBLOCKED: waiting with timeout)
+		pTask->pMqWaitq->Remove(pTask);
+	}
+
+	pTask->pMqWaitq = NULL;
+#endif
+
+#if uMT_USE_EVENTGROUPS==1
+	if ((pTask->TaskStatus == S_SBLOCKED || pTask->TaskStatus == S_TBLOCKED) && pTask->pEgWait != NULL)
+	{
+		// Remove from the Event Group's wait queue (S_TBLOCKED: waiting with timeout)
+		pTask->pEgWait->WaitQueue.Remove(pTask);
+	}
+
+	pTask->pEgWait = NULL;
+#endif
+
+#if uMT_USE_RWLOCKS==1
+	uMTrwLock *pRw = pTask->pRwWait;
+
+	if (pRw != NULL)
+	{
+		// Remove from the RW lock's Read/Write queue (S_TBLOCKED: waiting with timeout)
+		if (pTask->TaskStatus == S_SBLOCKED || pTask->TaskStatus == S_TBLOCKED)
+		{
+			if (pTask->RwWrite)
+				pRw->WriteQueue.Remove(pTask);
+			else
+				pRw->ReadQueue.Remove(pTask);
+		}
+
+		pTask->pRwWait = NULL;
 	}
 #endif
 
@@ -141,6 +199,127 @@ void  uMT::Tk_RemoveFromAnyQueue(uTask *pTask)
 		// Remove from the ready queue
 		ReadyQueue.Remove(pTask);
 	}
+
+#if uMT_USE_MUTEX==1
+	// Hand off the owned Mutexes and drop any inherited priority
+	MxReleaseAll(pTask);
+
+	pTask->Priority = pTask->BasePriority;
+#endif
+
+#if uMT_USE_RWLOCKS==1
+	// Hand off the write locks owned...
+	RwReleaseAll(pTask);
+
+	// ... and let the readers in if it was the last waiting writer
+	if (pRw != NULL)
+		RwWakeup(pRw);
+#endif
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::Tk_ChangePriority
+//
+// Set the task priority and keep the queue it is in (READY, SEM, MUTEX, MESSAGE QUEUE, EVENT GROUP or RW LOCK) ordered.
+//
+// Enter with INTS disabled
+////////////////////////////////////////////////////////////////////////////////////
+void	uMT::Tk_ChangePriority(uTask *pTask, TaskPrio_t npriority)
+{
+	CHECK_INTS("Tk_ChangePriority");		// Verify if INTS are disabled...
+
+	if (pTask->TaskStatus == S_RUNNING || pTask == IdleTaskPtr)		// Not in any queue
+	{
+		pTask->Priority = npriority;
+
+		return;
+	}
+
+	/* Task blocked in some queue */
+#if uMT_USE_SEMAPHORES==1
+	if ((pTask->TaskStatus == S_SBLOCKED || pTask->TaskStatus == S_TBLOCKED) && pTask->pSemq != NULL)		// Semaphore queue
+	{
+		pTask->Priority = npriority;
+
+		/* In a priorized queue: remove and insert again */
+		pTask->pSemq->SemQueue.Remove(pTask);
+		pTask->pSemq->SemQueue.Insert(pTask);	
+
+		return;
+	}
+#endif
+
+#if uMT_USE_MUTEX==1
+	if ((pTask->TaskStatus == S_SBLOCKED || pTask->TaskStatus == S_TBLOCKED) && pTask->pMxq != NULL)		// Mutex queue
+	{
+		pTask->Priority = npriority;
+
+		/* In a priorized queue: remove and insert again */
+		pTask->pMxq->MxQueue.Remove(pTask);
+		pTask->pMxq->MxQueue.Insert(pTask);	
+
+		return;
+	}
+#endif
+
+#if uMT_USE_MSGQUEUES==1
+	if ((pTask->TaskStatus == S_SBLOCKED || pTask->TaskStatus == S_TBLOCKED) && pTask->pMqWaitq != NULL)		// Message Queue
+	{
+		pTask->Priority = npriority;
+
+		/* In a priorized queue: remove and insert again */
+		pTask->pMqWaitq->Remove(pTask);
+		pTask->pMqWaitq->Insert(pTask);	
+
+		return;
+	}
+#endif
+
+#if uMT_USE_EVENTGROUPS==1
+	if ((pTask->TaskStatus == S_SBLOCKED || pTask->TaskStatus == S_TBLOCKED) && pTask->pEgWait != NULL)		// Event Group
+	{
+		pTask->Priority = npriority;
+
+		/* In a priorized queue: remove and insert again */
+		pTask->pEgWait->WaitQueue.Remove(pTask);
+		pTask->pEgWait->WaitQueue.Insert(pTask);	
+
+		return;
+	}
+#endif
+
+#if uMT_USE_RWLOCKS==1
+	if ((pTask->TaskStatus == S_SBLOCKED || pTask->TaskStatus == S_TBLOCKED) && pTask->pRwWait != NULL)		// RW lock
+	{
+		uMTtaskQueue *pQueue = (pTask->RwWrite ? &pTask->pRwWait->WriteQueue : &pTask->pRwWait->ReadQueue);
+
+		pTask->Priority = npriority;
+
+		/* In a priorized queue: remove and insert again */
+		pQueue->Remove(pTask);
+		pQueue->Insert(pTask);
+
+		return;
+	}
+#endif
+
+	/* Task in the ready list */
+	if (pTask->TaskStatus == S_READY)
+	{
+		/* The READY queue is indexed by priority: remove with the old one */
+		ReadyQueue.Remove(pTask);
+
+		pTask->Priority = npriority;
+
+		/* Make this task READY again ... */
+		ReadyQueue.Insert(pTask);
+	}
+	else
+	{
+		pTask->Priority = npriority;
+	}
 }
 
 
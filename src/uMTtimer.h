@@ -46,6 +46,31 @@
 #define uMT_TM_SEND_EVENT	0x10			// Timers, send EVENT
 #define uMT_TM_REPEAT		0x20			// Timers, repeat alarm
 #define uMT_TM_EXPIRED		0x40			// Timer EXPIRED
+#define uMT_TM_QUEUED		0x80			// Timer in the TIMER queue
+
+#define uMT_TM_NO_DEADLINE	((Timer_t)0xFFFFFFFF)	// TimerQ_NextDeadline(): no timers
+
+#if uMT_USE_TIMER_WHEEL==1
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	Hierarchical timing wheel
+//
+// uMT_WHEEL_LEVELS levels of uMT_WHEEL_SIZE slots each, indexed with the bits of the
+// absolute alarm tick: level 0 has one slot per tick, level 1 one slot every 32 ticks, etc.
+// With 4 levels of 5 bits the wheel covers 2^20 ticks (more than 17 minutes at 1ms),
+// longer timeouts are parked in the OVERFLOW list.
+// Expired timers are moved to the EXPIRED list, waiting for Reschedule().
+//
+////////////////////////////////////////////////////////////////////////////////////
+#define uMT_WHEEL_BITS		5									// Bits per level (uint32_t bitmap)
+#define uMT_WHEEL_SIZE		(1 << uMT_WHEEL_BITS)				// Slots per level
+#define uMT_WHEEL_MASK		(uMT_WHEEL_SIZE - 1)
+#define uMT_WHEEL_LEVELS	4									// Number of levels
+
+#define uMT_WHEEL_OVERFLOW	(uMT_WHEEL_LEVELS * uMT_WHEEL_SIZE)	// Slot: beyond the last level
+#define uMT_WHEEL_EXPIRED	(uMT_WHEEL_OVERFLOW + 1)			// Slot: expired timers
+#define uMT_WHEEL_SLOTS		(uMT_WHEEL_EXPIRED + 1)				// Total slots
+#endif
 
 typedef uint8_t			TimerFlag_t;		// Timers flags type, 8 bits
 
@@ -57,6 +82,7 @@ class uTimer
 	// FRIENDS!!!
 	/////////////////////////////////
 	friend unsigned uMTdoTicksWork();	// uMTarduinoSysTick.cpp
+	friend unsigned uMTcheckTicks();	// uMTarduinoCommon.cpp
 	friend void uMT_SystemTicks();		// uMTarduinoSysTick.cpp
 	friend unsigned int sysTickHook();	// uMTarduinoSysTick.cpp
 
@@ -69,12 +95,15 @@ class uTimer
 	TimerId_t	myTimerId;		// My Timer ID, helper
 
 	uTimer		*Next;			// Next in the queue
-//	uTimer		*Prev;			// Prev in the queue
+	uTimer		*Prev;			// Prev in the queue (wheel: the head's Prev is the tail)
+#if uMT_USE_TIMER_WHEEL==1
+	uint8_t		Slot;			// Wheel slot, when uMT_TM_QUEUED
+#endif
 
 	uMTextendedTime	NextAlarm;		// Absolute value in ticks for next alarm
 	Timer_t		Timeout;		// Alarm Value (for repetitive alarms)
 
-	TimerFlag_t	Flags;			// uMT_TM_SEND_EVENT, uMT_TM_REPEAT, uMT_TM_IAM_AGENT, uMT_TM_IAM_TASK
+	TimerFlag_t	Flags;			// uMT_TM_SEND_EVENT, uMT_TM_REPEAT, uMT_TM_IAM_AGENT, uMT_TM_IAM_TASK, uMT_TM_QUEUED
 	Event_t		EventToSend;	// Event to send if uMT_TM_SEND_EVENT is set
 	uTask		*pTask;			// Task related to this timer
 
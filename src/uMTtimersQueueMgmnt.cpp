@@ -32,6 +32,222 @@
 #define uMT_DEBUG 0
 #include "uMTdebug.h"
 
+#if uMT_USE_TIMER_WHEEL==1
+
+// Rotate a level bitmap so that bit 0 is slot "Index"
+static inline uint32_t WheelRotate(uint32_t Map, uint8_t Index)
+{
+	return(Index == 0 ? Map : (Map >> Index) | (Map << (uMT_WHEEL_SIZE - Index)));
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::TimerW_Link
+//
+// (Entered with INTs disabled)
+// Append a timer to a wheel slot (FIFO). The head's Prev points to the tail.
+//
+////////////////////////////////////////////////////////////////////////////////////
+void uMT::TimerW_Link(uTimer *pTimer, uint8_t Slot)
+{
+	uTimer *pHead = WheelHead[Slot];
+
+	pTimer->Slot = Slot;
+	pTimer->Next = NULL;
+
+	if (pHead == NULL)
+	{
+		pTimer->Prev = pTimer;
+		WheelHead[Slot] = pTimer;
+
+		if (Slot < uMT_WHEEL_OVERFLOW)
+			WheelMap[Slot >> uMT_WHEEL_BITS] |= ((uint32_t)1 << (Slot & uMT_WHEEL_MASK));
+	}
+	else
+	{
+		pTimer->Prev = pHead->Prev;
+		pHead->Prev->Next = pTimer;
+		pHead->Prev = pTimer;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::TimerW_Unlink
+//
+// (Entered with INTs disabled)
+// Remove a timer from its wheel slot in O(1)
+//
+////////////////////////////////////////////////////////////////////////////////////
+void uMT::TimerW_Unlink(uTimer *pTimer)
+{
+	uint8_t Slot = pTimer->Slot;
+	uTimer *pHead = WheelHead[Slot];
+
+	if (pTimer == pHead)
+	{
+		WheelHead[Slot] = pTimer->Next;
+
+		if (pTimer->Next != NULL)
+			pTimer->Next->Prev = pTimer->Prev;		// Tail
+		else if (Slot < uMT_WHEEL_OVERFLOW)
+			WheelMap[Slot >> uMT_WHEEL_BITS] &= ~((uint32_t)1 << (Slot & uMT_WHEEL_MASK));
+	}
+	else
+	{
+		pTimer->Prev->Next = pTimer->Next;
+
+		if (pTimer->Next != NULL)
+			pTimer->Next->Prev = pTimer->Prev;
+		else
+			pHead->Prev = pTimer->Prev;			// New tail
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::TimerW_Place
+//
+// (Entered with INTs disabled)
+// Select the wheel slot using the distance from the wheel time
+//
+////////////////////////////////////////////////////////////////////////////////////
+void uMT::TimerW_Place(uTimer *pTimer)
+{
+	if (pTimer->NextAlarm < WheelTime)
+	{
+		// Already expired
+		TimerW_Link(pTimer, uMT_WHEEL_EXPIRED);
+		return;
+	}
+
+	uMTextendedTime Delta = pTimer->NextAlarm - WheelTime;
+
+	if (Delta.High == 0)
+	{
+		for (uint8_t Level = 0; Level < uMT_WHEEL_LEVELS; Level++)
+		{
+			if (Delta.Low < ((Timer_t)1 << ((Level + 1) * uMT_WHEEL_BITS)))
+			{
+				uint8_t Index = (pTimer->NextAlarm.Low >> (Level * uMT_WHEEL_BITS)) & uMT_WHEEL_MASK;
+
+				TimerW_Link(pTimer, Level * uMT_WHEEL_SIZE + Index);
+				return;
+			}
+		}
+	}
+
+	// Too far...
+	TimerW_Link(pTimer, uMT_WHEEL_OVERFLOW);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::TimerW_Cascade
+//
+// (Entered with INTs disabled)
+// Move all the timers of a slot to the lower levels
+//
+////////////////////////////////////////////////////////////////////////////////////
+void uMT::TimerW_Cascade(uint8_t Slot)
+{
+	uTimer *pTimer;
+
+	while ((pTimer = WheelHead[Slot]) != NULL)
+	{
+		CHECK_TIMER_MAGIC(pTimer, "TimerW_Cascade");
+
+		TimerW_Unlink(pTimer);
+		TimerW_Place(pTimer);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::TimerW_Advance
+//
+// (Entered with INTs disabled)
+// Process all the ticks up to msTickCounter, moving expired timers to the EXPIRED list.
+// Empty rounds of level 0 are skipped, so the cost is amortized O(1) per tick.
+//
+////////////////////////////////////////////////////////////////////////////////////
+void uMT::TimerW_Advance()
+{
+	while (WheelTime <= msTickCounter)
+	{
+		if ((WheelMap[0] | WheelMap[1] | WheelMap[2] | WheelMap[3]) == 0 && WheelHead[uMT_WHEEL_OVERFLOW] == NULL)
+		{
+			// Empty wheel: nothing to process
+			WheelTime = msTickCounter + (Timer_t)1;
+			return;
+		}
+
+		uint8_t Index = WheelTime.Low & uMT_WHEEL_MASK;
+
+		if (Index == 0)
+		{
+			// Level 0 wrapped: cascade the higher levels
+			for (uint8_t Level = 1; Level <= uMT_WHEEL_LEVELS; Level++)
+			{
+				if (Level == uMT_WHEEL_LEVELS)
+				{
+					TimerW_Cascade(uMT_WHEEL_OVERFLOW);
+					break;
+				}
+
+				uint8_t LevelIndex = (WheelTime.Low >> (Level * uMT_WHEEL_BITS)) & uMT_WHEEL_MASK;
+
+				TimerW_Cascade(Level * uMT_WHEEL_SIZE + LevelIndex);
+
+				if (LevelIndex != 0)
+					break;
+			}
+		}
+		else if ((WheelMap[0] >> Index) == 0)
+		{
+			// Nothing else in this round: jump to the next cascade
+			uMTextendedTime NextRound = WheelTime + (Timer_t)(uMT_WHEEL_SIZE - Index);
+
+			if (NextRound > msTickCounter)
+			{
+				WheelTime = msTickCounter + (Timer_t)1;
+				return;
+			}
+
+			WheelTime = NextRound;
+			continue;
+		}
+
+		// All the timers of this slot are expired
+		uTimer *pTimer;
+
+		while ((pTimer = WheelHead[Index]) != NULL)
+		{
+			TimerW_Unlink(pTimer);
+			TimerW_Link(pTimer, uMT_WHEEL_EXPIRED);
+		}
+
+		WheelTime++;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::TimerW_SetDeadline
+//
+// (Entered with INTs disabled)
+// Recompute the tick at which the System Tick must call Reschedule(): the wheel
+// is advanced only there, never in the tick ISR.
+//
+////////////////////////////////////////////////////////////////////////////////////
+void uMT::TimerW_SetDeadline()
+{
+	WheelDeadline = msTickCounter + TimerQ_NextDeadline();
+}
+
+#endif
+
+
 ////////////////////////////////////////////////////////////////////////////////////
 //
 //	uMT::TimerQ_Insert
@@ -45,12 +261,26 @@ void  uMT::TimerQ_Insert(uTimer *pTimer)	/* Timer agent */
 
 	TotTimerQueued++;
 
+	pTimer->Flags |= uMT_TM_QUEUED;
+
+#if uMT_USE_TIMER_WHEEL==1
+
+	TimerW_Advance();		// Keep the wheel time close to msTickCounter
+
+	TimerW_Place(pTimer);
+
+	// Any wheel work before the alarm is found by the Reschedule() at the alarm
+	if (pTimer->NextAlarm < WheelDeadline)
+		WheelDeadline = pTimer->NextAlarm;
+
+#else
 	// Insert in the ordered queue
 
 	if (TimerQueue == NULL)
 	{
 		TimerQueue = pTimer;
 		pTimer->Next = NULL;
+		pTimer->Prev = NULL;
 
 		return;
 	}
@@ -64,18 +294,15 @@ void  uMT::TimerQ_Insert(uTimer *pTimer)	/* Timer agent */
 
 		if (pScan->NextAlarm > pTimer->NextAlarm)
 		{
-			// Inserted as first element?
-			if (pScan == TimerQueue)
-			{
-				pTimer->Next = TimerQueue;
+			// Insert before pScan (pLast is NULL if first element)
+			pTimer->Next = pScan;
+			pTimer->Prev = pLast;
+			pScan->Prev = pTimer;
+
+			if (pLast == NULL)
 				TimerQueue = pTimer;
-			}
 			else
-			{
-				// Insert here
-				pTimer->Next = pScan;
 				pLast->Next = pTimer;
-			}
 
 			return;
 		}
@@ -88,7 +315,39 @@ void  uMT::TimerQ_Insert(uTimer *pTimer)	/* Timer agent */
 	// Add at the end
 	pLast->Next = pTimer;
 	pTimer->Next = NULL;
+	pTimer->Prev = pLast;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::TimerQ_Remove
+//
+// (Entered with INTs disabled)
+// Remove a queued timer in O(1)
+//
+////////////////////////////////////////////////////////////////////////////////////
+void uMT::TimerQ_Remove(uTimer *pTimer)
+{
+	CHECK_INTS("TimerQ_Remove");		// Verify if INTS are disabled...
 
+	CHECK_TIMER_MAGIC(pTimer, "TimerQ_Remove");
+
+	TotTimerQueued--;
+
+	pTimer->Flags &= ~uMT_TM_QUEUED;
+
+#if uMT_USE_TIMER_WHEEL==1
+	TimerW_Unlink(pTimer);
+#else
+	if (pTimer->Prev == NULL)
+		TimerQueue = pTimer->Next;
+	else
+		pTimer->Prev->Next = pTimer->Next;
+
+	if (pTimer->Next != NULL)
+		pTimer->Next->Prev = pTimer->Prev;
+#endif
 }
 
 ////////////////////////////////////////////////////////////////////////////////////
@@ -96,29 +355,168 @@ void  uMT::TimerQ_Insert(uTimer *pTimer)	/* Timer agent */
 //	uMT::TimerQ_Pop
 //
 // (Entered with INTs disabled)
+// Remove the first EXPIRED timer, NULL if none
 //
 ////////////////////////////////////////////////////////////////////////////////////
 uTimer * uMT::TimerQ_Pop()
 {
 	CHECK_INTS("TimerQ_Pop");		// Verify if INTS are disabled...
 
+	if (TimerQ_AlarmDue() == FALSE)
+		return(NULL);
+
+#if uMT_USE_TIMER_WHEEL==1
+	uTimer *pTimer = WheelHead[uMT_WHEEL_EXPIRED];
+#else
+	uTimer *pTimer = TimerQueue;
+#endif
+
+	TimerQ_Remove(pTimer);
+
+	return(pTimer);
+
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::TimerQ_AlarmDue
+//
+// (Entered with INTs disabled)
+// TRUE if at least one timer is expired
+//
+////////////////////////////////////////////////////////////////////////////////////
+Bool_t uMT::TimerQ_AlarmDue()
+{
+#if uMT_USE_TIMER_WHEEL==1
+	TimerW_Advance();
+
+	return(WheelHead[uMT_WHEEL_EXPIRED] != NULL ? TRUE : FALSE);
+#else
 	if (TimerQueue == NULL)
 	{
 		if (TotTimerQueued != 0)
 		{
-			isr_Kn_FatalError(F("TimerQ_Pop: TimerQueue != TotalQueued"));
+			isr_Kn_FatalError(F("TimerQ_AlarmDue: TimerQueue != TotalQueued"));
 		}
 
-		return(NULL);
+		return(FALSE);
 	}
 
-	TotTimerQueued--;
+	return(TimerQueue->NextAlarm <= msTickCounter ? TRUE : FALSE);
+#endif
+}
 
-	uTimer *pTimer = TimerQueue;
-	TimerQueue = TimerQueue->Next;
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::TimerQ_isrAlarmDue
+//
+// (Called by the System Tick)
+// TRUE if Reschedule() must process the timers. It only reads the timers, so
+// tasks can walk them with preemption disabled.
+//
+////////////////////////////////////////////////////////////////////////////////////
+Bool_t uMT::TimerQ_isrAlarmDue()
+{
+#if uMT_USE_TIMER_WHEEL==1
+	return(WheelDeadline <= msTickCounter ? TRUE : FALSE);
+#else
+	return(TimerQ_AlarmDue());
+#endif
+}
 
-	return(pTimer);
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::TimerQ_NextDeadline
+//
+// (Entered with INTs disabled)
+// Ticks from msTickCounter to the next timer work: an alarm or, for the wheel,
+// a cascade of a not empty slot. uMT_TM_NO_DEADLINE if there are no timers.
+//
+////////////////////////////////////////////////////////////////////////////////////
+Timer_t uMT::TimerQ_NextDeadline()
+{
+#if uMT_USE_TIMER_WHEEL==1
+	if (TimerQ_AlarmDue() == TRUE)
+		return(0);
 
+	if ((WheelMap[0] | WheelMap[1] | WheelMap[2] | WheelMap[3]) == 0 && WheelHead[uMT_WHEEL_OVERFLOW] == NULL)
+		return(uMT_TM_NO_DEADLINE);
+
+	Timer_t Now = (WheelTime - msTickCounter).Low;	// WheelTime is the next tick to process
+
+	if ((WheelTime.Low & uMT_WHEEL_MASK) == 0)
+		return(Now);		// Cascade pending
+
+	Timer_t Ticks = uMT_TM_NO_DEADLINE;
+
+	for (uint8_t Level = 0; Level < uMT_WHEEL_LEVELS; Level++)
+	{
+		if (WheelMap[Level] == 0)
+			continue;
+
+		uint8_t Shift = Level * uMT_WHEEL_BITS;
+		uint8_t Index = (WheelTime.Low >> Shift) & uMT_WHEEL_MASK;
+		Timer_t Slots;
+
+		// Level 0 current slot is not processed yet, higher levels current slot is one round ahead
+		if (Level == 0)
+			Slots = __builtin_ctz(WheelRotate(WheelMap[Level], Index));
+		else
+			Slots = __builtin_ctz(WheelRotate(WheelMap[Level], (Index + 1) & uMT_WHEEL_MASK)) + 1;
+
+		Timer_t SlotTicks = (((WheelTime.Low >> Shift) + Slots) << Shift) - WheelTime.Low;
+
+		if (SlotTicks < Ticks)
+			Ticks = SlotTicks;
+	}
+
+	if (WheelHead[uMT_WHEEL_OVERFLOW] != NULL)
+	{
+		// Next wrap of the last level
+		Timer_t WrapTicks = (0 - WheelTime.Low) & (((Timer_t)1 << (uMT_WHEEL_LEVELS * uMT_WHEEL_BITS)) - 1);
+
+		if (WrapTicks < Ticks)
+			Ticks = WrapTicks;
+	}
+
+	return(Now + Ticks);
+#else
+	if (TimerQueue == NULL)
+		return(uMT_TM_NO_DEADLINE);
+
+	if (TimerQueue->NextAlarm <= msTickCounter)
+		return(0);
+
+	uMTextendedTime Delta = TimerQueue->NextAlarm - msTickCounter;
+
+	return(Delta.High != 0 ? uMT_TM_NO_DEADLINE : Delta.Low);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::TimerQ_Next
+//
+// (Entered with INTs or preemption disabled)
+// Walk all the queued timers (NULL to get the first one)
+//
+////////////////////////////////////////////////////////////////////////////////////
+uTimer * uMT::TimerQ_Next(uTimer *pTimer)
+{
+#if uMT_USE_TIMER_WHEEL==1
+	if (pTimer != NULL && pTimer->Next != NULL)
+		return(pTimer->Next);
+
+	for (unsigned int Slot = (pTimer == NULL ? 0 : pTimer->Slot + 1); Slot < uMT_WHEEL_SLOTS; Slot++)
+	{
+		if (WheelHead[Slot] != NULL)
+			return(WheelHead[Slot]);
+	}
+
+	return(NULL);
+#else
+	return(pTimer == NULL ? TimerQueue : pTimer->Next);
+#endif
 }
 
 ////////////////////////////////////////////////////////////////////////////////////
@@ -173,36 +571,17 @@ Errno_t uMT::TimerQ_CancelTimer(uTimer *pTimer)
 {
 	CHECK_INTS("TimerQ_CancelTmId");		// Verify if INTS are disabled...
 
-	uTimer *pScan = TimerQueue;
-	uTimer *pLast = NULL;
-
-	while (pScan != NULL)
-	{
-		// At least one TIMER exists...
-		CHECK_TIMER_MAGIC(pScan, "TimerQ_CancelTmId");
-
-		if (pScan == pTimer)
-		{
-			// FOUND!
+	CHECK_TIMER_MAGIC(pTimer, "TimerQ_CancelTmId");
 
-			if (pScan == TimerQueue)		// Is it the first element?
-			{
-				TimerQueue = TimerQueue->Next;
-			}
-			else
-			{
-				// pLast always exists...
-				pLast->Next = pScan->Next;
-			}
+	if ((pTimer->Flags & uMT_TM_QUEUED) == 0)
+		return(E_NOT_OWNED_TIMER);
 
-			if (pScan->Flags & uMT_TM_IAM_AGENT)	// Free timer
-				TimerQ_PushFree(pScan);
+	TimerQ_Remove(pTimer);
 
-			return(E_SUCCESS);
-		}
-	}
+	if (pTimer->Flags & uMT_TM_IAM_AGENT)	// Free timer
+		TimerQ_PushFree(pTimer);
 
-	return(E_NOT_OWNED_TIMER);
+	return(E_SUCCESS);
 }
 
 
@@ -219,36 +598,18 @@ void uMT::TimerQ_CancelAll(uTask *pTask)
 {
 	CHECK_INTS("TimerQ_CancelAll");		// Verify if INTS are disabled...
 
-	uTimer *pScan = TimerQueue;
-	uTimer *pLast = NULL;
+	// TASK TIMER
+	if (pTask->TaskTimer.Flags & uMT_TM_QUEUED)
+		TimerQ_CancelTimer(&pTask->TaskTimer);
 
-	while (pScan != NULL)
+	// AGENT TIMERS
+	for (unsigned int idx = 0; idx < kernelCfg.AgentTimers_Num; idx++)
 	{
-		// At least one TIMER exists...
-		CHECK_TIMER_MAGIC(pScan, "TimerQ_CancelAll");
-
-		if (pScan->pTask == pTask)
-		{
-			// FOUND!
+		uTimer *pTimer = &TimerAgentList[idx];
 
-			if (pScan == TimerQueue)		// Is it the first element?
-			{
-				TimerQueue = TimerQueue->Next;
-			}
-			else
-			{
-				// pLast always exists...
-				pLast->Next = pScan->Next;
-			}
-
-			if (pScan->Flags & uMT_TM_IAM_AGENT)	// Free timer
-				TimerQ_PushFree(pScan);
-		}
+		if (pTimer->pTask == pTask && (pTimer->Flags & uMT_TM_QUEUED))
+			TimerQ_CancelTimer(pTimer);
 	}
-
-
-
-
 }
 ////////////////////////////////////////////////////////////////////////////////////
 //
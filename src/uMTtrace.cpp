@@ -0,0 +1,117 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: uMTtrace.cpp
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+
+
+#include "uMT.h"
+
+#define uMT_DEBUG 0
+#include "uMTdebug.h"
+
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+//				CLASS uMT
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+
+
+
+#if uMT_USE_TRACE==1
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::TraceRecord
+//
+// It can be called from ISR
+//
+////////////////////////////////////////////////////////////////////////////////////
+void	uMT::TraceRecord(uint8_t Type, uint8_t Obj, uint16_t Arg)
+{
+	if (TraceOn == FALSE)
+		return;
+
+	CpuStatusReg_t	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+	uMTtraceRec *pRec = &TraceBuf[TraceIn];
+
+	TraceIn = (TraceIn + 1) & (uMT_TRACE_SIZE - 1);
+
+	if (TraceCount < uMT_TRACE_SIZE)
+		TraceCount++;
+
+	pRec->Time = uMT_TRACE_TIME();
+	pRec->Type = Type;
+	pRec->Obj = Obj;
+	pRec->Arg = Arg;
+
+	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::Kn_TraceStart
+//
+// The first record is a TR_SWITCH to the Running task, so the decoder knows who is running
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::Kn_TraceStart()
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	CpuStatusReg_t	CpuFlags = isr_Kn_IntLock();	/* Enter critical region */
+
+	TraceIn = 0;
+	TraceCount = 0;
+	TraceOn = TRUE;
+
+	uMT_TRACE(TR_SWITCH, Running->myTid.GetID(), Running->myTid.GetID());
+
+	isr_Kn_IntUnlock(CpuFlags);	/* End of critical region */
+
+	return(E_SUCCESS);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT::Kn_TraceStop
+//
+////////////////////////////////////////////////////////////////////////////////////
+Errno_t	uMT::Kn_TraceStop()
+{
+	if (Inited == FALSE)
+		return(E_NOT_INITED);
+
+	TraceOn = FALSE;
+
+	return(E_SUCCESS);
+}
+
+#endif
+
+
+
+/////////////////////// EOF
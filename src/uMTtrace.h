@@ -0,0 +1,102 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//	FILE: uMTtrace.h
+//	Program originally written by Antonio Pastore, Torino, ITALY.
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (C) <2017>  Antonio Pastore, Torino, ITALY.
+//
+//   This program is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//	 the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef uMT_TRACE_H
+#define uMT_TRACE_H
+
+#if uMT_USE_TRACE==1
+
+///////////////////////////////////////////////////////////////////////////////////
+//
+//	uMT KERNEL TRACE
+//
+// Fixed size binary records written in a RAM ring buffer (the oldest ones are
+// overwritten) with INTS disabled and no I/O. Kn_TraceDump() prints them to Serial
+// as hex text, extras/trace/uMTtrace2json.py turns the dump in a Chrome trace /
+// Perfetto JSON file.
+//
+// Obj and Arg depend on the record Type:
+//
+//	TR_SWITCH		new Tid			old Tid
+//	TR_READY		Tid				previous TaskStatus
+//	TR_BLOCK		Tid				TaskStatus
+//	TR_EV_SEND		Tid				Event (low 16 bits)
+//	TR_SM_CLAIM		Sid				SemValue
+//	TR_SM_RELEASE	Sid				SemValue
+//	TR_TIMER		Tid				Timer Flags
+//	TR_ISR_ENTER	Irq				0
+//	TR_ISR_EXIT		Irq				0
+//	TR_USER			Code			Arg
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#if (uMT_TRACE_SIZE & (uMT_TRACE_SIZE - 1)) != 0
+#error "uMT_TRACE_SIZE must be a power of 2"
+#endif
+
+enum uMTtraceType_t {
+	TR_SWITCH = 1,
+	TR_READY,
+	TR_BLOCK,
+	TR_EV_SEND,
+	TR_SM_CLAIM,
+	TR_SM_RELEASE,
+	TR_TIMER,
+	TR_ISR_ENTER,
+	TR_ISR_EXIT,
+	TR_USER
+};
+
+class uMTtraceRec
+{
+public:
+	uint32_t	Time;			// uMT_TRACE_TIME()
+	uint8_t		Type;			// uMTtraceType_t
+	uint8_t		Obj;			// Object index (Tid, Sid, Irq, ...)
+	uint16_t	Arg;			// Type dependent argument
+};
+
+#if	uMT_USE_TASK_STATISTICS>=2
+#define uMT_TRACE_TIME()			uMT_CpuTicks()
+#define uMT_TRACE_TICKS_PER_US		uMT_CPU_TICKS_PER_US
+#else
+#define uMT_TRACE_TIME()			((uint32_t)micros())
+#define uMT_TRACE_TICKS_PER_US		1
+#endif
+
+// To be used inside uMT class members
+#define uMT_TRACE(Type, Obj, Arg)	TraceRecord((Type), (uint8_t)(Obj), (uint16_t)(Arg))
+
+#else
+
+// Still a single statement: "if (...) uMT_TRACE(...);" must not leave an empty body
+#define uMT_TRACE(Type, Obj, Arg)	do {} while (0)
+
+#endif
+
+#endif
+
+
+/////////////////////////////////////// EOF